@@ -144,6 +144,114 @@ extern "C" {
 #define HAP_CHAR_UUID_IS_CONFIGURED                             "D6"
 #define HAP_CHAR_UUID_PRODUCT_DATA                              "220"
 
+/* Numeric type IDs of the above, for use with hap_char_get_type_id() */
+#define HAP_CHAR_TYPE_ID_ADMINISTRATOR_ONLY_ACCESS              0x1
+#define HAP_CHAR_TYPE_ID_BRIGHTNESS                             0x8
+#define HAP_CHAR_TYPE_ID_COOLING_THRESHOLD_TEMPERATURE          0xD
+#define HAP_CHAR_TYPE_ID_CURRENT_DOOR_STATE                     0xE
+#define HAP_CHAR_TYPE_ID_CURRENT_HEATING_COOLING_STATE          0xF
+#define HAP_CHAR_TYPE_ID_CURRENT_RELATIVE_HUMIDITY              0x10
+#define HAP_CHAR_TYPE_ID_CURRENT_TEMPERATURE                    0x11
+#define HAP_CHAR_TYPE_ID_FIRMWARE_REVISION                      0x52
+#define HAP_CHAR_TYPE_ID_HARDWARE_REVISION                      0x53
+#define HAP_CHAR_TYPE_ID_HEATING_THRESHOLD_TEMPERATURE          0x12
+#define HAP_CHAR_TYPE_ID_HUE                                    0x13
+#define HAP_CHAR_TYPE_ID_IDENTIFY                               0x14
+#define HAP_CHAR_TYPE_ID_LOCK_CONTROL_POINT                     0x19
+#define HAP_CHAR_TYPE_ID_LOCK_CURRENT_STATE                     0x1D
+#define HAP_CHAR_TYPE_ID_LOCK_LAST_KNOWN_ACTION                 0x1C
+#define HAP_CHAR_TYPE_ID_LOCK_MANAGEMENT_AUTO_SECURITY_TIMEOUT  0x1A
+#define HAP_CHAR_TYPE_ID_LOCK_TARGET_STATE                      0x1E
+#define HAP_CHAR_TYPE_ID_LOGS                                   0x1F
+#define HAP_CHAR_TYPE_ID_MANUFACTURER                           0x20
+#define HAP_CHAR_TYPE_ID_MODEL                                  0x21
+#define HAP_CHAR_TYPE_ID_MOTION_DETECTED                        0x22
+#define HAP_CHAR_TYPE_ID_NAME                                   0x23
+#define HAP_CHAR_TYPE_ID_OBSTRUCTION_DETECTED                   0x24
+#define HAP_CHAR_TYPE_ID_ON                                     0x25
+#define HAP_CHAR_TYPE_ID_OUTLET_IN_USE                          0x26
+#define HAP_CHAR_TYPE_ID_ROTATION_DIRECTION                     0x28
+#define HAP_CHAR_TYPE_ID_ROTATION_SPEED                         0x29
+#define HAP_CHAR_TYPE_ID_SATURATION                             0x2F
+#define HAP_CHAR_TYPE_ID_SERIAL_NUMBER                          0x30
+#define HAP_CHAR_TYPE_ID_TARGET_DOOR_STATE                      0x32
+#define HAP_CHAR_TYPE_ID_TARGET_HEATING_COOLING_STATE           0x33
+#define HAP_CHAR_TYPE_ID_TARGET_RELATIVE_HUMIDITY               0x34
+#define HAP_CHAR_TYPE_ID_TARGET_TEMPERATURE                     0x35
+#define HAP_CHAR_TYPE_ID_TEMPERATURE_DISPLAY_UNITS              0x36
+#define HAP_CHAR_TYPE_ID_VERSION                                0x37
+#define HAP_CHAR_TYPE_ID_AIR_PARTICULATE_DENSITY                0x64
+#define HAP_CHAR_TYPE_ID_AIR_PARTICULATE_SIZE                   0x65
+#define HAP_CHAR_TYPE_ID_SECURITY_SYSTEM_CURRENT_STATE          0x66
+#define HAP_CHAR_TYPE_ID_SECURITY_SYSTEM_TARGET_STATE           0x67
+#define HAP_CHAR_TYPE_ID_BATTERY_LEVEL                          0x68
+#define HAP_CHAR_TYPE_ID_CARBON_MONOXIDE_DETECTED               0x69
+#define HAP_CHAR_TYPE_ID_CONTACT_SENSOR_STATE                   0x6A
+#define HAP_CHAR_TYPE_ID_CURRENT_AMBIENT_LIGHT_LEVEL            0x6B
+#define HAP_CHAR_TYPE_ID_CURRENT_HORIZONTAL_TILT_ANGLE          0x6C
+#define HAP_CHAR_TYPE_ID_CURRENT_POSITION                       0x6D
+#define HAP_CHAR_TYPE_ID_CURRENT_VERTICAL_TILT_ANGLE            0x6E
+#define HAP_CHAR_TYPE_ID_HOLD_POSITION                          0x6F
+#define HAP_CHAR_TYPE_ID_LEAK_DETECTED                          0x70
+#define HAP_CHAR_TYPE_ID_OCCUPANCY_DETECTED                     0x71
+#define HAP_CHAR_TYPE_ID_POSITION_STATE                         0x72
+#define HAP_CHAR_TYPE_ID_PROGRAMMABLE_SWITCH_EVENT              0x73
+#define HAP_CHAR_TYPE_ID_STATUS_ACTIVE                          0x75
+#define HAP_CHAR_TYPE_ID_SMOKE_DETECTED                         0x76
+#define HAP_CHAR_TYPE_ID_STATUS_FAULT                           0x77
+#define HAP_CHAR_TYPE_ID_STATUS_JAMMED                          0x78
+#define HAP_CHAR_TYPE_ID_STATUS_LOW_BATTERY                     0x79
+#define HAP_CHAR_TYPE_ID_STATUS_TAMPERED                        0x7A
+#define HAP_CHAR_TYPE_ID_TARGET_HORIZONTAL_TILT_ANGLE           0x7B
+#define HAP_CHAR_TYPE_ID_TARGET_POSITION                        0x7C
+#define HAP_CHAR_TYPE_ID_TARGET_VERTICAL_TILT_ANGLE             0x7D
+#define HAP_CHAR_TYPE_ID_STATUS_SECURITY_SYSTEM_ALARM_TYPE      0x8E
+#define HAP_CHAR_TYPE_ID_CHARGING_STATE                         0x8F
+#define HAP_CHAR_TYPE_ID_CARBON_MONOXIDE_LEVEL                  0x90
+#define HAP_CHAR_TYPE_ID_CARBON_MONOXIDE_PEAK_LEVEL             0x91
+#define HAP_CHAR_TYPE_ID_CARBON_DIOXIDE_DETECTED                0x92
+#define HAP_CHAR_TYPE_ID_CARBON_DIOXIDE_LEVEL                   0x93
+#define HAP_CHAR_TYPE_ID_CARBON_DIOXIDE_PEAK_LEVEL              0x94
+#define HAP_CHAR_TYPE_ID_AIR_QUALITY                            0x95
+#define HAP_CHAR_TYPE_ID_ACCESSORY_FLAGS                        0xA6
+#define HAP_CHAR_TYPE_ID_LOCK_PHYSICAL_CONTROLS                 0xA7
+#define HAP_CHAR_TYPE_ID_CURRENT_AIR_PURIFIER_STATE             0xA9
+#define HAP_CHAR_TYPE_ID_CURRENT_SLAT_STATE                     0xAA
+#define HAP_CHAR_TYPE_ID_SLAT_TYPE                              0xC0
+#define HAP_CHAR_TYPE_ID_FILTER_LIFE_LEVEL                      0xAB
+#define HAP_CHAR_TYPE_ID_FILTER_CHANGE_INDICATION               0xAC
+#define HAP_CHAR_TYPE_ID_RESET_FILTER_INDICATION                0xAD
+#define HAP_CHAR_TYPE_ID_TARGET_AIR_PURIFIER_STATE              0xA8
+#define HAP_CHAR_TYPE_ID_TARGET_FAN_STATE                       0xBF
+#define HAP_CHAR_TYPE_ID_CURRENT_FAN_STATE                      0xAF
+#define HAP_CHAR_TYPE_ID_ACTIVE                                 0xB0
+#define HAP_CHAR_TYPE_ID_SWING_MODE                             0xB6
+#define HAP_CHAR_TYPE_ID_CURRENT_TILT_ANGLE                     0xC1
+#define HAP_CHAR_TYPE_ID_TARGET_TILT_ANGLE                      0xC2
+#define HAP_CHAR_TYPE_ID_OZONE_DENSITY                          0xC3
+#define HAP_CHAR_TYPE_ID_NITROGEN_DIOXIDE_DENSITY               0xC4
+#define HAP_CHAR_TYPE_ID_SULPHUR_DIOXIDE_DENSITY                0xC5
+#define HAP_CHAR_TYPE_ID_PM_2_5_DENSITY                         0xC6
+#define HAP_CHAR_TYPE_ID_PM_10_DENSITY                          0xC7
+#define HAP_CHAR_TYPE_ID_VOC_DENSITY                            0xC8
+#define HAP_CHAR_TYPE_ID_SERVICE_LABEL_INDEX                    0xCB
+#define HAP_CHAR_TYPE_ID_SERVICE_LABEL_NAMESPACE                0xCD
+#define HAP_CHAR_TYPE_ID_COLOR_TEMPERATURE                      0xCE
+#define HAP_CHAR_TYPE_ID_CURRENT_HEATER_COOLER_STATE            0xB1
+#define HAP_CHAR_TYPE_ID_TARGET_HEATER_COOLER_STATE             0xB2
+#define HAP_CHAR_TYPE_ID_CURRENT_HUMIDIFIER_DEHUMIDIFIER_STATE  0xB3
+#define HAP_CHAR_TYPE_ID_TARGET_HUMIDIFIER_DEHUMIDIFIER_STATE   0xB4
+#define HAP_CHAR_TYPE_ID_WATER_LEVEL                            0xB5
+#define HAP_CHAR_TYPE_ID_RELATIVE_HUMIDITY_DEHUMIDIFIER_THRESHOLD 0xC9
+#define HAP_CHAR_TYPE_ID_RELATIVE_HUMIDITY_HUMIDIFIER_THRESHOLD 0xCA
+#define HAP_CHAR_TYPE_ID_PROGRAM_MODE                           0xD1
+#define HAP_CHAR_TYPE_ID_IN_USE                                 0xD2
+#define HAP_CHAR_TYPE_ID_SET_DURATION                           0xD3
+#define HAP_CHAR_TYPE_ID_REMAINING_DURATION                     0xD4
+#define HAP_CHAR_TYPE_ID_VALVE_TYPE                             0xD5
+#define HAP_CHAR_TYPE_ID_IS_CONFIGURED                          0xD6
+#define HAP_CHAR_TYPE_ID_PRODUCT_DATA                           0x220
+
 /** Create Brightness Characteristic
  *
  * This API creates the Brightness characteristic object with other metadata
@@ -75,6 +75,45 @@ extern "C" {
 #define HAP_SERV_UUID_VALVE                         "D0"
 #define HAP_SERV_UUID_FAUCET                        "D7"
 
+/* Numeric type IDs of the above, for use with hap_serv_get_type_id() */
+#define HAP_SERV_TYPE_ID_ACCESSORY_INFORMATION      0x3E
+#define HAP_SERV_TYPE_ID_PROTOCOL_INFORMATION       0xA2
+#define HAP_SERV_TYPE_ID_FAN                        0x40
+#define HAP_SERV_TYPE_ID_GARAGE_DOOR_OPENER         0x41
+#define HAP_SERV_TYPE_ID_LIGHTBULB                  0x43
+#define HAP_SERV_TYPE_ID_LOCK_MANAGEMENT            0x44
+#define HAP_SERV_TYPE_ID_LOCK_MECHANISM             0x45
+#define HAP_SERV_TYPE_ID_SWITCH                     0x49
+#define HAP_SERV_TYPE_ID_OUTLET                     0x47
+#define HAP_SERV_TYPE_ID_THERMOSTAT                 0x4A
+#define HAP_SERV_TYPE_ID_AIR_QUALITY_SENSOR         0x8D
+#define HAP_SERV_TYPE_ID_SECURITY_SYSTEM            0x7E
+#define HAP_SERV_TYPE_ID_CARBON_MONOXIDE_SENSOR     0x7F
+#define HAP_SERV_TYPE_ID_CONTACT_SENSOR             0x80
+#define HAP_SERV_TYPE_ID_DOOR                       0x81
+#define HAP_SERV_TYPE_ID_HUMIDITY_SENSOR            0x82
+#define HAP_SERV_TYPE_ID_LEAK_SENSOR                0x83
+#define HAP_SERV_TYPE_ID_LIGHT_SENSOR               0x84
+#define HAP_SERV_TYPE_ID_MOTION_SENSOR              0x85
+#define HAP_SERV_TYPE_ID_OCCUPANCY_SENSOR           0x86
+#define HAP_SERV_TYPE_ID_SMOKE_SENSOR               0x87
+#define HAP_SERV_TYPE_ID_STATLESS_PROGRAMMABLE_SWITCH 0x89
+#define HAP_SERV_TYPE_ID_TEMPERATURE_SENSOR         0x8A
+#define HAP_SERV_TYPE_ID_WINDOW                     0x8B
+#define HAP_SERV_TYPE_ID_WINDOW_COVERING            0x8C
+#define HAP_SERV_TYPE_ID_BATTERY_SERVICE            0x96
+#define HAP_SERV_TYPE_ID_CARBON_DIOXIDE_SENSOR      0x97
+#define HAP_SERV_TYPE_ID_FAN_V2                     0xB7
+#define HAP_SERV_TYPE_ID_SLAT                       0xB9
+#define HAP_SERV_TYPE_ID_FILTER_MAINTENANCE         0xBA
+#define HAP_SERV_TYPE_ID_AIR_PURIFIER               0xBB
+#define HAP_SERV_TYPE_ID_HEATER_COOLER              0xBC
+#define HAP_SERV_TYPE_ID_HUMIDIFIER_DEHUMIDIFIER    0xBD
+#define HAP_SERV_TYPE_ID_SERVICE_LABEL              0xCC
+#define HAP_SERV_TYPE_ID_IRRIGATION_SYSTEM          0xCF
+#define HAP_SERV_TYPE_ID_VALVE                      0xD0
+#define HAP_SERV_TYPE_ID_FAUCET                     0xD7
+
 /** Create Accessory Information Service
  *
  * This API will create the Accessory Information Service with the mandatory
@@ -25,91 +25,87 @@
 #include <hap_apple_chars.h>
 
 /* Char: Brightness */
+static const hap_char_desc_t hap_char_brightness_desc = {
+    .type_uuid = HAP_CHAR_UUID_BRIGHTNESS,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 100, 1, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_brightness_create(int brightness)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_BRIGHTNESS,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, brightness);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 100, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.i = brightness};
+    return hap_char_create_from_desc(&hap_char_brightness_desc, val);
 }
 
 /* Char: Cooling Threshold Temperature */
+static const hap_char_desc_t hap_char_cooling_threshold_temperature_desc = {
+    .type_uuid = HAP_CHAR_UUID_COOLING_THRESHOLD_TEMPERATURE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(10.0, 35.0, 0.1, HAP_CHAR_UNIT_CELSIUS),
+};
+
 hap_char_t *hap_char_cooling_threshold_temperature_create(float cooling_threshold_temp)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_COOLING_THRESHOLD_TEMPERATURE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, cooling_threshold_temp);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 10.0, 35.0, 0.1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_CELSIUS);
-
-    return hc;
+    hap_val_t val = {.f = cooling_threshold_temp};
+    return hap_char_create_from_desc(&hap_char_cooling_threshold_temperature_desc, val);
 }
 
 /* Char: Current Door State */
+static const hap_char_desc_t hap_char_current_door_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_DOOR_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 4, 1, NULL),
+};
+
 hap_char_t *hap_char_current_door_state_create(uint8_t curr_door_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_DOOR_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_door_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 4, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_door_state};
+    return hap_char_create_from_desc(&hap_char_current_door_state_desc, val);
 }
 
 /* Char: Current Heating Cooling State */
+static const hap_char_desc_t hap_char_current_heating_cooling_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_HEATING_COOLING_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_current_heating_cooling_state_create(uint8_t curr_heating_cooling_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_HEATING_COOLING_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_heating_cooling_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_heating_cooling_state};
+    return hap_char_create_from_desc(&hap_char_current_heating_cooling_state_desc, val);
 }
 
 /* Char: Current Relative Humidity */
+static const hap_char_desc_t hap_char_current_relative_humidity_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_RELATIVE_HUMIDITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_current_relative_humidity_create(float curr_rel_humidity)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CURRENT_RELATIVE_HUMIDITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_rel_humidity);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.f = curr_rel_humidity};
+    return hap_char_create_from_desc(&hap_char_current_relative_humidity_desc, val);
 }
 
 /* Char: Current Temperature */
+static const hap_char_desc_t hap_char_current_temperature_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_TEMPERATURE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 0.1, HAP_CHAR_UNIT_CELSIUS),
+};
+
 hap_char_t *hap_char_current_temperature_create(float curr_temp)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CURRENT_TEMPERATURE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_temp);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 0.1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_CELSIUS);
-
-    return hc;
+    hap_val_t val = {.f = curr_temp};
+    return hap_char_create_from_desc(&hap_char_current_temperature_desc, val);
 }
 
 /* Char: Firmware Revision */
@@ -135,33 +131,31 @@ hap_char_t *hap_char_hardware_revision_create(char *hw_rev)
 }
 
 /* Char: Heating Threshold Temperature */
+static const hap_char_desc_t hap_char_heating_threshold_temperature_desc = {
+    .type_uuid = HAP_CHAR_UUID_HEATING_THRESHOLD_TEMPERATURE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 25.0, 0.1, HAP_CHAR_UNIT_CELSIUS),
+};
+
 hap_char_t *hap_char_heating_threshold_temperature_create(float heating_threshold_temp)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_HEATING_THRESHOLD_TEMPERATURE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, heating_threshold_temp);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 25.0, 0.1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_CELSIUS);
-
-    return hc;
+    hap_val_t val = {.f = heating_threshold_temp};
+    return hap_char_create_from_desc(&hap_char_heating_threshold_temperature_desc, val);
 }
 
 /* Char: Hue */
+static const hap_char_desc_t hap_char_hue_desc = {
+    .type_uuid = HAP_CHAR_UUID_HUE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 360.0, 1.0, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_hue_create(float hue)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_HUE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, hue);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 360.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.f = hue};
+    return hap_char_create_from_desc(&hap_char_hue_desc, val);
 }
 
 /* Char: Identify */
@@ -175,31 +169,31 @@ hap_char_t *hap_char_identify_create(void)
 }
 
 /* Char: Lock Current State */
+static const hap_char_desc_t hap_char_lock_current_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_LOCK_CURRENT_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3, 1, NULL),
+};
+
 hap_char_t *hap_char_lock_current_state_create(uint8_t lock_curr_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_LOCK_CURRENT_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, lock_curr_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3, 1);
-
-    return hc;
+    hap_val_t val = {.u = lock_curr_state};
+    return hap_char_create_from_desc(&hap_char_lock_current_state_desc, val);
 }
 
 /* Char: Lock Target State */
+static const hap_char_desc_t hap_char_lock_target_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_LOCK_TARGET_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_lock_target_state_create(uint8_t lock_targ_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_LOCK_TARGET_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, lock_targ_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = lock_targ_state};
+    return hap_char_create_from_desc(&hap_char_lock_target_state_desc, val);
 }
 
 /* Char: Manufacturer */
@@ -282,47 +276,45 @@ hap_char_t *hap_char_outlet_in_use_create(bool outlet_in_use)
 }
 
 /* Char: Rotation Direction */
+static const hap_char_desc_t hap_char_rotation_direction_desc = {
+    .type_uuid = HAP_CHAR_UUID_ROTATION_DIRECTION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_rotation_direction_create(int rotation_direction)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_ROTATION_DIRECTION,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, rotation_direction);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.i = rotation_direction};
+    return hap_char_create_from_desc(&hap_char_rotation_direction_desc, val);
 }
 
 /* Char: Rotation Speed */
+static const hap_char_desc_t hap_char_rotation_speed_desc = {
+    .type_uuid = HAP_CHAR_UUID_ROTATION_SPEED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_rotation_speed_create(float rotation_speed)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_ROTATION_SPEED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, rotation_speed);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.f = rotation_speed};
+    return hap_char_create_from_desc(&hap_char_rotation_speed_desc, val);
 }
 
 /* Char: Saturation */
+static const hap_char_desc_t hap_char_saturation_desc = {
+    .type_uuid = HAP_CHAR_UUID_SATURATION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_saturation_create(float saturation)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_SATURATION,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, saturation);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.f = saturation};
+    return hap_char_create_from_desc(&hap_char_saturation_desc, val);
 }
 
 /* Char: Serial Number */
@@ -337,75 +329,73 @@ hap_char_t *hap_char_serial_number_create(char *serial_num)
 }
 
 /* Char: Target Door State */
+static const hap_char_desc_t hap_char_target_door_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_DOOR_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_target_door_state_create(uint8_t targ_door_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_DOOR_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_door_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = targ_door_state};
+    return hap_char_create_from_desc(&hap_char_target_door_state_desc, val);
 }
 
 /* Char: Target Heating Cooling State */
+static const hap_char_desc_t hap_char_target_heating_cooling_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_HEATING_COOLING_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3, 1, NULL),
+};
+
 hap_char_t *hap_char_target_heating_cooling_state_create(uint8_t targ_heating_cooling_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_HEATING_COOLING_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_heating_cooling_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3, 1);
-
-    return hc;
+    hap_val_t val = {.u = targ_heating_cooling_state};
+    return hap_char_create_from_desc(&hap_char_target_heating_cooling_state_desc, val);
 }
 
 /* Char: Target Relative Humidity */
+static const hap_char_desc_t hap_char_target_relative_humidity_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_RELATIVE_HUMIDITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_target_relative_humidity_create(float targ_rel_humidity)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_TARGET_RELATIVE_HUMIDITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_rel_humidity);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.f = targ_rel_humidity};
+    return hap_char_create_from_desc(&hap_char_target_relative_humidity_desc, val);
 }
 
 /* Char: Target Temperature */
+static const hap_char_desc_t hap_char_target_temperature_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_TEMPERATURE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(10.0, 38.0, 0.1, HAP_CHAR_UNIT_CELSIUS),
+};
+
 hap_char_t *hap_char_target_temperature_create(float targ_temp)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_TARGET_TEMPERATURE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_temp);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 10.0, 38.0, 0.1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_CELSIUS);
-
-    return hc;
+    hap_val_t val = {.f = targ_temp};
+    return hap_char_create_from_desc(&hap_char_target_temperature_desc, val);
 }
 
 /* Char: Temperature Display Units */
+static const hap_char_desc_t hap_char_temperature_display_units_desc = {
+    .type_uuid = HAP_CHAR_UUID_TEMPERATURE_DISPLAY_UNITS,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_temperature_display_units_create(uint8_t temp_disp_units)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TEMPERATURE_DISPLAY_UNITS,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, temp_disp_units);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = temp_disp_units};
+    return hap_char_create_from_desc(&hap_char_temperature_display_units_desc, val);
 }
 
 /* Char: Version */
@@ -420,134 +410,129 @@ hap_char_t *hap_char_version_create(char *version)
 }
 
 /* Char: Security System Current State */
+static const hap_char_desc_t hap_char_security_system_current_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_SECURITY_SYSTEM_CURRENT_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 4, 1, NULL),
+};
+
 hap_char_t *hap_char_security_system_current_state_create(uint8_t security_sys_curr_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_SECURITY_SYSTEM_CURRENT_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, security_sys_curr_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 4, 1);
-
-    return hc;
+    hap_val_t val = {.u = security_sys_curr_state};
+    return hap_char_create_from_desc(&hap_char_security_system_current_state_desc, val);
 }
 
 /* Char: Security System Target State */
+static const hap_char_desc_t hap_char_security_system_target_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_SECURITY_SYSTEM_TARGET_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3, 1, NULL),
+};
+
 hap_char_t *hap_char_security_system_target_state_create(uint8_t security_sys_targ_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_SECURITY_SYSTEM_TARGET_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, security_sys_targ_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3, 1);
-
-    return hc;
+    hap_val_t val = {.u = security_sys_targ_state};
+    return hap_char_create_from_desc(&hap_char_security_system_target_state_desc, val);
 }
 
 /* Char: Battery Level */
+static const hap_char_desc_t hap_char_battery_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_BATTERY_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 100, 1, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_battery_level_create(uint8_t battery_level)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_BATTERY_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, battery_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 100, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.u = battery_level};
+    return hap_char_create_from_desc(&hap_char_battery_level_desc, val);
 }
 
 /* Char: Carbon Monoxide Detected */
+static const hap_char_desc_t hap_char_carbon_monoxide_detected_desc = {
+    .type_uuid = HAP_CHAR_UUID_CARBON_MONOXIDE_DETECTED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_carbon_monoxide_detected_create(uint8_t carbon_monoxide_detected)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CARBON_MONOXIDE_DETECTED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, carbon_monoxide_detected);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = carbon_monoxide_detected};
+    return hap_char_create_from_desc(&hap_char_carbon_monoxide_detected_desc, val);
 }
 
 /* Char: Contact Sensor State */
+static const hap_char_desc_t hap_char_contact_sensor_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CONTACT_SENSOR_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_contact_sensor_state_create(uint8_t contact_sensor_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CONTACT_SENSOR_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, contact_sensor_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = contact_sensor_state};
+    return hap_char_create_from_desc(&hap_char_contact_sensor_state_desc, val);
 }
 
 /* Char: Current Ambient Light Level */
+static const hap_char_desc_t hap_char_current_ambient_light_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_AMBIENT_LIGHT_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0001, 100000.0, 0.0, HAP_CHAR_UNIT_LUX),
+};
+
 hap_char_t *hap_char_current_ambient_light_level_create(float curr_ambient_light_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CURRENT_AMBIENT_LIGHT_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_ambient_light_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0001, 100000.0, 0.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_LUX);
-
-    return hc;
+    hap_val_t val = {.f = curr_ambient_light_level};
+    return hap_char_create_from_desc(&hap_char_current_ambient_light_level_desc, val);
 }
 
 /* Char: Current Horizontal Tilt Angle */
+static const hap_char_desc_t hap_char_current_horizontal_tilt_angle_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_HORIZONTAL_TILT_ANGLE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(-90, 90, 1, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_current_horizontal_tilt_angle_create(int curr_horiz_tilt_angle)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_CURRENT_HORIZONTAL_TILT_ANGLE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_horiz_tilt_angle);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, -90, 90, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.i = curr_horiz_tilt_angle};
+    return hap_char_create_from_desc(&hap_char_current_horizontal_tilt_angle_desc, val);
 }
 
 /* Char: Current Position */
+static const hap_char_desc_t hap_char_current_position_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_POSITION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 100, 1, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_current_position_create(uint8_t curr_pos)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_POSITION,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_pos);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 100, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.u = curr_pos};
+    return hap_char_create_from_desc(&hap_char_current_position_desc, val);
 }
 
 /* Char: Current Vertical Tilt Angle */
+static const hap_char_desc_t hap_char_current_vertical_tilt_angle_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_VERTICAL_TILT_ANGLE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(-90, 90, 1, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_current_vertical_tilt_angle_create(int curr_vert_tilt_angle)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_CURRENT_VERTICAL_TILT_ANGLE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_vert_tilt_angle);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, -90, 90, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.i = curr_vert_tilt_angle};
+    return hap_char_create_from_desc(&hap_char_current_vertical_tilt_angle_desc, val);
 }
 
 /* Char: Hold Position */
@@ -563,60 +548,59 @@ hap_char_t *hap_char_hold_position_create(bool hold_pos)
 }
 
 /* Char: Leak Detected */
+static const hap_char_desc_t hap_char_leak_detected_desc = {
+    .type_uuid = HAP_CHAR_UUID_LEAK_DETECTED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_leak_detected_create(uint8_t leak_detected)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_LEAK_DETECTED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, leak_detected);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = leak_detected};
+    return hap_char_create_from_desc(&hap_char_leak_detected_desc, val);
 }
 
 /* Char: Occupancy Detected */
+static const hap_char_desc_t hap_char_occupancy_detected_desc = {
+    .type_uuid = HAP_CHAR_UUID_OCCUPANCY_DETECTED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_occupancy_detected_create(uint8_t occupancy_detected)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_OCCUPANCY_DETECTED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, occupancy_detected);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = occupancy_detected};
+    return hap_char_create_from_desc(&hap_char_occupancy_detected_desc, val);
 }
 
 /* Char: Position State */
+static const hap_char_desc_t hap_char_position_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_POSITION_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_position_state_create(uint8_t pos_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_POSITION_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, pos_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = pos_state};
+    return hap_char_create_from_desc(&hap_char_position_state_desc, val);
 }
 
 /* Char: Programmable Switch Event */
+static const hap_char_desc_t hap_char_programmable_switch_event_desc = {
+    .type_uuid = HAP_CHAR_UUID_PROGRAMMABLE_SWITCH_EVENT,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV | HAP_CHAR_PERM_SPECIAL_READ,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_programmable_switch_event_create(uint8_t programmable_switch_event)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_PROGRAMMABLE_SWITCH_EVENT,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV | HAP_CHAR_PERM_SPECIAL_READ,
-                                           programmable_switch_event);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = programmable_switch_event};
+    return hap_char_create_from_desc(&hap_char_programmable_switch_event_desc, val);
 }
 
 /* Char: Status Active */
@@ -632,217 +616,214 @@ hap_char_t *hap_char_status_active_create(bool status_active)
 }
 
 /* Char: Smoke Detected */
+static const hap_char_desc_t hap_char_smoke_detected_desc = {
+    .type_uuid = HAP_CHAR_UUID_SMOKE_DETECTED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_smoke_detected_create(uint8_t smoke_detected)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_SMOKE_DETECTED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, smoke_detected);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = smoke_detected};
+    return hap_char_create_from_desc(&hap_char_smoke_detected_desc, val);
 }
 
 /* Char: Status Fault */
+static const hap_char_desc_t hap_char_status_fault_desc = {
+    .type_uuid = HAP_CHAR_UUID_STATUS_FAULT,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_status_fault_create(uint8_t status_fault)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_STATUS_FAULT,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, status_fault);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = status_fault};
+    return hap_char_create_from_desc(&hap_char_status_fault_desc, val);
 }
 
 /* Char: Status Low Battery */
+static const hap_char_desc_t hap_char_status_low_battery_desc = {
+    .type_uuid = HAP_CHAR_UUID_STATUS_LOW_BATTERY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_status_low_battery_create(uint8_t status_low_battery)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_STATUS_LOW_BATTERY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, status_low_battery);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = status_low_battery};
+    return hap_char_create_from_desc(&hap_char_status_low_battery_desc, val);
 }
 
 /* Char: Status Tampered */
+static const hap_char_desc_t hap_char_status_tampered_desc = {
+    .type_uuid = HAP_CHAR_UUID_STATUS_TAMPERED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_status_tampered_create(uint8_t status_tampered)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_STATUS_TAMPERED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, status_tampered);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = status_tampered};
+    return hap_char_create_from_desc(&hap_char_status_tampered_desc, val);
 }
 
 /* Char: Target Horizontal Tilt Angle */
+static const hap_char_desc_t hap_char_target_horizontal_tilt_angle_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_HORIZONTAL_TILT_ANGLE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(-90, 90, 1, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_target_horizontal_tilt_angle_create(int targ_horiz_tilt_angle)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_TARGET_HORIZONTAL_TILT_ANGLE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_horiz_tilt_angle);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, -90, 90, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.i = targ_horiz_tilt_angle};
+    return hap_char_create_from_desc(&hap_char_target_horizontal_tilt_angle_desc, val);
 }
 
 /* Char: Target Position */
+static const hap_char_desc_t hap_char_target_position_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_POSITION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 100, 1, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_target_position_create(uint8_t targ_pos)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_POSITION,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_pos);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 100, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.u = targ_pos};
+    return hap_char_create_from_desc(&hap_char_target_position_desc, val);
 }
 
 /* Char: Target Vertical Tilt Angle */
+static const hap_char_desc_t hap_char_target_vertical_tilt_angle_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_VERTICAL_TILT_ANGLE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(-90, 90, 1, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_target_vertical_tilt_angle_create(int targ_vert_tilt_angle)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_TARGET_VERTICAL_TILT_ANGLE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_vert_tilt_angle);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, -90, 90, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.i = targ_vert_tilt_angle};
+    return hap_char_create_from_desc(&hap_char_target_vertical_tilt_angle_desc, val);
 }
 
 /* Char: Security System Alarm Type */
+static const hap_char_desc_t hap_char_security_system_alarm_type_desc = {
+    .type_uuid = HAP_CHAR_UUID_STATUS_SECURITY_SYSTEM_ALARM_TYPE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_security_system_alarm_type_create(uint8_t security_sys_alarm_type)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_STATUS_SECURITY_SYSTEM_ALARM_TYPE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, security_sys_alarm_type);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = security_sys_alarm_type};
+    return hap_char_create_from_desc(&hap_char_security_system_alarm_type_desc, val);
 }
 
 /* Char: Charging State */
+static const hap_char_desc_t hap_char_charging_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CHARGING_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_charging_state_create(uint8_t charging_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CHARGING_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, charging_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = charging_state};
+    return hap_char_create_from_desc(&hap_char_charging_state_desc, val);
 }
 
 /* Char: Carbon Monoxide Level */
+static const hap_char_desc_t hap_char_carbon_monoxide_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_CARBON_MONOXIDE_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_carbon_monoxide_level_create(float carbon_monoxide_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CARBON_MONOXIDE_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, carbon_monoxide_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = carbon_monoxide_level};
+    return hap_char_create_from_desc(&hap_char_carbon_monoxide_level_desc, val);
 }
 
 /* Char: Carbon Monoxide Peak Level */
+static const hap_char_desc_t hap_char_carbon_monoxide_peak_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_CARBON_MONOXIDE_PEAK_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_carbon_monoxide_peak_level_create(float carbon_monoxide_peak_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CARBON_MONOXIDE_PEAK_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, carbon_monoxide_peak_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = carbon_monoxide_peak_level};
+    return hap_char_create_from_desc(&hap_char_carbon_monoxide_peak_level_desc, val);
 }
 
 /* Char: Carbon Dioxide Detected */
+static const hap_char_desc_t hap_char_carbon_dioxide_detected_desc = {
+    .type_uuid = HAP_CHAR_UUID_CARBON_DIOXIDE_DETECTED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_carbon_dioxide_detected_create(uint8_t carbon_dioxide_detected)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CARBON_DIOXIDE_DETECTED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, carbon_dioxide_detected);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = carbon_dioxide_detected};
+    return hap_char_create_from_desc(&hap_char_carbon_dioxide_detected_desc, val);
 }
 
 /* Char: Carbon Dioxide Level */
+static const hap_char_desc_t hap_char_carbon_dioxide_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_CARBON_DIOXIDE_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_carbon_dioxide_level_create(float carbon_dioxide_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CARBON_DIOXIDE_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, carbon_dioxide_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = carbon_dioxide_level};
+    return hap_char_create_from_desc(&hap_char_carbon_dioxide_level_desc, val);
 }
 
 /* Char: Carbon Dioxide Peak Level */
+static const hap_char_desc_t hap_char_carbon_dioxide_peak_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_CARBON_DIOXIDE_PEAK_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_carbon_dioxide_peak_level_create(float carbon_dioxide_peak_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_CARBON_DIOXIDE_PEAK_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, carbon_dioxide_peak_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = carbon_dioxide_peak_level};
+    return hap_char_create_from_desc(&hap_char_carbon_dioxide_peak_level_desc, val);
 }
 
 
 /* Char: Air Quality */
+static const hap_char_desc_t hap_char_air_quality_desc = {
+    .type_uuid = HAP_CHAR_UUID_AIR_QUALITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 5, 1, NULL),
+};
+
 hap_char_t *hap_char_air_quality_create(uint8_t air_quality)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_AIR_QUALITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, air_quality);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 5, 1);
-
-    return hc;
+    hap_val_t val = {.u = air_quality};
+    return hap_char_create_from_desc(&hap_char_air_quality_desc, val);
 }
 
 /* Char: Accessory Flags */
@@ -868,285 +849,283 @@ hap_char_t *hap_char_product_data_create(hap_data_val_t *product_data)
 }
 
 /* Char: Lock Physical Controls */
+static const hap_char_desc_t hap_char_lock_physical_controls_desc = {
+    .type_uuid = HAP_CHAR_UUID_LOCK_PHYSICAL_CONTROLS,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_lock_physical_controls_create(uint8_t lock_physical_controls)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_LOCK_PHYSICAL_CONTROLS,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, lock_physical_controls);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = lock_physical_controls};
+    return hap_char_create_from_desc(&hap_char_lock_physical_controls_desc, val);
 }
 
 /* Char: Current Air Purifier State */
+static const hap_char_desc_t hap_char_current_air_purifier_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_AIR_PURIFIER_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_current_air_purifier_state_create(uint8_t curr_air_purifier_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_AIR_PURIFIER_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_air_purifier_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_air_purifier_state};
+    return hap_char_create_from_desc(&hap_char_current_air_purifier_state_desc, val);
 }
 
 /* Char: Current Slat State */
+static const hap_char_desc_t hap_char_current_slat_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_SLAT_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_current_slat_state_create(uint8_t curr_slat_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_SLAT_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_slat_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_slat_state};
+    return hap_char_create_from_desc(&hap_char_current_slat_state_desc, val);
 }
 
 /* Char: Slat Type */
+static const hap_char_desc_t hap_char_slat_type_desc = {
+    .type_uuid = HAP_CHAR_UUID_SLAT_TYPE,
+    .perms = HAP_CHAR_PERM_PR,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_slat_type_create(uint8_t slat_type)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_SLAT_TYPE,
-                                           HAP_CHAR_PERM_PR, slat_type);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = slat_type};
+    return hap_char_create_from_desc(&hap_char_slat_type_desc, val);
 }
 
 /* Char: Filter Life Level */
+static const hap_char_desc_t hap_char_filter_life_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_FILTER_LIFE_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, NULL),
+};
+
 hap_char_t *hap_char_filter_life_level_create(float filter_life_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_FILTER_LIFE_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, filter_life_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-
-    return hc;
+    hap_val_t val = {.f = filter_life_level};
+    return hap_char_create_from_desc(&hap_char_filter_life_level_desc, val);
 }
 
 /* Char: Filter Change Indication */
+static const hap_char_desc_t hap_char_filter_change_indication_desc = {
+    .type_uuid = HAP_CHAR_UUID_FILTER_CHANGE_INDICATION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_filter_change_indication_create(uint8_t filter_change_indication)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_FILTER_CHANGE_INDICATION,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, filter_change_indication);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = filter_change_indication};
+    return hap_char_create_from_desc(&hap_char_filter_change_indication_desc, val);
 }
 
 /* Char: Reset Filter Indication */
+static const hap_char_desc_t hap_char_reset_filter_indication_desc = {
+    .type_uuid = HAP_CHAR_UUID_RESET_FILTER_INDICATION,
+    .perms = HAP_CHAR_PERM_PW,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(1, 1, 0, NULL),
+};
+
 hap_char_t *hap_char_reset_filter_indication_create(uint8_t reset_filter_indication)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_RESET_FILTER_INDICATION,
-                                           HAP_CHAR_PERM_PW, reset_filter_indication);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 1, 1, 0);
-
-    return hc;
+    hap_val_t val = {.u = reset_filter_indication};
+    return hap_char_create_from_desc(&hap_char_reset_filter_indication_desc, val);
 }
 
 /* Char: Target Air Purifier State */
+static const hap_char_desc_t hap_char_target_air_purifier_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_AIR_PURIFIER_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_target_air_purifier_state_create(uint8_t targ_air_purifier_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_AIR_PURIFIER_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_air_purifier_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = targ_air_purifier_state};
+    return hap_char_create_from_desc(&hap_char_target_air_purifier_state_desc, val);
 }
 
 /* Char: Target Fan State */
+static const hap_char_desc_t hap_char_target_fan_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_FAN_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_target_fan_state_create(uint8_t targ_fan_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_FAN_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_fan_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = targ_fan_state};
+    return hap_char_create_from_desc(&hap_char_target_fan_state_desc, val);
 }
 
 /* Char: Current Fan State */
+static const hap_char_desc_t hap_char_current_fan_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_FAN_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_current_fan_state_create(uint8_t curr_fan_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_FAN_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_fan_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_fan_state};
+    return hap_char_create_from_desc(&hap_char_current_fan_state_desc, val);
 }
 
 /* Char: Active State */
+static const hap_char_desc_t hap_char_active_desc = {
+    .type_uuid = HAP_CHAR_UUID_ACTIVE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_active_create(uint8_t active)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_ACTIVE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, active);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = active};
+    return hap_char_create_from_desc(&hap_char_active_desc, val);
 }
 
 /* Char: Swing Mode */
+static const hap_char_desc_t hap_char_swing_mode_desc = {
+    .type_uuid = HAP_CHAR_UUID_SWING_MODE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_swing_mode_create(uint8_t swing_mode)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_SWING_MODE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, swing_mode);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = swing_mode};
+    return hap_char_create_from_desc(&hap_char_swing_mode_desc, val);
 }
 
 /* Char: Current Tilt Angle */
+static const hap_char_desc_t hap_char_current_tilt_angle_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_TILT_ANGLE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(-90, 90, 1, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_current_tilt_angle_create(int curr_tilt_angle)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_CURRENT_TILT_ANGLE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_tilt_angle);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, -90, 90, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.i = curr_tilt_angle};
+    return hap_char_create_from_desc(&hap_char_current_tilt_angle_desc, val);
 }
 
 /* Char: Target Tilt Angle */
+static const hap_char_desc_t hap_char_target_tilt_angle_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_TILT_ANGLE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_INT,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(-90, 90, 1, HAP_CHAR_UNIT_ARCDEGREES),
+};
+
 hap_char_t *hap_char_target_tilt_angle_create(int targ_tilt_angle)
 {
-    hap_char_t *hc = hap_char_int_create(HAP_CHAR_UUID_TARGET_TILT_ANGLE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_tilt_angle);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, -90, 90, 1);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_ARCDEGREES);
-
-    return hc;
+    hap_val_t val = {.i = targ_tilt_angle};
+    return hap_char_create_from_desc(&hap_char_target_tilt_angle_desc, val);
 }
 
 /* Char: Ozone Density */
+static const hap_char_desc_t hap_char_ozone_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_OZONE_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 1000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_ozone_density_create(float ozone_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_OZONE_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, ozone_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 1000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = ozone_density};
+    return hap_char_create_from_desc(&hap_char_ozone_density_desc, val);
 }
 
 /* Char: Nitrogen Dioxide Density */
+static const hap_char_desc_t hap_char_nitrogen_dioxide_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_NITROGEN_DIOXIDE_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 1000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_nitrogen_dioxide_density_create(float nitrogen_dioxide_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_NITROGEN_DIOXIDE_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, nitrogen_dioxide_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 1000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = nitrogen_dioxide_density};
+    return hap_char_create_from_desc(&hap_char_nitrogen_dioxide_density_desc, val);
 }
 
 /* Char: Sulphur Dioxide Density */
+static const hap_char_desc_t hap_char_sulphur_dioxide_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_SULPHUR_DIOXIDE_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 1000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_sulphur_dioxide_density_create(float sulphur_dioxide_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_SULPHUR_DIOXIDE_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, sulphur_dioxide_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 1000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = sulphur_dioxide_density};
+    return hap_char_create_from_desc(&hap_char_sulphur_dioxide_density_desc, val);
 }
 
 /* Char: PM2.5 Density */
+static const hap_char_desc_t hap_char_pm_2_5_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_PM_2_5_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 1000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_pm_2_5_density_create(float pm_2_5_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_PM_2_5_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, pm_2_5_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 1000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = pm_2_5_density};
+    return hap_char_create_from_desc(&hap_char_pm_2_5_density_desc, val);
 }
 
 /* Char: PM10 Density */
+static const hap_char_desc_t hap_char_pm_10_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_PM_10_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 1000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_pm_10_density_create(float pm_10_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_PM_10_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, pm_10_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 1000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = pm_10_density};
+    return hap_char_create_from_desc(&hap_char_pm_10_density_desc, val);
 }
 
 /* Char: VOC Density */
+static const hap_char_desc_t hap_char_voc_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_VOC_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 1000.0, 0.0, NULL),
+};
+
 hap_char_t *hap_char_voc_density_create(float voc_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_VOC_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, voc_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 1000.0, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = voc_density};
+    return hap_char_create_from_desc(&hap_char_voc_density_desc, val);
 }
 
 /* Char: Service Label Index */
@@ -1162,229 +1141,227 @@ hap_char_t *hap_char_service_label_index_create(uint8_t service_label_index)
 }
 
 /* Char: Service Label Namespace */
+static const hap_char_desc_t hap_char_service_label_namespace_desc = {
+    .type_uuid = HAP_CHAR_UUID_SERVICE_LABEL_NAMESPACE,
+    .perms = HAP_CHAR_PERM_PR,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_service_label_namespace_create(uint8_t service_label_namespace)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_SERVICE_LABEL_NAMESPACE,
-                                         HAP_CHAR_PERM_PR, service_label_namespace);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = service_label_namespace};
+    return hap_char_create_from_desc(&hap_char_service_label_namespace_desc, val);
 }
 
 /* Char: Color Temperature */
+static const hap_char_desc_t hap_char_color_temperature_desc = {
+    .type_uuid = HAP_CHAR_UUID_COLOR_TEMPERATURE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT32,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(50, 400, 1, NULL),
+};
+
 hap_char_t *hap_char_color_temperature_create(uint32_t color_temp)
 {
-    hap_char_t *hc = hap_char_uint32_create(HAP_CHAR_UUID_COLOR_TEMPERATURE,
-                                            HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, color_temp);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 50, 400, 1);
-
-    return hc;
+    hap_val_t val = {.u = color_temp};
+    return hap_char_create_from_desc(&hap_char_color_temperature_desc, val);
 }
 
 /* Char: Current Heater Cooler State */
+static const hap_char_desc_t hap_char_current_heater_cooler_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_HEATER_COOLER_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3, 1, NULL),
+};
+
 hap_char_t *hap_char_current_heater_cooler_state_create(uint8_t curr_heater_cooler_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_HEATER_COOLER_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_heater_cooler_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_heater_cooler_state};
+    return hap_char_create_from_desc(&hap_char_current_heater_cooler_state_desc, val);
 }
 
 /* Char: Target Heater Cooler State */
+static const hap_char_desc_t hap_char_target_heater_cooler_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_HEATER_COOLER_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_target_heater_cooler_state_create(uint8_t targ_heater_cooler_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_HEATER_COOLER_STATE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_heater_cooler_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = targ_heater_cooler_state};
+    return hap_char_create_from_desc(&hap_char_target_heater_cooler_state_desc, val);
 }
 
 /* Char: Current Humidifier Dehumidifier State */
+static const hap_char_desc_t hap_char_current_humidifier_dehumidifier_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_CURRENT_HUMIDIFIER_DEHUMIDIFIER_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3, 1, NULL),
+};
+
 hap_char_t *hap_char_current_humidifier_dehumidifier_state_create(uint8_t curr_humidifier_dehumidifier_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_CURRENT_HUMIDIFIER_DEHUMIDIFIER_STATE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, curr_humidifier_dehumidifier_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3, 1);
-
-    return hc;
+    hap_val_t val = {.u = curr_humidifier_dehumidifier_state};
+    return hap_char_create_from_desc(&hap_char_current_humidifier_dehumidifier_state_desc, val);
 }
 
 /* Char: Target Humidifier Dehumidifier State */
+static const hap_char_desc_t hap_char_target_humidifier_dehumidifier_state_desc = {
+    .type_uuid = HAP_CHAR_UUID_TARGET_HUMIDIFIER_DEHUMIDIFIER_STATE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_target_humidifier_dehumidifier_state_create(uint8_t targ_humidifier_dehumidifier_state)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_TARGET_HUMIDIFIER_DEHUMIDIFIER_STATE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, targ_humidifier_dehumidifier_state);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = targ_humidifier_dehumidifier_state};
+    return hap_char_create_from_desc(&hap_char_target_humidifier_dehumidifier_state_desc, val);
 }
 
 /* Char: Water Level */
+static const hap_char_desc_t hap_char_water_level_desc = {
+    .type_uuid = HAP_CHAR_UUID_WATER_LEVEL,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, NULL),
+};
+
 hap_char_t *hap_char_water_level_create(float water_level)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_WATER_LEVEL,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, water_level);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-
-    return hc;
+    hap_val_t val = {.f = water_level};
+    return hap_char_create_from_desc(&hap_char_water_level_desc, val);
 }
 
 /* Char: Relative Humidity Dehumidifier Threshold  */
+static const hap_char_desc_t hap_char_relative_humidity_dehumidifier_threshold_desc = {
+    .type_uuid = HAP_CHAR_UUID_RELATIVE_HUMIDITY_DEHUMIDIFIER_THRESHOLD,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_relative_humidity_dehumidifier_threshold_create(float rel_humidity_dehumidifier_threshold)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_RELATIVE_HUMIDITY_DEHUMIDIFIER_THRESHOLD,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, rel_humidity_dehumidifier_threshold);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.f = rel_humidity_dehumidifier_threshold};
+    return hap_char_create_from_desc(&hap_char_relative_humidity_dehumidifier_threshold_desc, val);
 }
 
 /* Char: Relative Humidity Humidifier Threshold  */
+static const hap_char_desc_t hap_char_relative_humidity_humidifier_threshold_desc = {
+    .type_uuid = HAP_CHAR_UUID_RELATIVE_HUMIDITY_HUMIDIFIER_THRESHOLD,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0.0, 100.0, 1.0, HAP_CHAR_UNIT_PERCENTAGE),
+};
+
 hap_char_t *hap_char_relative_humidity_humidifier_threshold_create(float rel_humidity_humidifier_threshold)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_RELATIVE_HUMIDITY_HUMIDIFIER_THRESHOLD,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, rel_humidity_humidifier_threshold);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0.0, 100.0, 1.0);
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_PERCENTAGE);
-
-    return hc;
+    hap_val_t val = {.f = rel_humidity_humidifier_threshold};
+    return hap_char_create_from_desc(&hap_char_relative_humidity_humidifier_threshold_desc, val);
 }
 
 /* Char: Program Mode */
+static const hap_char_desc_t hap_char_program_mode_desc = {
+    .type_uuid = HAP_CHAR_UUID_PROGRAM_MODE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 2, 1, NULL),
+};
+
 hap_char_t *hap_char_program_mode_create(uint8_t prog_mode)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_PROGRAM_MODE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, prog_mode);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 2, 1);
-
-    return hc;
+    hap_val_t val = {.u = prog_mode};
+    return hap_char_create_from_desc(&hap_char_program_mode_desc, val);
 }
 
 /* Char: In Use */
+static const hap_char_desc_t hap_char_in_use_desc = {
+    .type_uuid = HAP_CHAR_UUID_IN_USE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_in_use_create(uint8_t in_use)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_IN_USE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, in_use);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = in_use};
+    return hap_char_create_from_desc(&hap_char_in_use_desc, val);
 }
 
 /* Char: Set Duration */
+static const hap_char_desc_t hap_char_set_duration_desc = {
+    .type_uuid = HAP_CHAR_UUID_SET_DURATION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT32,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3600, 1, NULL),
+};
+
 hap_char_t *hap_char_set_duration_create(uint32_t set_duration)
 {
-    hap_char_t *hc = hap_char_uint32_create(HAP_CHAR_UUID_SET_DURATION,
-                                            HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, set_duration);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3600, 1);
-
-    return hc;
+    hap_val_t val = {.u = set_duration};
+    return hap_char_create_from_desc(&hap_char_set_duration_desc, val);
 }
 
 /* Char: Remaining Duration */
+static const hap_char_desc_t hap_char_remaining_duration_desc = {
+    .type_uuid = HAP_CHAR_UUID_REMAINING_DURATION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT32,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3600, 1, NULL),
+};
+
 hap_char_t *hap_char_remaining_duration_create(uint32_t remaining_duration)
 {
-    hap_char_t *hc = hap_char_uint32_create(HAP_CHAR_UUID_REMAINING_DURATION,
-                                            HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, remaining_duration);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3600, 1);
-
-    return hc;
+    hap_val_t val = {.u = remaining_duration};
+    return hap_char_create_from_desc(&hap_char_remaining_duration_desc, val);
 }
 
 /* Char: Valve Type */
+static const hap_char_desc_t hap_char_valve_type_desc = {
+    .type_uuid = HAP_CHAR_UUID_VALVE_TYPE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 3, 1, NULL),
+};
+
 hap_char_t *hap_char_valve_type_create(uint8_t valve_type)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_VALVE_TYPE,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, valve_type);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 3, 1);
-
-    return hc;
+    hap_val_t val = {.u = valve_type};
+    return hap_char_create_from_desc(&hap_char_valve_type_desc, val);
 }
 
 /* Char: Is Configured */
+static const hap_char_desc_t hap_char_is_configured_desc = {
+    .type_uuid = HAP_CHAR_UUID_IS_CONFIGURED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_is_configured_create(uint8_t is_configured)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_IS_CONFIGURED,
-                                         HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, is_configured);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = is_configured};
+    return hap_char_create_from_desc(&hap_char_is_configured_desc, val);
 }
 
 /* Char: Status Jammed */
+static const hap_char_desc_t hap_char_status_jammed_desc = {
+    .type_uuid = HAP_CHAR_UUID_STATUS_JAMMED,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_status_jammed_create(uint8_t status_jammed)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_STATUS_JAMMED,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV, status_jammed);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = status_jammed};
+    return hap_char_create_from_desc(&hap_char_status_jammed_desc, val);
 }
 
 /* Char: Administrator Only Access */
@@ -1413,32 +1390,31 @@ hap_char_t *hap_char_lock_control_point_create(hap_tlv8_val_t *lock_control_poin
 }
 
 /* Char: Lock Last Known Action */
+static const hap_char_desc_t hap_char_lock_last_known_action_desc = {
+    .type_uuid = HAP_CHAR_UUID_LOCK_LAST_KNOWN_ACTION,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV ,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 8, 1, NULL),
+};
+
 hap_char_t *hap_char_lock_last_known_action_create(uint8_t lock_last_known_action)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_LOCK_LAST_KNOWN_ACTION,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV , lock_last_known_action);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 8, 1);
-
-    return hc;
+    hap_val_t val = {.u = lock_last_known_action};
+    return hap_char_create_from_desc(&hap_char_lock_last_known_action_desc, val);
 }
 
 /* Char: Lock Management Auto Security Timeout */
+static const hap_char_desc_t hap_char_lock_management_auto_security_timeout_desc = {
+    .type_uuid = HAP_CHAR_UUID_LOCK_MANAGEMENT_AUTO_SECURITY_TIMEOUT,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV,
+    .format = HAP_CHAR_FORMAT_UINT32,
+    .meta = {.unit = HAP_CHAR_UNIT_SECONDS},
+};
+
 hap_char_t *hap_char_lock_management_auto_security_timeout_create(uint32_t lock_management_auto_security_timeout)
 {
-    hap_char_t *hc = hap_char_uint32_create(HAP_CHAR_UUID_LOCK_MANAGEMENT_AUTO_SECURITY_TIMEOUT,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_PW | HAP_CHAR_PERM_EV, 
-                                           lock_management_auto_security_timeout);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_add_unit(hc, HAP_CHAR_UNIT_SECONDS);
-
-    return hc;
+    hap_val_t val = {.u = lock_management_auto_security_timeout};
+    return hap_char_create_from_desc(&hap_char_lock_management_auto_security_timeout_desc, val);
 }
 
 /* Char: Logs */
@@ -1454,29 +1430,29 @@ hap_char_t *hap_char_logs_create(hap_tlv8_val_t *logs)
 }
 
 /* Char: Air Particulate Density */
+static const hap_char_desc_t hap_char_air_particulate_density_desc = {
+    .type_uuid = HAP_CHAR_UUID_AIR_PARTICULATE_DENSITY,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV ,
+    .format = HAP_CHAR_FORMAT_FLOAT,
+    HAP_CHAR_DESC_FLOAT_CONSTRAINTS(0, 1000, 0.0, NULL),
+};
+
 hap_char_t *hap_char_air_particulate_density_create(float air_particulate_density)
 {
-    hap_char_t *hc = hap_char_float_create(HAP_CHAR_UUID_AIR_PARTICULATE_DENSITY,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV , air_particulate_density);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_float_set_constraints(hc, 0, 1000, 0.0);
-
-    return hc;
+    hap_val_t val = {.f = air_particulate_density};
+    return hap_char_create_from_desc(&hap_char_air_particulate_density_desc, val);
 }
 
 /* Char: Air Particulate Size */
+static const hap_char_desc_t hap_char_air_particulate_size_desc = {
+    .type_uuid = HAP_CHAR_UUID_AIR_PARTICULATE_SIZE,
+    .perms = HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV ,
+    .format = HAP_CHAR_FORMAT_UINT8,
+    HAP_CHAR_DESC_INT_CONSTRAINTS(0, 1, 1, NULL),
+};
+
 hap_char_t *hap_char_air_particulate_size_create(uint8_t air_particulate_size)
 {
-    hap_char_t *hc = hap_char_uint8_create(HAP_CHAR_UUID_AIR_PARTICULATE_SIZE,
-                                           HAP_CHAR_PERM_PR | HAP_CHAR_PERM_EV , air_particulate_size);
-    if (!hc) {
-        return NULL;
-    }
-
-    hap_char_int_set_constraints(hc, 0, 1, 1);
-
-    return hc;
+    hap_val_t val = {.u = air_particulate_size};
+    return hap_char_create_from_desc(&hap_char_air_particulate_size_desc, val);
 }
@@ -118,6 +118,84 @@ typedef union {
     hap_tlv8_val_t t;
 } hap_val_t;
 
+/** Numeric type ID of a characteristic or service.
+ *
+ * For Apple defined types, this is the value of the short UUID (e.g. 0x25 for "25"
+ * or "00000025-0000-1000-8000-0026BB765291"), so it can be used in switch statements
+ * with the HAP_CHAR_TYPE_ID_* and HAP_SERV_TYPE_ID_* constants. Custom UUIDs get an
+ * ID with \ref HAP_TYPE_ID_CUSTOM_FLAG set, assigned at runtime by hap_type_id_get().
+ */
+typedef uint32_t hap_type_id_t;
+
+/** Invalid type ID */
+#define HAP_TYPE_ID_INVALID         0
+/** Set in the type IDs of custom (non Apple) UUIDs */
+#define HAP_TYPE_ID_CUSTOM_FLAG     0x80000000
+
+/** Check if a characteristic is of the given type ID. Never true for HAP_TYPE_ID_INVALID */
+#define hap_char_is_type(hc, id)    (((id) != HAP_TYPE_ID_INVALID) && (hap_char_get_type_id(hc) == (id)))
+
+/** Characteristic constraint flags, set in \ref hap_char_desc_t.constraint_flags */
+#define HAP_CHAR_MIN_FLAG		(1 << 0)
+#define HAP_CHAR_MAX_FLAG		(1 << 1)
+#define HAP_CHAR_STEP_FLAG		(1 << 2)
+#define HAP_CHAR_MAXLEN_FLAG		(1 << 3)
+#define HAP_CHAR_MAXDATALEN_FLAG	(1 << 4)
+#define HAP_CHAR_VALID_RANGE_FLAG	(1 << 5)
+
+/** Characteristic constraints and metadata */
+typedef struct {
+    /** Maximum value, maximum length or maximum data length */
+    hap_val_t max;
+    /** Minimum value */
+    hap_val_t min;
+    /** Step value */
+    hap_val_t step;
+    /** Description of the characteristic. Can be NULL */
+    const char *description;
+    /** Unit of the characteristic. Can be NULL */
+    const char *unit;
+    /** List of valid values. Can be NULL */
+    const uint8_t *valid_vals;
+    /** Number of entries in valid_vals */
+    uint16_t valid_vals_cnt;
+    /** Valid values range. Used only if \ref HAP_CHAR_VALID_RANGE_FLAG is set */
+    uint8_t valid_vals_range[2];
+} hap_char_meta_t;
+
+/** Constant characteristic descriptor
+ *
+ * Describes the parts of a characteristic which never change, so that they can
+ * be kept in flash and shared by all characteristics created from it.
+ * Use with \ref hap_char_create_from_desc().
+ */
+typedef struct {
+    /** UUID for the characteristic as per the HAP Specs */
+    const char *type_uuid;
+    /** Logically OR of the various permissions supported by the characteristic */
+    uint16_t perms;
+    /** Format of the characteristic value */
+    hap_char_format_t format;
+    /** Logically OR of the HAP_CHAR_*_FLAG constraint flags which are valid in meta */
+    uint8_t constraint_flags;
+    /** Constraints and metadata */
+    hap_char_meta_t meta;
+} hap_char_desc_t;
+
+/** Initialise the integer constraints and unit of a \ref hap_char_desc_t,
+ * equivalent to hap_char_int_set_constraints() and hap_char_add_unit()
+ */
+#define HAP_CHAR_DESC_INT_CONSTRAINTS(_min, _max, _step, _unit) \
+    .constraint_flags = HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG | ((_step) ? HAP_CHAR_STEP_FLAG : 0), \
+    .meta = {.min = {.i = (_min)}, .max = {.i = (_max)}, .step = {.i = (_step)}, .unit = (_unit)}
+
+/** Initialise the float constraints and unit of a \ref hap_char_desc_t,
+ * equivalent to hap_char_float_set_constraints() and hap_char_add_unit()
+ */
+#define HAP_CHAR_DESC_FLOAT_CONSTRAINTS(_min, _max, _step, _unit) \
+    .constraint_flags = HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG | ((_step) ? HAP_CHAR_STEP_FLAG : 0), \
+    .meta = {.min = {.f = (_min)}, .max = {.f = (_max)}, .step = {.f = (_step)}, .unit = (_unit)}
+
 /** Information about the Provisioned Network to which the accessory will connect */
 typedef struct {
     /** SSID for the network */
@@ -321,9 +399,10 @@ typedef struct {
     uint32_t task_stack_size;
     /** Internal HomeKit Task's priority */
     uint8_t task_priority;
-    /** Maximum characteristics to which event notifications can be sent simultaneously.
-     * Default value is enough for standalone accessories. Change may be required only
-     * for bridges.
+    /** Maximum characteristics included in a single event notification message.
+     * If more characteristics have notifications pending, the remaining ones are
+     * sent in the next message, right after. Larger values mean fewer messages
+     * for bridges, at the cost of a larger temporary allocation.
      */
     uint8_t max_event_notif_chars;
     /** Indicates what paramaters will be made unique by the HAP Core */
@@ -347,8 +426,34 @@ typedef struct {
      * to increment c#. Note thar c# will still increment on a firmware upgrade though.
      */
     bool disable_config_num_update;
+    /** Time window (in milliseconds) for which characteristic value changes are collected before
+     * sending event notifications, so that multiple changes go out in a single notification.
+     * Default value is 0, which means that notifications are sent immediately.
+     */
+    uint16_t notif_batch_window;
+    /** Depth of the internal HomeKit Task's queue for control events like resets and pairing
+     * changes. Notification triggers do not use this queue. Change may be required only if
+     * \ref HAP_EVENT_LOOP_QUEUE_OVERFLOW is seen. Takes effect only if set before hap_start().
+     * If set to 0, the default size is used.
+     */
+    uint8_t loop_queue_size;
+    /** Time (in milliseconds) within which writes deferred using hap_write_defer() must be
+     * completed. The response then reports \ref HAP_STATUS_TIMEOUT for the writes which
+     * are still pending.
+     */
+    uint16_t write_complete_timeout;
 } hap_cfg_t;
 
+/** Event Notification Statistics */
+typedef struct {
+    /** Number of characteristic events sent to controllers (counted once per controller) */
+    uint32_t sent;
+    /** Number of value changes merged into an already pending notification */
+    uint32_t coalesced;
+    /** Number of characteristic events that could not be sent */
+    uint32_t dropped;
+} hap_notif_stats_t;
+
 /** Get HomeKit Configuration
  *
  * Gets the configuration that will be used by the HomeKit core.
@@ -434,6 +539,55 @@ int hap_start(void);
  */
 int hap_stop(void);
 
+/** Attribute database arena statistics */
+typedef struct {
+    /** Number of objects allocated from the arena */
+    uint32_t allocs;
+    /** Number of arena chunks, i.e. heap blocks, used */
+    uint32_t chunks;
+    /** Bytes used by the objects */
+    size_t used;
+    /** Total bytes in the arena chunks */
+    size_t size;
+} hap_db_arena_stats_t;
+
+/**
+ * @brief Start allocating attribute database objects from an arena
+ *
+ * Accessories, services and characteristics created after this are packed
+ * into large chunks of CONFIG_HAP_DB_ARENA_CHUNK_SIZE bytes, rather than being
+ * separate heap allocations. This saves the per allocation overhead and avoids
+ * heap fragmentation, which matters for bridges with many accessories.
+ *
+ * @note Arena memory is never freed. Objects created inside the arena can be
+ * deleted, but their memory will not be reused. So, bridged accessories which
+ * may be removed later should be created after hap_db_arena_commit(), so that
+ * they use the regular heap.
+ *
+ * @note This is not thread safe. All the objects should be created from the same task.
+ *
+ * @return HAP_SUCCESS on success
+ * @return HAP_FAIL if an arena is already active
+ */
+int hap_db_arena_begin(void);
+
+/**
+ * @brief Stop allocating attribute database objects from the arena
+ *
+ * Objects created after this use the regular heap.
+ *
+ * @return HAP_SUCCESS on success
+ * @return HAP_FAIL if no arena was active
+ */
+int hap_db_arena_commit(void);
+
+/**
+ * @brief Get attribute database arena statistics
+ *
+ * @param[out] stats Pointer to the statistics structure to be filled.
+ */
+void hap_db_arena_get_stats(hap_db_arena_stats_t *stats);
+
 /**
  * @brief Create a HAP accessory object
  *
@@ -766,6 +920,23 @@ hap_char_t *hap_char_data_create(char *type_uuid, uint16_t perms, hap_data_val_t
  */
 hap_char_t *hap_char_tlv8_create(char *type_uuid, uint16_t perms, hap_tlv8_val_t *val);
 
+/**
+ * @brief Create a Characteristic Object from a constant descriptor
+ *
+ * The descriptor is referenced, not copied, so it must remain valid throughout
+ * the lifetime of the characteristic. It is typically declared static const, so
+ * that it stays in flash. Calling the constraint or metadata APIs on such a
+ * characteristic later gives it its own copy of the metadata.
+ *
+ * @param[in] desc Pointer to the characteristic descriptor
+ * @param[in] val Initial value of the characteristic. For string characteristics,
+ * the string is copied.
+ *
+ * @return Handle for the characteristic object created
+ * @return NULL on error
+ */
+hap_char_t *hap_char_create_from_desc(const hap_char_desc_t *desc, hap_val_t val);
+
 /**
  * @brief Delete a characteristic object
  *
@@ -863,6 +1034,32 @@ uint32_t hap_char_get_iid(hap_char_t *hc);
  */
 const char * hap_char_get_type_uuid(hap_char_t *hc);
 
+/**
+ * @brief Get the numeric type ID for the given characteristic
+ *
+ * This is faster than comparing the type UUID strings, and can be used in switch statements.
+ *
+ * @param[in] hc HAP Characteristic Object handle
+ *
+ * @return Type ID for the characteristic
+ * @return HAP_TYPE_ID_INVALID on error
+ */
+hap_type_id_t hap_char_get_type_id(hap_char_t *hc);
+
+/**
+ * @brief Get the numeric type ID for a type UUID
+ *
+ * Custom UUIDs are interned, so that the same UUID always gets the same ID.
+ * Applications can call this once for their custom UUIDs and keep the result,
+ * to compare with hap_char_get_type_id().
+ *
+ * @param[in] type_uuid UUID for the characteristic or service, in short or full form
+ *
+ * @return Type ID for the UUID
+ * @return HAP_TYPE_ID_INVALID on error
+ */
+hap_type_id_t hap_type_id_get(const char *type_uuid);
+
 
 /**
  * @brief Get the Permissions for the given characteristic
@@ -901,6 +1098,17 @@ uint32_t hap_serv_get_iid(hap_serv_t *hs);
  * @return Type UUID for the service
  */
 char *hap_serv_get_type_uuid(hap_serv_t *hs);
+
+/**
+ * @brief Get the numeric type ID for the given service
+ *
+ * @param[in] hs HAP Service Object handle
+ *
+ * @return Type ID for the service
+ * @return HAP_TYPE_ID_INVALID on error
+ */
+hap_type_id_t hap_serv_get_type_id(hap_serv_t *hs);
+
 /**
  * @brief Get parent Service for given Characteristic
  *
@@ -1005,6 +1213,30 @@ void hap_char_add_valid_vals_range(hap_char_t *hc, uint8_t start_val, uint8_t en
  */
 void hap_char_set_iid(hap_char_t *hc, int32_t iid);
 
+/**
+ * @brief Set minimum interval between event notifications for a characteristic
+ *
+ * Value changes within this interval are not notified immediately. The latest
+ * value will be notified once the interval elapses. This can be used to limit
+ * notifications for frequently changing values (like power consumption) without
+ * affecting other characteristics.
+ *
+ * @param[in] hc HAP Characteristic Object Handle
+ * @param[in] interval_ms Minimum interval in milliseconds. 0 (default) disables rate limiting.
+ */
+void hap_char_set_min_notif_interval(hap_char_t *hc, uint32_t interval_ms);
+
+/**
+ * @brief Get event notification statistics
+ *
+ * @param[out] stats Pointer to an allocated \ref hap_notif_stats_t structure which will be populated
+ * with the statistics.
+ *
+ * @return HAP_SUCCESS on success
+ * @return HAP_FAIL on error
+ */
+int hap_get_notif_stats(hap_notif_stats_t *stats);
+
 /**
  * @brief Add a characteristic to a service
  *
@@ -1123,6 +1355,50 @@ typedef struct {
 typedef int (*hap_serv_write_t) (hap_write_data_t write_data[], int count,
 		void *serv_priv, void *write_priv);
 
+/** Handle for completing deferred writes, obtained using hap_write_defer() */
+typedef void * hap_write_handle_t;
+
+/**
+ * @brief Defer the completion of writes
+ *
+ * Can be called from a service write routine (\ref hap_serv_write_t) which cannot
+ * finish its writes quickly, say because the hardware is slow to respond. The write
+ * routine can then return right away, and the HomeKit web server keeps serving other
+ * requests. The response to the write request is sent once hap_write_complete() is called
+ * for the handle, or after the write_complete_timeout in \ref hap_cfg_t, with
+ * \ref HAP_STATUS_TIMEOUT reported for the writes.
+ *
+ * The status and value of all the characteristics passed to the write routine are then
+ * decided by hap_write_complete(). The write_data array and the values in it are valid
+ * only till the write routine returns, so anything required later must be copied.
+ *
+ * @note Writes cannot be deferred if the response has already been started, as can
+ * happen for very large write requests or if some characteristics had errors. The writes
+ * must be completed in the write routine itself in that case.
+ *
+ * @param[in] write_priv The write_priv passed to the write routine
+ *
+ * @return Handle to be passed to hap_write_complete()
+ * @return NULL if the writes cannot be deferred
+ */
+hap_write_handle_t hap_write_defer(void *write_priv);
+
+/**
+ * @brief Complete deferred writes
+ *
+ * Reports the status of all the characteristic writes deferred using the handle. It can be
+ * called from any task, even after the deadline has expired, and must be called exactly
+ * once for every handle. In case of success, the values should be updated using
+ * hap_char_update_val() before calling this.
+ *
+ * @param[in] handle Handle obtained using hap_write_defer()
+ * @param[in] status Status of the writes
+ *
+ * @return HAP_SUCCESS on success
+ * @return HAP_FAIL on invalid handle
+ */
+int hap_write_complete(hap_write_handle_t handle, hap_status_t status);
+
 /** Service Read Function Prototype
  *
  * A function with this prototype must be registered with the HAP framework to handle
@@ -1529,6 +1805,15 @@ typedef enum {
      * an unpaired state for more than the time specified in HAP Spec R16.
      */
     HAP_EVENT_PAIRING_MODE_TIMED_OUT,
+    /** hap_start() has completed and the accessory has been announced over mDNS.
+     * Associated data is a pointer to \ref hap_startup_profile_t.
+     */
+    HAP_EVENT_STARTUP_COMPLETE,
+    /** Internal HomeKit events were dropped because the HomeKit Task's queue was full.
+     * Associated data is a pointer to a uint32_t with the total number of events dropped so far.
+     * Consider increasing loop_queue_size in \ref hap_cfg_t.
+     */
+    HAP_EVENT_LOOP_QUEUE_OVERFLOW,
 } hap_event_t;
 
 /** Prototype for HomeKit Event handler
@@ -1594,6 +1879,93 @@ char *esp_hap_get_setup_payload(char *setup_code, char *setup_id, bool wac_suppo
  * as per the requirements of HAP Specs R16.
  */
 void hap_pair_setup_re_enable(void);
+
+/** Pre-generated key pool statistics */
+typedef struct {
+    /** Number of requests served using a pre-generated key */
+    uint32_t hits;
+    /** Number of requests which had to generate the key inline */
+    uint32_t misses;
+} hap_key_pool_stats_t;
+
+/** Get Pair Verify key pool statistics
+ *
+ * Pair Verify uses Curve25519 key pairs generated in the background (as per
+ * CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE). This gives the number of Pair Verify
+ * requests that found a key ready, and those which did not. Frequent misses
+ * indicate that the pool is too small for the reconnection bursts seen.
+ *
+ * @param[out] stats Pointer to the statistics structure to be filled.
+ */
+void hap_get_pair_verify_key_pool_stats(hap_key_pool_stats_t *stats);
+
+/** HomeKit startup stages, in the order in which they run */
+typedef enum {
+    /** Keystore (NVS) initialisation, in hap_init() */
+    HAP_STARTUP_STAGE_KEYSTORE_INIT = 0,
+    /** Accessory identity and controllers, in hap_init(). Includes key generation on first boot. */
+    HAP_STARTUP_STAGE_DATABASE_INIT,
+    /** MFi authentication setup, in hap_start() */
+    HAP_STARTUP_STAGE_MFI_AUTH,
+    /** Setup id, setup info and setup hash */
+    HAP_STARTUP_STAGE_SETUP_INIT,
+    /** Notification timer and HAP main loop */
+    HAP_STARTUP_STAGE_LOOP_START,
+    /** mDNS initialisation */
+    HAP_STARTUP_STAGE_MDNS_INIT,
+    /** HTTP server start */
+    HAP_STARTUP_STAGE_HTTPD_START,
+    /** HTTP handler registration and first mDNS announce */
+    HAP_STARTUP_STAGE_ANNOUNCE,
+    /** Background key pool start */
+    HAP_STARTUP_STAGE_KEYPOOL_INIT,
+    /** Max value. Not a stage */
+    HAP_STARTUP_STAGE_MAX,
+} hap_startup_stage_t;
+
+/** HomeKit startup profile */
+typedef struct {
+    /** Time since boot, in microseconds, at which each stage ended. 0 if the stage has not run. */
+    int64_t stage_end_us[HAP_STARTUP_STAGE_MAX];
+    /** Time taken by each stage, in microseconds */
+    uint32_t stage_duration_us[HAP_STARTUP_STAGE_MAX];
+} hap_startup_profile_t;
+
+/** Get HomeKit startup profile
+ *
+ * This gives the time taken by each stage of hap_init() and hap_start().
+ * stage_end_us[HAP_STARTUP_STAGE_ANNOUNCE] is the time from boot until the accessory
+ * was first discoverable. The same information is reported with \ref HAP_EVENT_STARTUP_COMPLETE.
+ *
+ * @return Pointer to the startup profile
+ */
+const hap_startup_profile_t *hap_get_startup_profile(void);
+
+/** HomeKit main loop statistics */
+typedef struct {
+    /** Number of events currently waiting in the loop queue */
+    uint32_t queued;
+    /** Maximum number of events seen waiting in the loop queue */
+    uint32_t max_queued;
+    /** Size of the loop queue (loop_queue_size in \ref hap_cfg_t, or the default). Events are dropped if it is full */
+    uint32_t queue_size;
+    /** Number of long running operations (like resets and network switch) in progress or waiting */
+    uint32_t pending_ops;
+    /** Number of events dropped because the loop queue was full */
+    uint32_t dropped;
+    /** Number of triggers (like notification triggers) merged with one already pending */
+    uint32_t coalesced;
+} hap_loop_stats_t;
+
+/** Get HomeKit main loop statistics
+ *
+ * The HomeKit main loop handles internal events like notification triggers, mDNS
+ * updates, resets and reboots. This can be used to check whether the loop is
+ * keeping up with the events, especially while bursts of notifications are generated.
+ *
+ * @param[out] stats Pointer to the statistics structure to be filled.
+ */
+void hap_get_loop_stats(hap_loop_stats_t *stats);
 #ifdef __cplusplus
 }
 #endif
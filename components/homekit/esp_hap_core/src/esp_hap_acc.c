@@ -24,6 +24,8 @@
 #include <string.h>
 #include <esp_wifi.h>
 #include <hap_platform_memory.h>
+#include <esp_hap_db_arena.h>
+#include <esp_hap_type_id.h>
 #include <esp_hap_acc.h>
 #include <esp_mfi_debug.h>
 #include <esp_mfi_debug.h>
@@ -60,15 +62,15 @@ static int hap_acc_info_write(hap_write_data_t write_data[], int count,
     __hap_char_t *_hc;
 	for (i = 0; i < count; i++) {
         _hc = (__hap_char_t *)write_data[i].hc;
-		if (!strcmp(_hc->type_uuid, HAP_CHAR_UUID_IDENTIFY)) {
+		if (_hc->type_id == HAP_CHAR_TYPE_ID_IDENTIFY) {
             __hap_acc_t *_ha = (__hap_acc_t *)serv_priv;
             if (_ha) {
                 _ha->identify_routine((hap_acc_t *)_ha);
-                *(write_data->status) = HAP_STATUS_SUCCESS;
+                *(write_data[i].status) = HAP_STATUS_SUCCESS;
                 continue;
             }
         }
-        *(write_data->status) = HAP_STATUS_VAL_INVALID;
+        *(write_data[i].status) = HAP_STATUS_VAL_INVALID;
 	}
 	return HAP_SUCCESS;
 }
@@ -80,7 +82,7 @@ hap_acc_t *hap_acc_create(hap_acc_cfg_t *acc_cfg)
 {
     static bool first = true;
     int ret = 0;
-    __hap_acc_t *_ha = hap_platform_memory_calloc(1, sizeof(__hap_acc_t));
+    __hap_acc_t *_ha = hap_db_calloc(1, sizeof(__hap_acc_t));
     if (!_ha) {
         return NULL;
     }
@@ -231,12 +233,16 @@ hap_serv_t *hap_acc_get_serv_by_iid(hap_acc_t *ha, int32_t iid)
 
 hap_serv_t *hap_acc_get_serv_by_uuid(hap_acc_t *ha, const char *uuid)
 {
-    if (!ha)
+    if (!ha || !uuid)
+        return NULL;
+
+    hap_type_id_t type_id = hap_type_id_find(uuid);
+    if (type_id == HAP_TYPE_ID_INVALID)
         return NULL;
 
     hap_serv_t *hs;
     for (hs = hap_acc_get_first_serv(ha); hs; hs = hap_serv_get_next(hs)) {
-        if (!strcmp(((__hap_serv_t *)hs)->type_uuid, uuid))
+        if (((__hap_serv_t *)hs)->type_id == type_id)
             return hs;
     }
     return NULL;
@@ -332,6 +338,7 @@ int hap_acc_add_serv(hap_acc_t *ha, hap_serv_t *hs)
 		_hc = (__hap_char_t *)_hc->next_char;
 	}
     _hs->parent = ha;
+    hap_acc_char_index_invalidate();
     return 0;
 }
 
@@ -387,6 +394,7 @@ void hap_add_accessory(hap_acc_t *ha)
     __hap_acc_t *_ha = (__hap_acc_t *)ha;
     _ha->aid = 1;
     primary_acc = _ha;
+    hap_acc_char_index_invalidate();
     if (hap_priv.cfg.unique_param >= UNIQUE_NAME) {
         char name[74];
         uint8_t eth_mac[6];
@@ -395,7 +403,7 @@ void hap_add_accessory(hap_acc_t *ha)
         hap_char_t *hc = hap_serv_get_char_by_uuid(hs, HAP_CHAR_UUID_NAME);
         snprintf(name, sizeof(name), "%s-%02X%02X%02X", ((__hap_char_t *)hc)->val.s,
                 eth_mac[3], eth_mac[4], eth_mac[5]);
-        hap_platform_memory_free(((__hap_char_t *)hc)->val.s);
+        hap_db_free(((__hap_char_t *)hc)->val.s);
         ((__hap_char_t *)hc)->val.s = strdup(name);
     }
     hap_acc_get_info(&hap_priv.primary_acc);
@@ -414,6 +422,7 @@ void hap_add_bridged_accessory(hap_acc_t *ha, int aid)
     }
 
     hap_add_acc_to_list(primary_acc, _ha);
+    hap_acc_char_index_invalidate();
     if (!hap_priv.cfg.disable_config_num_update) {
         hap_update_config_number();
     }
@@ -426,6 +435,7 @@ void hap_remove_bridged_accessory(hap_acc_t *ha)
     } else {
         if (ha) {
             hap_remove_acc_from_list(primary_acc, (__hap_acc_t *)ha);
+            hap_acc_char_index_invalidate();
             if (!hap_priv.cfg.disable_config_num_update) {
                 hap_update_config_number();
             }
@@ -450,7 +460,7 @@ void hap_acc_delete(hap_acc_t *ha)
 		hap_serv_delete((hap_serv_t *)_hs);
 		_hs = (__hap_serv_t *)_ha->servs;
 	}
-    hap_platform_memory_free(_ha);
+    hap_db_free(_ha);
 }
 
 /**
@@ -470,6 +480,7 @@ uint32_t hap_acc_get_aid(hap_acc_t *ha)
 void hap_delete_all_accessories(void)
 {
     __hap_acc_t *next, *ha = primary_acc;
+    hap_acc_char_index_invalidate();
     while (ha) {
         next = ha->next;
         hap_acc_delete((hap_acc_t *)ha);
@@ -489,3 +500,115 @@ hap_acc_t *hap_acc_get_by_aid(int32_t aid)
     }
     return NULL;
 }
+
+/* Open addressed (aid,iid) -> characteristic index used by the /characteristics
+ * handlers, so that a lookup does not have to walk all the accessories, services
+ * and characteristics. It is built lazily on the first lookup after any change
+ * in the accessory database and is simply marked stale on changes, so that the
+ * table itself is only ever touched from the lookup context.
+ */
+typedef struct {
+    uint32_t aid;
+    uint32_t iid;
+    __hap_char_t *hc;
+} hap_char_index_entry_t;
+
+static hap_char_index_entry_t *hap_char_index;
+static uint32_t hap_char_index_mask;
+/* Bumped on every change in the accessory database, which can happen in any
+ * task, even while the index is being built. The index is valid only if it was
+ * built from the current generation.
+ */
+static volatile uint32_t hap_char_index_gen = 1;
+static uint32_t hap_char_index_built_gen;
+
+static inline uint32_t hap_char_index_hash(uint32_t aid, uint32_t iid)
+{
+    uint32_t h = (aid * 0x9E3779B1) ^ iid;
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    return h;
+}
+
+void hap_acc_char_index_invalidate(void)
+{
+    hap_char_index_gen++;
+}
+
+static int hap_char_index_build(void)
+{
+    /* Snapshot the generation before walking the database, so that a change
+     * during the walk leaves the index stale, rather than getting lost.
+     */
+    uint32_t gen = hap_char_index_gen;
+    uint32_t char_cnt = 0;
+    hap_acc_t *ha;
+    hap_serv_t *hs;
+    __hap_char_t *hc;
+
+    for (ha = hap_get_first_acc(); ha; ha = hap_acc_get_next(ha)) {
+        for (hs = hap_acc_get_first_serv(ha); hs; hs = hap_serv_get_next(hs)) {
+            for (hc = (__hap_char_t *)((__hap_serv_t *)hs)->chars; hc; hc = (__hap_char_t *)hc->next_char) {
+                char_cnt++;
+            }
+        }
+    }
+    /* Keep the load factor at or below 50% so that probe sequences stay short */
+    uint32_t size = 16;
+    while (size < (char_cnt * 2)) {
+        size <<= 1;
+    }
+
+    if (hap_char_index) {
+        hap_platform_memory_free(hap_char_index);
+        hap_char_index = NULL;
+    }
+    hap_char_index_built_gen = 0;
+    hap_char_index = hap_platform_memory_calloc(size, sizeof(hap_char_index_entry_t));
+    if (!hap_char_index) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "No memory for characteristic index. Using linear lookup");
+        return HAP_FAIL;
+    }
+    hap_char_index_mask = size - 1;
+
+    for (ha = hap_get_first_acc(); ha; ha = hap_acc_get_next(ha)) {
+        uint32_t aid = ((__hap_acc_t *)ha)->aid;
+        for (hs = hap_acc_get_first_serv(ha); hs; hs = hap_serv_get_next(hs)) {
+            for (hc = (__hap_char_t *)((__hap_serv_t *)hs)->chars; hc; hc = (__hap_char_t *)hc->next_char) {
+                uint32_t slot = hap_char_index_hash(aid, hc->iid) & hap_char_index_mask;
+                /* aid 0 is never valid, so it is used to indicate an empty slot */
+                while (hap_char_index[slot].aid) {
+                    slot = (slot + 1) & hap_char_index_mask;
+                }
+                hap_char_index[slot].aid = aid;
+                hap_char_index[slot].iid = hc->iid;
+                hap_char_index[slot].hc = hc;
+            }
+        }
+    }
+    hap_char_index_built_gen = gen;
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Characteristic index built with %d entries in %d slots", (int)char_cnt, (int)size);
+    return HAP_SUCCESS;
+}
+
+/**
+ * @brief get target characteristic by AID and IID using the characteristic index
+ */
+hap_char_t *hap_acc_get_char_by_aid_iid(int32_t aid, int32_t iid)
+{
+    if (aid <= 0) {
+        return NULL;
+    }
+    if ((hap_char_index_built_gen != hap_char_index_gen) && (hap_char_index_build() != HAP_SUCCESS)) {
+        return hap_acc_get_char_by_iid(hap_acc_get_by_aid(aid), iid);
+    }
+    uint32_t slot = hap_char_index_hash(aid, iid) & hap_char_index_mask;
+    while (hap_char_index[slot].aid) {
+        if ((hap_char_index[slot].aid == (uint32_t)aid) && (hap_char_index[slot].iid == (uint32_t)iid)) {
+            return (hap_char_t *)hap_char_index[slot].hc;
+        }
+        slot = (slot + 1) & hap_char_index_mask;
+    }
+    return NULL;
+}
@@ -29,6 +29,7 @@
 #include <esp_hap_mdns.h>
 #include <esp_hap_wifi.h>
 #include <esp_hap_database.h>
+#include <esp_hap_ip_services.h>
 #include <esp_mfi_debug.h>
 
 static char *new_name;
@@ -44,6 +45,7 @@ void hap_bct_change_name(const char *name)
 
 void hap_bct_hot_plug()
 {
+    hap_acc_db_cache_invalidate();
     hap_send_event(HAP_INTERNAL_EVENT_BCT_HOT_PLUG);
 }
 
@@ -62,10 +64,14 @@ void hap_handle_bct_change_name()
     new_name = NULL;
 }
 
-void hap_handle_hot_plug()
+/* The HAP loop calls hap_handle_hot_plug_end() 10 seconds after this */
+void hap_handle_hot_plug_begin()
 {
     esp_wifi_stop();
-    vTaskDelay((10 * 1000) / portTICK_PERIOD_MS); /* Wait for 10 seconds */
+}
+
+void hap_handle_hot_plug_end()
+{
     esp_wifi_start();
     esp_wifi_connect();
 }
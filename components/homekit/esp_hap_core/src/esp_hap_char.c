@@ -23,6 +23,8 @@
  */
 
 #include <hap_platform_memory.h>
+#include <esp_hap_db_arena.h>
+#include <esp_hap_type_id.h>
 #include <math.h>
 #include <string.h>
 #include "esp_mfi_debug.h"
@@ -32,8 +34,8 @@
 #include <esp_hap_char.h>
 #include <esp_hap_ip_services.h>
 #include <esp_hap_database.h>
-
-static QueueHandle_t hap_event_queue;
+#include <esp_timer.h>
+#include <hap_platform_os.h>
 
 /**
  * @brief get characteristics's value
@@ -67,82 +69,313 @@ static double esp_mfi_fmod(double a, double b)
     return fmod(a, b);
 }
 
+static void hap_notif_timer_cb(TimerHandle_t handle)
+{
+/* TODO: Avoid direct http function. Notification could be even for iCloud or BLE.
+ */
+    hap_http_send_notif();
+}
+
 int hap_event_queue_init()
 {
-    hap_event_queue = xQueueCreate( hap_priv.cfg.max_event_notif_chars,
-                    sizeof(hap_char_t *) );
-    if (hap_event_queue) {
+    hap_priv.notif_timer = xTimerCreate("hap_notif_timer", 1, pdFALSE, NULL, hap_notif_timer_cb);
+    if (hap_priv.notif_timer) {
         return HAP_SUCCESS;
     } else {
         return HAP_FAIL;
     }
 }
 
-hap_char_t * hap_get_pending_notif_char()
+/* Guards the pending notification list and the notification statistics, which
+ * are updated from app tasks, ISRs and the httpd task.
+ */
+static portMUX_TYPE hap_notif_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void hap_notif_lock(bool in_isr)
 {
-    hap_char_t *hc;
-    if (xQueueReceive(hap_event_queue, &hc, 0) != pdTRUE) {
-        return NULL;
+    if (in_isr) {
+        portENTER_CRITICAL_ISR(&hap_notif_mux);
+    } else {
+        portENTER_CRITICAL(&hap_notif_mux);
     }
-    return hc;
 }
 
-static int hap_queue_event(hap_char_t *hc)
+static void hap_notif_unlock(bool in_isr)
 {
-    int ret;
-    if (!hap_event_queue) {
-        return HAP_FAIL;
+    if (in_isr) {
+        portEXIT_CRITICAL_ISR(&hap_notif_mux);
+    } else {
+        portEXIT_CRITICAL(&hap_notif_mux);
+    }
+}
+
+void hap_notif_stats_add(uint32_t sent, uint32_t dropped)
+{
+    bool in_isr = (xPortInIsrContext() == pdTRUE);
+    hap_notif_lock(in_isr);
+    hap_priv.notif_stats.sent += sent;
+    hap_priv.notif_stats.dropped += dropped;
+    hap_notif_unlock(in_isr);
+}
+
+/* Time (in msec) at which the notification timer is due to fire, if it is running */
+static uint32_t hap_notif_deadline;
+
+/* Send the pending notifications after the given delay. If the timer is already
+ * running and fires earlier, the notifications will anyways be sent then. If it
+ * fires later, it is pulled in, so that a rate limited characteristic cannot hold
+ * back the notifications of other characteristics.
+ */
+static void hap_schedule_notif(uint32_t delay_ms)
+{
+    uint32_t deadline = esp_timer_get_time() / 1000 + delay_ms;
+    if ((xTimerIsTimerActive(hap_priv.notif_timer) != pdFALSE)
+            && ((int32_t)(deadline - hap_notif_deadline) >= 0)) {
+        return;
     }
-    if (xPortInIsrContext() == pdTRUE) {
-        ret = xQueueSendFromISR(hap_event_queue, &hc, NULL);
+    hap_notif_deadline = deadline;
+    TickType_t ticks = delay_ms / hap_platform_os_get_msec_per_tick();
+    /* Changing the period also (re)starts the timer */
+    xTimerChangePeriod(hap_priv.notif_timer, ticks ? ticks : 1, 0);
+}
+
+void hap_handle_notif_trigger()
+{
+    if (hap_priv.cfg.notif_batch_window) {
+        hap_schedule_notif(hap_priv.cfg.notif_batch_window);
     } else {
-        ret = xQueueSend(hap_event_queue, &hc, 0);
+        hap_notif_timer_cb(hap_priv.notif_timer);
+    }
+}
+
+/* Characteristics with notifications pending, in the order in which they became
+ * pending. Guarded by hap_notif_mux, along with their notif_pending flags.
+ */
+static __hap_char_t *hap_notif_head;
+static __hap_char_t *hap_notif_tail;
+
+/* Must be called with hap_notif_mux held */
+static void hap_notif_list_append(__hap_char_t *_hc)
+{
+    _hc->next_pending = NULL;
+    if (hap_notif_tail) {
+        hap_notif_tail->next_pending = (hap_char_t *)_hc;
+    } else {
+        hap_notif_head = _hc;
+    }
+    hap_notif_tail = _hc;
+}
+
+/* Must be called with hap_notif_mux held. Returns true if the characteristic
+ * was found in the list and removed.
+ */
+static bool hap_notif_list_remove(__hap_char_t *_hc)
+{
+    __hap_char_t *prev = NULL;
+    __hap_char_t *cur;
+    for (cur = hap_notif_head; cur; prev = cur, cur = (__hap_char_t *)cur->next_pending) {
+        if (cur != _hc) {
+            continue;
+        }
+        if (prev) {
+            prev->next_pending = cur->next_pending;
+        } else {
+            hap_notif_head = (__hap_char_t *)cur->next_pending;
+        }
+        if (hap_notif_tail == cur) {
+            hap_notif_tail = prev;
+        }
+        cur->next_pending = NULL;
+        cur->notif_pending = false;
+        return true;
+    }
+    return false;
+}
+
+/* Collect upto max_cnt characteristics which have notifications pending.
+ * Characteristics which have been notified within their minimum notification
+ * interval are left pending and the notification is re-scheduled for them.
+ * Only the pending list is walked, not the whole accessory database.
+ */
+int hap_get_pending_notif_chars(hap_char_t **char_arr, int max_cnt)
+{
+    /* Take the whole list, so that characteristics which become pending while
+     * this runs are appended to a fresh list and handled in the next round.
+     * The ones taken stay flagged, so that their changes are coalesced.
+     */
+    hap_notif_lock(false);
+    __hap_char_t *list = hap_notif_head;
+    hap_notif_head = hap_notif_tail = NULL;
+    hap_notif_unlock(false);
+    if (!list) {
+        return 0;
+    }
+
+    uint32_t cur_time = esp_timer_get_time() / 1000;
+    uint32_t next_delay = UINT32_MAX;
+    bool more_pending = false;
+    int cnt = 0;
+    __hap_char_t *keep_head = NULL, *keep_tail = NULL;
+    while (list) {
+        __hap_char_t *_hc = list;
+        list = (__hap_char_t *)_hc->next_pending;
+        _hc->next_pending = NULL;
+        if (cnt == max_cnt) {
+            more_pending = true;
+        } else {
+            uint32_t elapsed = cur_time - _hc->last_notif_time;
+            if (!_hc->min_notif_interval || (elapsed >= _hc->min_notif_interval)) {
+                hap_notif_lock(false);
+                _hc->notif_pending = false;
+                hap_notif_unlock(false);
+                _hc->last_notif_time = cur_time;
+                char_arr[cnt++] = (hap_char_t *)_hc;
+                continue;
+            }
+            if ((_hc->min_notif_interval - elapsed) < next_delay) {
+                next_delay = _hc->min_notif_interval - elapsed;
+            }
+        }
+        /* Still pending. Put it back, ahead of the ones added meanwhile */
+        if (keep_tail) {
+            keep_tail->next_pending = (hap_char_t *)_hc;
+        } else {
+            keep_head = _hc;
+        }
+        keep_tail = _hc;
+    }
+    if (keep_head) {
+        hap_notif_lock(false);
+        keep_tail->next_pending = (hap_char_t *)hap_notif_head;
+        if (!hap_notif_head) {
+            hap_notif_tail = keep_tail;
+        }
+        hap_notif_head = keep_head;
+        hap_notif_unlock(false);
     }
-    if (ret == pdTRUE) {
-        hap_send_event(HAP_INTERNAL_EVENT_TRIGGER_NOTIF);
+    if (more_pending) {
+        /* Send the remaining ones in the next notification */
+        hap_http_send_notif();
+    } else if (next_delay != UINT32_MAX) {
+        hap_schedule_notif(next_delay);
+    }
+    return cnt;
+}
+
+/* Drop all pending notifications, when they cannot be sent. Clearing the flags
+ * lets the next value change of each characteristic trigger a notification again.
+ */
+void hap_drop_pending_notif_chars()
+{
+    hap_notif_lock(false);
+    while (hap_notif_head) {
+        __hap_char_t *_hc = hap_notif_head;
+        hap_notif_head = (__hap_char_t *)_hc->next_pending;
+        _hc->next_pending = NULL;
+        _hc->notif_pending = false;
+        hap_priv.notif_stats.dropped++;
+    }
+    hap_notif_tail = NULL;
+    hap_notif_unlock(false);
+}
+
+/* Remove a characteristic which is being deleted from the pending list */
+static void hap_notif_cancel(__hap_char_t *_hc)
+{
+    hap_notif_lock(false);
+    if (_hc->notif_pending) {
+        hap_notif_list_remove(_hc);
+    }
+    hap_notif_unlock(false);
+}
+
+static int hap_queue_event(hap_char_t *hc)
+{
+    __hap_char_t *_hc = (__hap_char_t *)hc;
+    if (!hap_priv.notif_timer) {
+        return HAP_FAIL;
+    }
+    bool in_isr = (xPortInIsrContext() == pdTRUE);
+    hap_notif_lock(in_isr);
+    /* If a notification is already pending, it will anyways carry the latest value */
+    if (_hc->notif_pending) {
+        hap_priv.notif_stats.coalesced++;
+        hap_notif_unlock(in_isr);
         return HAP_SUCCESS;
     }
-    return HAP_FAIL;
+    _hc->notif_pending = true;
+    hap_notif_list_append(_hc);
+    hap_notif_unlock(in_isr);
+    if (hap_send_event(HAP_INTERNAL_EVENT_TRIGGER_NOTIF) != HAP_SUCCESS) {
+        /* Remove it, so that the next value change triggers the notification again.
+         * If it is no longer in the list, a notification in progress has taken it.
+         */
+        hap_notif_lock(in_isr);
+        if (hap_notif_list_remove(_hc)) {
+            hap_priv.notif_stats.dropped++;
+        }
+        hap_notif_unlock(in_isr);
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
 }
 
+void hap_char_set_min_notif_interval(hap_char_t *hc, uint32_t interval_ms)
+{
+    if (hc) {
+        ((__hap_char_t *)hc)->min_notif_interval = interval_ms;
+    }
+}
+
+int hap_get_notif_stats(hap_notif_stats_t *stats)
+{
+    if (!stats) {
+        return HAP_FAIL;
+    }
+    hap_notif_lock(false);
+    *stats = hap_priv.notif_stats;
+    hap_notif_unlock(false);
+    return HAP_SUCCESS;
+}
 
 /**
  * @brief check if characteristics value is at the range
  */
 int hap_char_check_val_constraints(__hap_char_t *_hc, hap_val_t *val)
 {
-    if (!_hc->constraint_flags)
+    if (!(_hc->constraint_flags & (HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG)))
         return HAP_SUCCESS;
+    const hap_char_meta_t *meta = _hc->meta;
 
     if (_hc->format == HAP_CHAR_FORMAT_INT) {
         int value = val->i;
         int remainder;
 
-        if (value > _hc->max.i
-            || value < _hc->min.i)
+        if (value > meta->max.i
+            || value < meta->min.i)
             return HAP_FAIL;
 
-        if (!_hc->step.i)
+        if (!meta->step.i)
             return HAP_SUCCESS;
 
-        remainder = (value - _hc->min.i) % _hc->step.i;
+        remainder = (value - meta->min.i) % meta->step.i;
         if (remainder)
             return HAP_FAIL;
     } else if (_hc->format == HAP_CHAR_FORMAT_FLOAT) {
         float value = val->f;
 
-        if (value > _hc->max.f
-            || value < _hc->min.f)
+        if (value > meta->max.f
+            || value < meta->min.f)
             return HAP_FAIL;
 # if 0
         /* Check for step value for floats has a high chance of failure,
          * because of precision issues. Hence, better to skip it.
          */
         double remainder;
-        if (_hc->step.f == 0.0)
+        if (meta->step.f == 0.0)
             return HAP_SUCCESS;
 
-        remainder = esp_mfi_fmod(value - _hc->min.f, _hc->step.f);
+        remainder = esp_mfi_fmod(value - meta->min.f, meta->step.f);
         if (remainder != 0.0)
             return HAP_FAIL;
 #endif
@@ -153,14 +386,14 @@ int hap_char_check_val_constraints(__hap_char_t *_hc, hap_val_t *val)
         uint32_t remainder;
 
 
-        if (value > _hc->max.u
-            || value < _hc->min.u)
+        if (value > meta->max.u
+            || value < meta->min.u)
             return HAP_FAIL;
 
-        if (!_hc->step.u)
+        if (!meta->step.u)
             return HAP_SUCCESS;
 
-        remainder = (value - _hc->min.u) % _hc->step.u;
+        remainder = (value - meta->min.u) % meta->step.u;
         if (remainder)
             return HAP_FAIL;
     } else if (_hc->format == HAP_CHAR_FORMAT_UINT64) {
@@ -226,7 +459,7 @@ int hap_char_update_val(hap_char_t *hc, hap_val_t *val)
 				value_changed = true;
 
 			if (_hc->val.s) {
-				hap_platform_memory_free(_hc->val.s);
+				hap_db_free(_hc->val.s);
                 _hc->val.s = NULL;
             }
 
@@ -274,7 +507,7 @@ const hap_val_t *hap_char_get_min_val(hap_char_t *hc)
 {
     if (hc) {
         if(((__hap_char_t *)hc)->constraint_flags & HAP_CHAR_MIN_FLAG) {
-            return &((__hap_char_t *)hc)->min;
+            return &((__hap_char_t *)hc)->meta->min;
         }
     }
     return NULL;
@@ -287,7 +520,7 @@ const hap_val_t *hap_char_get_max_val(hap_char_t *hc)
 {
     if (hc) {
         if(((__hap_char_t *)hc)->constraint_flags & HAP_CHAR_MAX_FLAG || ((__hap_char_t *)hc)->constraint_flags & HAP_CHAR_MAXLEN_FLAG) {
-            return &((__hap_char_t *)hc)->max;
+            return &((__hap_char_t *)hc)->meta->max;
         }
     }
     return NULL;
@@ -300,7 +533,7 @@ const hap_val_t *hap_char_get_step_val(hap_char_t *hc)
 {
     if (hc) {
         if (((__hap_char_t *)hc)->constraint_flags & HAP_CHAR_STEP_FLAG) {
-            return &((__hap_char_t *)hc)->step;
+            return &((__hap_char_t *)hc)->meta->step;
         }
     }
     return NULL;
@@ -320,13 +553,23 @@ static hap_char_t *hap_char_create(char *type_uuid, uint32_t permission, hap_cha
             return NULL;
     }
 
-    new_ch = hap_platform_memory_calloc(1, sizeof(__hap_char_t));
+    /* Lookups by UUID compare type IDs, so a characteristic without one
+     * could never be found
+     */
+    hap_type_id_t type_id = hap_type_id_get(type_uuid);
+    if (type_id == HAP_TYPE_ID_INVALID) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to get type ID for characteristic %s", type_uuid);
+        return NULL;
+    }
+
+    new_ch = hap_db_calloc(1, sizeof(__hap_char_t));
     if (!new_ch) {
         return NULL;
     }
 
     new_ch->val = val;
     new_ch->type_uuid = type_uuid;
+    new_ch->type_id = type_id;
     new_ch->format = format;
     new_ch->permission = permission;
 
@@ -372,7 +615,7 @@ hap_char_t *hap_char_string_create(char *type_uuid, uint16_t perms, char *s)
 {
     hap_val_t val;
     if (s)
-        val.s = strdup(s);
+        val.s = hap_db_strdup(s);
     else
         val.s = NULL;
     return hap_char_create(type_uuid, perms, HAP_CHAR_FORMAT_STRING, val);
@@ -396,6 +639,33 @@ hap_char_t *hap_char_tlv8_create(char *type_uuid, uint16_t perms, hap_tlv8_val_t
     return hap_char_create(type_uuid, perms, HAP_CHAR_FORMAT_TLV8, val);
 }
 
+hap_char_t *hap_char_create_from_desc(const hap_char_desc_t *desc, hap_val_t val)
+{
+    if (!desc) {
+        return NULL;
+    }
+    if (desc->format == HAP_CHAR_FORMAT_STRING && val.s) {
+        val.s = hap_db_strdup(val.s);
+        if (!val.s) {
+            return NULL;
+        }
+    }
+    __hap_char_t *_hc = (__hap_char_t *)hap_char_create((char *)desc->type_uuid,
+            desc->perms, desc->format, val);
+    if (!_hc) {
+        if (desc->format == HAP_CHAR_FORMAT_STRING && val.s) {
+            hap_db_free(val.s);
+        }
+        return NULL;
+    }
+    if (desc->constraint_flags || desc->meta.description || desc->meta.unit
+            || desc->meta.valid_vals) {
+        _hc->meta = &desc->meta;
+        _hc->constraint_flags = desc->constraint_flags;
+    }
+    return (hap_char_t *)_hc;
+}
+
 /**
  * @brief HAP get target characteristics IID
  */
@@ -418,6 +688,14 @@ const char * hap_char_get_type_uuid(hap_char_t *hc)
     return tmp->type_uuid;
 }
 
+hap_type_id_t hap_char_get_type_id(hap_char_t *hc)
+{
+    if (!hc)
+        return HAP_TYPE_ID_INVALID;
+
+    return ((__hap_char_t *)hc)->type_id;
+}
+
 uint16_t hap_char_get_perm(hap_char_t *hc)
 {
     if (!hc)
@@ -443,18 +721,55 @@ void hap_char_delete(hap_char_t *hc)
 {
     ESP_MFI_ASSERT(hc);
     __hap_char_t *_hc = (__hap_char_t *)hc;
+    hap_notif_cancel(_hc);
     if (_hc->format == HAP_CHAR_FORMAT_STRING) {
         if (_hc->val.s) {
-            hap_platform_memory_free(_hc->val.s);
+            hap_db_free(_hc->val.s);
         }
     }
-    if (_hc->valid_vals) {
-        hap_platform_memory_free(_hc->valid_vals);
+    if (_hc->valid_vals_owned) {
+        hap_db_free((void *)_hc->meta->valid_vals);
+    }
+    if (_hc->meta_owned) {
+        hap_db_free((void *)_hc->meta);
     }
-    if (_hc->valid_vals_range) {
-        hap_platform_memory_free(_hc->valid_vals_range);
+#ifdef CONFIG_HAP_ACC_DB_CACHE_ENABLE
+    if (_hc->db_json) {
+        hap_platform_memory_free(_hc->db_json);
     }
-    hap_platform_memory_free(_hc);
+#endif /* CONFIG_HAP_ACC_DB_CACHE_ENABLE */
+    hap_db_free(_hc);
+}
+
+/* Mark the cached /accessories JSON of a characteristic as stale, so that it gets
+ * regenerated on the next read. Required whenever any of its metadata changes.
+ */
+void hap_char_db_cache_invalidate(__hap_char_t *_hc)
+{
+#ifdef CONFIG_HAP_ACC_DB_CACHE_ENABLE
+    _hc->db_json_gen = 0;
+#endif /* CONFIG_HAP_ACC_DB_CACHE_ENABLE */
+}
+
+/* Get a modifiable constraints and metadata record of a characteristic. It is
+ * allocated on first use, and copied if it still points into a constant descriptor.
+ */
+static hap_char_meta_t *hap_char_get_meta(__hap_char_t *_hc)
+{
+    if (!_hc->meta_owned) {
+        hap_char_meta_t *meta = hap_db_calloc(1, sizeof(hap_char_meta_t));
+        if (!meta) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to allocate metadata for characteristic %s",
+                    _hc->type_uuid);
+            return NULL;
+        }
+        if (_hc->meta) {
+            *meta = *_hc->meta;
+        }
+        _hc->meta = meta;
+        _hc->meta_owned = true;
+    }
+    return (hap_char_meta_t *)_hc->meta;
 }
 
 /**
@@ -464,27 +779,37 @@ void hap_char_int_set_constraints(hap_char_t *hc, int min, int max, int step)
 {
     ESP_MFI_ASSERT(hc);
     __hap_char_t *tmp = (__hap_char_t *)hc;
-    tmp->min.i = min;
-    tmp->max.i = max;
-    tmp->step.i = step;
+    hap_char_meta_t *meta = hap_char_get_meta(tmp);
+    if (!meta) {
+        return;
+    }
+    meta->min.i = min;
+    meta->max.i = max;
+    meta->step.i = step;
     if (step) {
         tmp->constraint_flags |= (HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG | HAP_CHAR_STEP_FLAG);
     } else {
         tmp->constraint_flags |= (HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG);
     }
+    hap_char_db_cache_invalidate(tmp);
 }
 void hap_char_float_set_constraints(hap_char_t *hc, float min, float max, float step)
 {
     ESP_MFI_ASSERT(hc);
     __hap_char_t *tmp = (__hap_char_t *)hc;
-    tmp->min.f = min;
-    tmp->max.f = max;
-    tmp->step.f = step;
+    hap_char_meta_t *meta = hap_char_get_meta(tmp);
+    if (!meta) {
+        return;
+    }
+    meta->min.f = min;
+    meta->max.f = max;
+    meta->step.f = step;
     if (step) {
         tmp->constraint_flags |= (HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG | HAP_CHAR_STEP_FLAG);
     } else {
         tmp->constraint_flags |= (HAP_CHAR_MIN_FLAG | HAP_CHAR_MAX_FLAG);
     }
+    hap_char_db_cache_invalidate(tmp);
 }
 
 void hap_char_string_set_maxlen(hap_char_t *hc, int maxlen)
@@ -495,21 +820,36 @@ void hap_char_string_set_maxlen(hap_char_t *hc, int maxlen)
         maxlen = HAP_CHAR_STRING_MAX_LEN;
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "Characteristic string length larger than maximum value(%d), falling back to the maximum value.", HAP_CHAR_STRING_MAX_LEN);
     }
-    tmp->max.i = maxlen;
+    hap_char_meta_t *meta = hap_char_get_meta(tmp);
+    if (!meta) {
+        return;
+    }
+    meta->max.i = maxlen;
     tmp->constraint_flags |= HAP_CHAR_MAXLEN_FLAG;
+    hap_char_db_cache_invalidate(tmp);
 }
 
 void hap_char_add_description(hap_char_t *hc, const char *description)
 {
     ESP_MFI_ASSERT(hc);
     __hap_char_t *tmp = (__hap_char_t *)hc;
-    tmp->description = (char *)description;
+    hap_char_meta_t *meta = hap_char_get_meta(tmp);
+    if (!meta) {
+        return;
+    }
+    meta->description = description;
+    hap_char_db_cache_invalidate(tmp);
 }
 void hap_char_add_unit(hap_char_t *hc, const char *unit)
 {
     ESP_MFI_ASSERT(hc);
     __hap_char_t *tmp = (__hap_char_t *)hc;
-    tmp->unit = (char *)unit;
+    hap_char_meta_t *meta = hap_char_get_meta(tmp);
+    if (!meta) {
+        return;
+    }
+    meta->unit = unit;
+    hap_char_db_cache_invalidate(tmp);
 }
 hap_char_t *hap_char_get_next(hap_char_t *hc)
 {
@@ -556,6 +896,7 @@ void hap_char_set_iid(hap_char_t *hc, int32_t iid)
 {
     if (hc) {
         ((__hap_char_t *)hc)->iid = iid;
+        hap_acc_char_index_invalidate();
     }
 }
 
@@ -581,11 +922,23 @@ void hap_char_add_valid_vals(hap_char_t *hc, const uint8_t *valid_vals, size_t v
     if (!hc)
         return;
     __hap_char_t *_hc = (__hap_char_t *)hc;
-    _hc->valid_vals = hap_platform_memory_malloc(valid_val_cnt);
-    if (_hc->valid_vals) {
-        memcpy(_hc->valid_vals, valid_vals, valid_val_cnt);
-        _hc->valid_vals_cnt = valid_val_cnt;
+    hap_char_meta_t *meta = hap_char_get_meta(_hc);
+    if (!meta) {
+        return;
+    }
+    if (_hc->valid_vals_owned) {
+        hap_db_free((void *)meta->valid_vals);
     }
+    meta->valid_vals_cnt = 0;
+    _hc->valid_vals_owned = false;
+    uint8_t *vals = hap_db_malloc(valid_val_cnt);
+    if (vals) {
+        memcpy(vals, valid_vals, valid_val_cnt);
+        meta->valid_vals_cnt = valid_val_cnt;
+        _hc->valid_vals_owned = true;
+    }
+    meta->valid_vals = vals;
+    hap_char_db_cache_invalidate(_hc);
 }
 
 void hap_char_add_valid_vals_range(hap_char_t *hc, uint8_t start_val, uint8_t end_val)
@@ -593,9 +946,12 @@ void hap_char_add_valid_vals_range(hap_char_t *hc, uint8_t start_val, uint8_t en
     if (!hc)
         return;
     __hap_char_t *_hc = (__hap_char_t *)hc;
-    _hc->valid_vals_range = hap_platform_memory_malloc(sizeof(uint8_t));
-    if (_hc->valid_vals_range) {
-        _hc->valid_vals_range[0] = start_val;
-        _hc->valid_vals_range[1] = end_val;
+    hap_char_meta_t *meta = hap_char_get_meta(_hc);
+    if (!meta) {
+        return;
     }
+    meta->valid_vals_range[0] = start_val;
+    meta->valid_vals_range[1] = end_val;
+    _hc->constraint_flags |= HAP_CHAR_VALID_RANGE_FLAG;
+    hap_char_db_cache_invalidate(_hc);
 }
@@ -25,6 +25,8 @@
 #include <string.h>
 #include <hap.h>
 #include <esp_mfi_debug.h>
+#include <esp_timer.h>
+#include <hap_platform_memory.h>
 
 #include <esp_hap_main.h>
 #include <esp_hap_database.h>
@@ -33,15 +35,122 @@
 #include <esp_hap_pair_setup.h>
 
 #define HAP_KEYSTORE_NAMESPACE_CTRL "hap_ctrl"
+/* All controllers are stored as a single blob under this key. Older
+ * firmware used one key per controller, named "0".."15", which are
+ * migrated on first boot.
+ */
+#define HAP_KEYSTORE_KEY_CTRL_TABLE "ctrl_tbl"
+#define HAP_CTRL_TABLE_VERSION      1
 
-int hap_controllers_init()
+typedef struct {
+    uint8_t version;
+    uint8_t count;
+    uint16_t reserved;
+    uint32_t crc;       /* CRC-32 of the entries which follow */
+} __attribute__((packed)) hap_ctrl_table_hdr_t;
+
+typedef struct {
+    uint8_t index;
+    hap_ctrl_info_t info;
+} __attribute__((packed)) hap_ctrl_table_entry_t;
+
+#define HAP_CTRL_TABLE_MAX_SIZE (sizeof(hap_ctrl_table_hdr_t) + \
+        HAP_MAX_CONTROLLERS * sizeof(hap_ctrl_table_entry_t))
+
+static uint32_t hap_ctrl_table_crc(const uint8_t *buf, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    size_t i;
+    int j;
+    for (i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+/* Writes the controller table as it would look after "ctrl_data" is stored
+ * with the given info, or removed (info = NULL). The in-memory table is not
+ * touched, so that it stays consistent with the flash if the write fails.
+ * Passing NULL for ctrl_data writes the current table.
+ */
+static int hap_ctrl_table_write(const hap_ctrl_data_t *ctrl_data, const hap_ctrl_info_t *info)
+{
+    uint8_t *buf = hap_platform_memory_calloc(1, HAP_CTRL_TABLE_MAX_SIZE);
+    if (!buf) {
+        return HAP_FAIL;
+    }
+    hap_ctrl_table_hdr_t *hdr = (hap_ctrl_table_hdr_t *)buf;
+    hap_ctrl_table_entry_t *entry = (hap_ctrl_table_entry_t *)(buf + sizeof(hap_ctrl_table_hdr_t));
+    int i;
+    for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
+        const hap_ctrl_data_t *ctrl = &hap_priv.controllers[i];
+        const hap_ctrl_info_t *ctrl_info = (ctrl == ctrl_data) ? info : (ctrl->valid ? &ctrl->info : NULL);
+        if (ctrl_info) {
+            entry[hdr->count].index = i;
+            memcpy(&entry[hdr->count].info, ctrl_info, sizeof(hap_ctrl_info_t));
+            hdr->count++;
+        }
+    }
+    size_t len = hdr->count * sizeof(hap_ctrl_table_entry_t);
+    hdr->version = HAP_CTRL_TABLE_VERSION;
+    hdr->crc = hap_ctrl_table_crc((uint8_t *)entry, len);
+    int ret = hap_keystore_set(HAP_KEYSTORE_NAMESPACE_CTRL, HAP_KEYSTORE_KEY_CTRL_TABLE,
+            buf, sizeof(hap_ctrl_table_hdr_t) + len);
+    hap_platform_memory_free(buf);
+    return ret;
+}
+
+static int hap_ctrl_table_read(void)
+{
+    size_t size = HAP_CTRL_TABLE_MAX_SIZE;
+    uint8_t *buf = hap_platform_memory_calloc(1, size);
+    if (!buf) {
+        return HAP_FAIL;
+    }
+    int ret = HAP_FAIL;
+    if (hap_keystore_get(HAP_KEYSTORE_NAMESPACE_CTRL, HAP_KEYSTORE_KEY_CTRL_TABLE,
+                buf, &size) != HAP_SUCCESS) {
+        goto read_end;
+    }
+    hap_ctrl_table_hdr_t *hdr = (hap_ctrl_table_hdr_t *)buf;
+    hap_ctrl_table_entry_t *entry = (hap_ctrl_table_entry_t *)(buf + sizeof(hap_ctrl_table_hdr_t));
+    size_t len = hdr->count * sizeof(hap_ctrl_table_entry_t);
+    if ((size < sizeof(hap_ctrl_table_hdr_t)) || (hdr->version != HAP_CTRL_TABLE_VERSION)
+            || (hdr->count > HAP_MAX_CONTROLLERS)
+            || (size != sizeof(hap_ctrl_table_hdr_t) + len)
+            || (hdr->crc != hap_ctrl_table_crc((uint8_t *)entry, len))) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Controller table corrupted");
+        goto read_end;
+    }
+    int i;
+    for (i = 0; i < hdr->count; i++) {
+        uint8_t index = entry[i].index;
+        if (index >= HAP_MAX_CONTROLLERS || hap_priv.controllers[index].valid) {
+            continue;
+        }
+        memcpy(&hap_priv.controllers[index].info, &entry[i].info, sizeof(hap_ctrl_info_t));
+        hap_priv.controllers[index].index = index;
+        hap_priv.controllers[index].valid = true;
+    }
+    ret = HAP_SUCCESS;
+read_end:
+    hap_platform_memory_free(buf);
+    return ret;
+}
+
+/* Moves controllers stored by older firmware, one key per controller,
+ * to the single blob table.
+ */
+static void hap_ctrl_table_migrate(void)
 {
-	memset(hap_priv.controllers, 0, sizeof(hap_priv.controllers));
     char index_str[4];
-    uint8_t i;
     size_t info_size;
-    bool acc_paired = false;
-	for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
+    bool found = false;
+    uint8_t i;
+    for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
         snprintf(index_str, sizeof(index_str), "%d", i);
         info_size = sizeof(hap_ctrl_info_t);
         if (hap_keystore_get(HAP_KEYSTORE_NAMESPACE_CTRL, index_str,
@@ -49,11 +158,49 @@ int hap_controllers_init()
             if (info_size == sizeof(hap_ctrl_info_t)) {
                 hap_priv.controllers[i].index = i;
                 hap_priv.controllers[i].valid = true;
-                acc_paired = true;
+                found = true;
             }
         }
     }
-    if (acc_paired) {
+    /* Write the table even if there was nothing to migrate, so that the next
+     * boot finds it with a single read, rather than probing all the old keys.
+     * Delete the old keys only once the table is safely written.
+     */
+    if (hap_ctrl_table_write(NULL, NULL) != HAP_SUCCESS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to migrate controller table");
+        return;
+    }
+    /* A leftover key is harmless as long as the table exists, which is why
+     * hap_controller_remove_all() writes an empty table instead of deleting it.
+     */
+    for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
+        if (!hap_priv.controllers[i].valid) {
+            continue;
+        }
+        snprintf(index_str, sizeof(index_str), "%d", i);
+        if (hap_keystore_delete(HAP_KEYSTORE_NAMESPACE_CTRL, index_str) != HAP_SUCCESS) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to delete old controller key %s", index_str);
+        }
+    }
+    if (found) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Migrated controllers to single table");
+    }
+}
+
+int hap_controllers_init()
+{
+    uint8_t i;
+    int64_t start = esp_timer_get_time();
+	for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
+        hap_ed25519_pk_free(hap_priv.controllers[i].ltpk_cache);
+    }
+	memset(hap_priv.controllers, 0, sizeof(hap_priv.controllers));
+    if (hap_ctrl_table_read() != HAP_SUCCESS) {
+        hap_ctrl_table_migrate();
+    }
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Loaded %d controller(s) in %d us",
+            hap_get_paired_controller_count(), (int)(esp_timer_get_time() - start));
+    if (is_accessory_paired()) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Accessory is Paired with atleast one controller");
     } else {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Accessory is not Paired with any controller");
@@ -107,16 +254,27 @@ bool is_admin_paired()
 
 int hap_controller_save(hap_ctrl_data_t *ctrl_data)
 {
+    if (hap_ctrl_table_write(ctrl_data, &ctrl_data->info) != HAP_SUCCESS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to store controller %d", ctrl_data->index);
+        return HAP_FAIL;
+    }
 	ctrl_data->valid = true;
-    char index_str[4];
-    snprintf(index_str, sizeof(index_str), "%d", ctrl_data->index);
-    int ret = hap_keystore_set(HAP_KEYSTORE_NAMESPACE_CTRL, index_str,
-            (const uint8_t *)&ctrl_data->info, (size_t)sizeof(hap_ctrl_info_t));
+    hap_report_event(HAP_EVENT_CTRL_PAIRED, ctrl_data->info.id, sizeof(ctrl_data->info.id));
+    return HAP_SUCCESS;
+}
 
-    if (ret != HAP_SUCCESS) {
+/* Changes the permissions of an existing controller. The live entry is updated
+ * only after the new table is stored, so that it never differs from the flash.
+ */
+int hap_controller_set_perms(hap_ctrl_data_t *ctrl_data, uint8_t perms)
+{
+    hap_ctrl_info_t info = ctrl_data->info;
+    info.perms = perms;
+    if (hap_ctrl_table_write(ctrl_data, &info) != HAP_SUCCESS) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to store controller %d", ctrl_data->index);
         return HAP_FAIL;
     }
+    ctrl_data->info.perms = perms;
     hap_report_event(HAP_EVENT_CTRL_PAIRED, ctrl_data->info.id, sizeof(ctrl_data->info.id));
     return HAP_SUCCESS;
 }
@@ -125,15 +283,53 @@ void hap_controller_remove(hap_ctrl_data_t *ctrl_data)
 {
 	if (!ctrl_data)
         return;
-    char index_str[4];
-    snprintf(index_str, sizeof(index_str), "%d", ctrl_data->index);
     char id[HAP_CTRL_ID_LEN];
     strncpy(id, ctrl_data->info.id, sizeof(id));
-    hap_keystore_delete(HAP_KEYSTORE_NAMESPACE_CTRL, index_str);
+    if (hap_ctrl_table_write(ctrl_data, NULL) != HAP_SUCCESS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to remove controller %d", ctrl_data->index);
+    }
+    hap_ed25519_pk_free(ctrl_data->ltpk_cache);
     memset(ctrl_data, 0, sizeof(hap_ctrl_data_t));
     hap_report_event(HAP_EVENT_CTRL_UNPAIRED, id, sizeof(id));
 }
 
+/* Removes all controllers with a single flash write. An empty table is
+ * written rather than deleting it, so that the next boot does not migrate
+ * controllers from any old per-controller keys left behind.
+ */
+void hap_controller_remove_all()
+{
+    int i;
+	for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
+        hap_ctrl_data_t *ctrl_data = &hap_priv.controllers[i];
+		if (!ctrl_data->valid) {
+            continue;
+        }
+        char id[HAP_CTRL_ID_LEN];
+        strncpy(id, ctrl_data->info.id, sizeof(id));
+        hap_ed25519_pk_free(ctrl_data->ltpk_cache);
+        memset(ctrl_data, 0, sizeof(hap_ctrl_data_t));
+        hap_report_event(HAP_EVENT_CTRL_UNPAIRED, id, sizeof(id));
+    }
+    /* All entries are invalid now, so this writes an empty table */
+    if (hap_ctrl_table_write(NULL, NULL) != HAP_SUCCESS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to remove all controllers");
+    }
+}
+
+/* Verifies a signature made with the controller's long term key.
+ * The key is decoded on first use and kept, since the same controller
+ * typically reconnects many times.
+ */
+int hap_controller_verify_sign(hap_ctrl_data_t *ctrl_data, const uint8_t *sign,
+        const uint8_t *data, size_t data_len)
+{
+    if (!ctrl_data->ltpk_cache) {
+        ctrl_data->ltpk_cache = hap_ed25519_pk_decode(ctrl_data->info.ltpk);
+    }
+    return hap_ed25519_verify(sign, data, data_len, ctrl_data->info.ltpk, ctrl_data->ltpk_cache);
+}
+
 hap_ctrl_data_t *hap_get_controller(char *ctrl_id)
 {
 	int i;
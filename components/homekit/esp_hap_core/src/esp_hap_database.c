@@ -54,6 +54,7 @@
 #define HAP_LOOP_STACK              (4 * 1024)
 #define HAP_MAIN_THREAD_PRIORITY    7
 #define HAP_MAX_NOTIF_CHARS         8
+#define HAP_WRITE_COMPLETE_TIMEOUT  5000
 #define HAP_SOCK_RECV_TIMEOUT       10
 #define HAP_SOCK_SEND_TIMEOUT       10
 
@@ -66,6 +67,8 @@ hap_priv_t hap_priv = {
         .recv_timeout = HAP_SOCK_RECV_TIMEOUT,
         .send_timeout = HAP_SOCK_SEND_TIMEOUT,
         .sw_token_max_len = HAP_SW_TOKEN_MAX_LEN,
+        .loop_queue_size = HAP_LOOP_QUEUE_SIZE,
+        .write_complete_timeout = HAP_WRITE_COMPLETE_TIMEOUT,
     }
 };
 
@@ -100,9 +103,12 @@ void hap_increment_and_save_config_num()
 }
 
 
+/* The state number changes on every mDNS re-announce, so it is written in a
+ * batch, to save flash writes.
+ */
 static void hap_save_state_number()
 {
-    hap_keystore_set(HAP_KEYSTORE_NAMESPACE_HAPMAIN, HAP_KEY_STATE_NUM,
+    hap_keystore_set_deferred(HAP_KEYSTORE_NAMESPACE_HAPMAIN, HAP_KEY_STATE_NUM,
             (uint8_t *)&hap_priv.state_num, sizeof(hap_priv.state_num));
 }
 
@@ -133,8 +139,18 @@ static void hap_init_state_number()
     } else {
         hap_increment_and_save_state_num();
     }
+    /* Write the boot time increment right away, so that each boot starts
+     * from a persisted number. A runtime increment that was still pending
+     * when power was lost is not persisted, so the number it used can be
+     * seen again after the next boot.
+     */
+    hap_keystore_flush();
 }
 
+/* The AID is written right away, like the id to AID mapping stored along
+ * with it in hap_get_unique_aid(). A deferred write lost in a power cut would
+ * hand out an AID that is already in use.
+ */
 static void hap_save_cur_aid()
 {
     hap_keystore_set(HAP_KEYSTORE_NAMESPACE_HAPMAIN, HAP_KEY_CUR_AID,
@@ -0,0 +1,176 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+#include <hap.h>
+#include <esp_mfi_debug.h>
+#include <hap_platform_memory.h>
+#include <esp_hap_db_arena.h>
+
+#define HAP_DB_ARENA_ALIGN          8
+#define HAP_DB_ARENA_ALIGN_SIZE(s)  (((s) + HAP_DB_ARENA_ALIGN - 1) & ~(HAP_DB_ARENA_ALIGN - 1))
+
+typedef struct hap_db_arena_chunk {
+    struct hap_db_arena_chunk *next;
+    size_t size;
+    size_t used;
+    /* Keeps the data aligned */
+    uint64_t data[0];
+} hap_db_arena_chunk_t;
+
+static struct {
+    bool active;
+    hap_db_arena_chunk_t *chunks;
+    hap_db_arena_stats_t stats;
+} hap_db_arena;
+
+int hap_db_arena_begin(void)
+{
+    if (hap_db_arena.active) {
+        return HAP_FAIL;
+    }
+    hap_db_arena.active = true;
+    return HAP_SUCCESS;
+}
+
+int hap_db_arena_commit(void)
+{
+    if (!hap_db_arena.active) {
+        return HAP_FAIL;
+    }
+    hap_db_arena.active = false;
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "DB arena: %d allocations, %d of %d bytes used in %d chunk(s)",
+            (int)hap_db_arena.stats.allocs, (int)hap_db_arena.stats.used,
+            (int)hap_db_arena.stats.size, (int)hap_db_arena.stats.chunks);
+    return HAP_SUCCESS;
+}
+
+void hap_db_arena_get_stats(hap_db_arena_stats_t *stats)
+{
+    if (stats) {
+        *stats = hap_db_arena.stats;
+    }
+}
+
+static hap_db_arena_chunk_t *hap_db_arena_add_chunk(size_t chunk_size)
+{
+    hap_db_arena_chunk_t *chunk = hap_platform_memory_malloc(sizeof(hap_db_arena_chunk_t) + chunk_size);
+    if (!chunk) {
+        return NULL;
+    }
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    hap_db_arena.stats.chunks++;
+    hap_db_arena.stats.size += chunk_size;
+    return chunk;
+}
+
+static void *hap_db_arena_alloc(size_t size)
+{
+    hap_db_arena_chunk_t *chunk;
+    size = HAP_DB_ARENA_ALIGN_SIZE(size);
+    if (size > CONFIG_HAP_DB_ARENA_CHUNK_SIZE) {
+        /* Oversized requests get a chunk of their own, which is kept behind the
+         * current chunk, so that the space left in that is not wasted.
+         */
+        chunk = hap_db_arena_add_chunk(size);
+        if (!chunk) {
+            return NULL;
+        }
+        if (hap_db_arena.chunks) {
+            chunk->next = hap_db_arena.chunks->next;
+            hap_db_arena.chunks->next = chunk;
+        } else {
+            chunk->next = NULL;
+            hap_db_arena.chunks = chunk;
+        }
+    } else {
+        chunk = hap_db_arena.chunks;
+        if (!chunk || (chunk->size - chunk->used) < size) {
+            chunk = hap_db_arena_add_chunk(CONFIG_HAP_DB_ARENA_CHUNK_SIZE);
+            if (!chunk) {
+                return NULL;
+            }
+            chunk->next = hap_db_arena.chunks;
+            hap_db_arena.chunks = chunk;
+        }
+    }
+    void *ptr = (uint8_t *)chunk->data + chunk->used;
+    chunk->used += size;
+    hap_db_arena.stats.allocs++;
+    hap_db_arena.stats.used += size;
+    return ptr;
+}
+
+static bool hap_db_arena_owns(const void *ptr)
+{
+    hap_db_arena_chunk_t *chunk;
+    for (chunk = hap_db_arena.chunks; chunk; chunk = chunk->next) {
+        if ((const uint8_t *)ptr >= (const uint8_t *)chunk->data
+                && (const uint8_t *)ptr < (const uint8_t *)chunk->data + chunk->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void *hap_db_malloc(size_t size)
+{
+    if (hap_db_arena.active) {
+        return hap_db_arena_alloc(size);
+    }
+    return hap_platform_memory_malloc(size);
+}
+
+void *hap_db_calloc(size_t count, size_t size)
+{
+    if (hap_db_arena.active) {
+        void *ptr = hap_db_arena_alloc(count * size);
+        if (ptr) {
+            memset(ptr, 0, count * size);
+        }
+        return ptr;
+    }
+    return hap_platform_memory_calloc(count, size);
+}
+
+char *hap_db_strdup(const char *s)
+{
+    if (hap_db_arena.active) {
+        size_t len = strlen(s) + 1;
+        char *ptr = hap_db_arena_alloc(len);
+        if (ptr) {
+            memcpy(ptr, s, len);
+        }
+        return ptr;
+    }
+    return strdup(s);
+}
+
+void hap_db_free(void *ptr)
+{
+    if (ptr && !hap_db_arena_owns(ptr)) {
+        hap_platform_memory_free(ptr);
+    }
+}
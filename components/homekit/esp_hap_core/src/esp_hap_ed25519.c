@@ -0,0 +1,128 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <sodium/crypto_sign_ed25519.h>
+#include <hap_platform_memory.h>
+
+#include <esp_hap_ed25519.h>
+
+/* Using a decoded key needs the Ed25519 group internals of libsodium.
+ * These are not a public API, so this is restricted to the version that has
+ * been checked against (1.0.18, library version 10.3), and the raw key is
+ * used otherwise.
+ */
+#ifdef CONFIG_HAP_CTRL_PK_CACHE_ENABLE
+#if defined(__has_include)
+#if __has_include(<sodium/private/ed25519_ref10.h>)
+#include <sodium/version.h>
+#if (SODIUM_LIBRARY_VERSION_MAJOR == 10) && (SODIUM_LIBRARY_VERSION_MINOR == 3)
+#define HAP_ED25519_DECODED_PK
+#endif
+#endif /* __has_include(<sodium/private/ed25519_ref10.h>) */
+#endif /* defined(__has_include) */
+#endif /* CONFIG_HAP_CTRL_PK_CACHE_ENABLE */
+
+#ifdef HAP_ED25519_DECODED_PK
+#include <sodium/crypto_hash_sha512.h>
+#include <sodium/crypto_verify_32.h>
+#include <sodium/utils.h>
+#include <sodium/private/ed25519_ref10.h>
+
+struct hap_ed25519_pk {
+    uint8_t pk[crypto_sign_ed25519_PUBLICKEYBYTES];
+    /* -A, as required by ge25519_double_scalarmult_vartime() */
+    ge25519_p3 neg_a;
+};
+
+hap_ed25519_pk_t *hap_ed25519_pk_decode(const uint8_t *pk)
+{
+    /* Same checks as done by crypto_sign_ed25519_verify_detached() for every signature */
+    if (ge25519_is_canonical(pk) == 0 || ge25519_has_small_order(pk) != 0) {
+        return NULL;
+    }
+    hap_ed25519_pk_t *dpk = hap_platform_memory_calloc(1, sizeof(hap_ed25519_pk_t));
+    if (!dpk) {
+        return NULL;
+    }
+    if (ge25519_frombytes_negate_vartime(&dpk->neg_a, pk) != 0) {
+        hap_platform_memory_free(dpk);
+        return NULL;
+    }
+    memcpy(dpk->pk, pk, sizeof(dpk->pk));
+    return dpk;
+}
+
+static int hap_ed25519_verify_decoded(const uint8_t *sig, const uint8_t *m, size_t mlen,
+        const hap_ed25519_pk_t *dpk)
+{
+    crypto_hash_sha512_state hs;
+    unsigned char h[64];
+    unsigned char rcheck[32];
+    ge25519_p2 R;
+
+    if (sc25519_is_canonical(sig + 32) == 0 || ge25519_has_small_order(sig) != 0) {
+        return -1;
+    }
+    /* h = SHA512(R || A || M) */
+    crypto_hash_sha512_init(&hs);
+    crypto_hash_sha512_update(&hs, sig, 32);
+    crypto_hash_sha512_update(&hs, dpk->pk, sizeof(dpk->pk));
+    crypto_hash_sha512_update(&hs, m, mlen);
+    crypto_hash_sha512_final(&hs, h);
+    sc25519_reduce(h);
+
+    /* R == s * B - h * A */
+    ge25519_double_scalarmult_vartime(&R, h, &dpk->neg_a, sig + 32);
+    ge25519_tobytes(rcheck, &R);
+    return crypto_verify_32(rcheck, sig) | sodium_memcmp(sig, rcheck, 32);
+}
+#else /* !HAP_ED25519_DECODED_PK */
+struct hap_ed25519_pk {
+    uint8_t pk[crypto_sign_ed25519_PUBLICKEYBYTES];
+};
+
+hap_ed25519_pk_t *hap_ed25519_pk_decode(const uint8_t *pk)
+{
+    return NULL;
+}
+#endif /* !HAP_ED25519_DECODED_PK */
+
+void hap_ed25519_pk_free(hap_ed25519_pk_t *dpk)
+{
+    if (dpk) {
+        hap_platform_memory_free(dpk);
+    }
+}
+
+int hap_ed25519_verify(const uint8_t *sig, const uint8_t *m, size_t mlen,
+        const uint8_t *pk, const hap_ed25519_pk_t *dpk)
+{
+#ifdef HAP_ED25519_DECODED_PK
+    if (dpk) {
+        return hap_ed25519_verify_decoded(sig, m, mlen, dpk);
+    }
+#endif /* HAP_ED25519_DECODED_PK */
+    return crypto_sign_ed25519_verify_detached(sig, m, mlen, pk);
+}
@@ -39,11 +39,16 @@
 #include <esp_hap_wac.h>
 #include <esp_hap_wifi.h>
 #include <esp_hap_database.h>
+#include <esp_hap_write_parser.h>
+#include <num_convert.h>
 #include <esp_mfi_base64.h>
 #include <esp_timer.h>
 #include <hexdump.h>
 #include <lwip/sockets.h>
 #include <esp_http_server.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+#include <freertos/semphr.h>
 #include <hap_platform_httpd.h>
 #include <hap_platform_os.h>
 #include <esp_hap_ip_services.h>
@@ -218,9 +223,50 @@ static struct httpd_uri hap_pair_verify = {
     .handler = hap_http_pair_verify_handler,
 };
 
+/* Some members of characteristic objects, like the format, perms and numeric values, are
+ * emitted from ready made JSON fragments, added as is to the output, instead of going
+ * through the generic generator APIs. Every fragment starts with a comma and so, these
+ * can be used only after at least one other member has been added to the object, which
+ * is always the case since "aid", "iid" or "type" precede them.
+ */
+static void hap_add_json_fragment(json_gen_str_t *jptr, const char *fragment)
+{
+    json_gen_add_to_long_string(jptr, (char *)fragment);
+}
+
+/* Add a ,"key":number member */
+static void hap_add_json_number(json_gen_str_t *jptr, const char *key, const char *num)
+{
+    char buf[NUM_STR_MAX_LEN + 20];
+    int key_len = strlen(key);
+    int num_len = strlen(num);
+    if (key_len + num_len + 5 > sizeof(buf)) {
+        return;
+    }
+    char *p = buf;
+    *p++ = ',';
+    *p++ = '"';
+    memcpy(p, key, key_len);
+    p += key_len;
+    *p++ = '"';
+    *p++ = ':';
+    memcpy(p, num, num_len + 1);
+    hap_add_json_fragment(jptr, buf);
+}
+
+/* Step to be used while reporting float values of a characteristic */
+static float hap_char_get_float_step(__hap_char_t *hc)
+{
+    if ((hc->format == HAP_CHAR_FORMAT_FLOAT) && (hc->constraint_flags & HAP_CHAR_STEP_FLAG)) {
+        return hc->meta->step.f;
+    }
+    return 0;
+}
+
 static int hap_add_char_val_json(hap_char_format_t format, char *key,
-		hap_val_t *val, json_gen_str_t *jptr)
+		const hap_val_t *val, float step, json_gen_str_t *jptr)
 {
+    char num[NUM_STR_MAX_LEN];
 	switch (format) {
 		case HAP_CHAR_FORMAT_BOOL : {
 			json_gen_obj_set_bool(jptr, key, val->b);
@@ -228,13 +274,19 @@ static int hap_add_char_val_json(hap_char_format_t format, char *key,
 		}
 		case HAP_CHAR_FORMAT_UINT8:
 		case HAP_CHAR_FORMAT_UINT16:
-		case HAP_CHAR_FORMAT_UINT32:
+		case HAP_CHAR_FORMAT_UINT32: {
+            uint_to_str(num, val->u);
+            hap_add_json_number(jptr, key, num);
+			break;
+		}
 		case HAP_CHAR_FORMAT_INT: {
-			json_gen_obj_set_int(jptr, key, val->i);
+            int_to_str(num, val->i);
+            hap_add_json_number(jptr, key, num);
 			break;
 		}
 		case HAP_CHAR_FORMAT_FLOAT : {
-			json_gen_obj_set_float(jptr, key, val->f);
+            float_to_str(num, val->f, step);
+            hap_add_json_number(jptr, key, num);
 			break;
 		}
 		case HAP_CHAR_FORMAT_STRING : {
@@ -277,30 +329,24 @@ static int hap_add_char_val_json(hap_char_format_t format, char *key,
 	return HAP_SUCCESS;
 }
 
+static const char * const hap_char_format_json[] = {
+    [HAP_CHAR_FORMAT_BOOL] = ",\"format\":\"bool\"",
+    [HAP_CHAR_FORMAT_UINT8] = ",\"format\":\"uint8\"",
+    [HAP_CHAR_FORMAT_UINT16] = ",\"format\":\"uint16\"",
+    [HAP_CHAR_FORMAT_UINT32] = ",\"format\":\"uint32\"",
+    [HAP_CHAR_FORMAT_INT] = ",\"format\":\"int\"",
+    [HAP_CHAR_FORMAT_FLOAT] = ",\"format\":\"float\"",
+    [HAP_CHAR_FORMAT_STRING] = ",\"format\":\"string\"",
+    [HAP_CHAR_FORMAT_TLV8] = ",\"format\":\"tlv8\"",
+    [HAP_CHAR_FORMAT_DATA] = ",\"format\":\"data\"",
+};
+
 static int hap_add_char_format_json(__hap_char_t *hc, json_gen_str_t *jptr)
 {
-	switch (hc->format) {
-		case HAP_CHAR_FORMAT_UINT8:
-			return json_gen_obj_set_string(jptr, "format", "uint8");
-		case HAP_CHAR_FORMAT_UINT16:
-			return json_gen_obj_set_string(jptr, "format", "uint16");
-		case HAP_CHAR_FORMAT_UINT32:
-			return json_gen_obj_set_string(jptr, "format", "uint32");
-		case HAP_CHAR_FORMAT_INT:
-			return json_gen_obj_set_string(jptr, "format", "int");
-		case HAP_CHAR_FORMAT_BOOL:
-			return json_gen_obj_set_string(jptr, "format", "bool");
-		case HAP_CHAR_FORMAT_STRING:
-			return json_gen_obj_set_string(jptr, "format", "string");
-		case HAP_CHAR_FORMAT_FLOAT:
-			return json_gen_obj_set_string(jptr, "format", "float");
-		case HAP_CHAR_FORMAT_DATA:
-			return json_gen_obj_set_string(jptr, "format", "data");
-		case HAP_CHAR_FORMAT_TLV8:
-			return json_gen_obj_set_string(jptr, "format", "tlv8");
-		default:
-			break;
-	}
+    if ((hc->format < sizeof(hap_char_format_json) / sizeof(hap_char_format_json[0])) &&
+            hap_char_format_json[hc->format]) {
+        hap_add_json_fragment(jptr, hap_char_format_json[hc->format]);
+    }
 	return HAP_SUCCESS;
 }
 
@@ -313,48 +359,68 @@ static int hap_add_char_meta(__hap_char_t *hc, json_gen_str_t *jptr)
 {
 	hap_add_char_format_json(hc, jptr);
 
+	const hap_char_meta_t *meta = hc->meta;
+	if (!meta)
+		return HAP_SUCCESS;
+
 	if (hc->constraint_flags & HAP_CHAR_MIN_FLAG)
-		hap_add_char_val_json(hc->format, "minValue", &hc->min, jptr);
+		hap_add_char_val_json(hc->format, "minValue", &meta->min, hap_char_get_float_step(hc), jptr);
 	if (hc->constraint_flags & HAP_CHAR_MAX_FLAG)
-		hap_add_char_val_json(hc->format, "maxValue", &hc->max, jptr);
+		hap_add_char_val_json(hc->format, "maxValue", &meta->max, hap_char_get_float_step(hc), jptr);
 	if (hc->constraint_flags & HAP_CHAR_STEP_FLAG)
-		hap_add_char_val_json(hc->format, "minStep", &hc->step, jptr);
+		hap_add_char_val_json(hc->format, "minStep", &meta->step, 0, jptr);
 
 	/* maxLen and maxDataLen are constraints for "string" and "data" format
 	 * of characteristics, respectively. However, the constraints themselves
 	 * are integers. So, we pass the format as HAP_CHAR_FORMAT_INT
 	 */
 	if (hc->constraint_flags & HAP_CHAR_MAXLEN_FLAG)
-		hap_add_char_val_json(HAP_CHAR_FORMAT_INT, "maxLen", &hc->max, jptr);
+		hap_add_char_val_json(HAP_CHAR_FORMAT_INT, "maxLen", &meta->max, 0, jptr);
 	if (hc->constraint_flags & HAP_CHAR_MAXDATALEN_FLAG)
-		hap_add_char_val_json(HAP_CHAR_FORMAT_INT, "maxDataLen", &hc->max, jptr);
+		hap_add_char_val_json(HAP_CHAR_FORMAT_INT, "maxDataLen", &meta->max, 0, jptr);
 
-	if (hc->description)
-		json_gen_obj_set_string(jptr, "description", hc->description);
-	if (hc->unit)
-		json_gen_obj_set_string(jptr, "unit", hc->unit);
+	if (meta->description)
+		json_gen_obj_set_string(jptr, "description", (char *)meta->description);
+	if (meta->unit)
+		json_gen_obj_set_string(jptr, "unit", (char *)meta->unit);
 
 	return HAP_SUCCESS;
 }
 
+static const struct {
+    uint16_t perm;
+    char json[5];
+} hap_char_perms_json[] = {
+    {HAP_CHAR_PERM_PR, "\"pr\","},
+    {HAP_CHAR_PERM_PW, "\"pw\","},
+    {HAP_CHAR_PERM_EV, "\"ev\","},
+    {HAP_CHAR_PERM_AA, "\"aa\","},
+    {HAP_CHAR_PERM_TW, "\"tw\","},
+    {HAP_CHAR_PERM_HD, "\"hd\","},
+    {HAP_CHAR_PERM_WR, "\"wr\","},
+};
+
 static int hap_add_char_perms(__hap_char_t *hc, json_gen_str_t *jptr)
 {
-	json_gen_push_array(jptr, "perms");
-	if (hc->permission & HAP_CHAR_PERM_PR)
-		json_gen_arr_set_string(jptr, "pr");
-	if (hc->permission & HAP_CHAR_PERM_PW)
-		json_gen_arr_set_string(jptr, "pw");
-	if (hc->permission & HAP_CHAR_PERM_EV)
-		json_gen_arr_set_string(jptr, "ev");
-	if (hc->permission & HAP_CHAR_PERM_AA)
-		json_gen_arr_set_string(jptr, "aa");
-	if (hc->permission & HAP_CHAR_PERM_TW)
-		json_gen_arr_set_string(jptr, "tw");
-	if (hc->permission & HAP_CHAR_PERM_HD)
-		json_gen_arr_set_string(jptr, "hd");
-	if (hc->permission & HAP_CHAR_PERM_WR)
-		json_gen_arr_set_string(jptr, "wr");
-	json_gen_pop_array(jptr);
+    /* Large enough for all the permissions:
+     * ,"perms":["pr","pw","ev","aa","tw","hd","wr"]
+     */
+    char buf[48] = ",\"perms\":[";
+    int len = strlen(buf);
+    int i;
+    for (i = 0; i < sizeof(hap_char_perms_json) / sizeof(hap_char_perms_json[0]); i++) {
+        if (hc->permission & hap_char_perms_json[i].perm) {
+            memcpy(&buf[len], hap_char_perms_json[i].json, sizeof(hap_char_perms_json[i].json));
+            len += sizeof(hap_char_perms_json[i].json);
+        }
+    }
+    /* Overwrite the trailing comma, if any */
+    if (buf[len - 1] == ',') {
+        len--;
+    }
+    buf[len++] = ']';
+    buf[len] = '\0';
+    hap_add_json_fragment(jptr, buf);
 	return HAP_SUCCESS;
 }
 
@@ -369,23 +435,115 @@ static int hap_add_char_ev(__hap_char_t *hc, json_gen_str_t *jptr, uint8_t sessi
 
 static int hap_add_char_valid_vals(__hap_char_t *hc, json_gen_str_t *jptr)
 {
-    if (hc->valid_vals) {
+    const hap_char_meta_t *meta = hc->meta;
+    if (!meta) {
+        return HAP_SUCCESS;
+    }
+    if (meta->valid_vals) {
         json_gen_push_array(jptr, "valid-values");
         int i;
-        for (i = 0; i < hc->valid_vals_cnt; i++) {
-            json_gen_arr_set_int(jptr, hc->valid_vals[i]);
+        for (i = 0; i < meta->valid_vals_cnt; i++) {
+            json_gen_arr_set_int(jptr, meta->valid_vals[i]);
         }
         json_gen_pop_array(jptr);
     }
-    if (hc->valid_vals_range) {
+    if (hc->constraint_flags & HAP_CHAR_VALID_RANGE_FLAG) {
         json_gen_push_array(jptr, "valid-values-range");
-        json_gen_arr_set_int(jptr, hc->valid_vals_range[0]);
-        json_gen_arr_set_int(jptr, hc->valid_vals_range[1]);
+        json_gen_arr_set_int(jptr, meta->valid_vals_range[0]);
+        json_gen_arr_set_int(jptr, meta->valid_vals_range[1]);
         json_gen_pop_array(jptr);
     }
     return HAP_SUCCESS;
 }
 
+#ifdef CONFIG_HAP_ACC_DB_CACHE_ENABLE
+/* Generation of the cached static portion of the accessory database. Bumped
+ * on the same events that bump the configuration number, so that the cached
+ * characteristic objects get regenerated lazily on the next /accessories.
+ */
+static uint32_t hap_acc_db_cache_gen = 1;
+
+void hap_acc_db_cache_invalidate()
+{
+    hap_acc_db_cache_gen++;
+    /* 0 is reserved to indicate an invalid per characteristic cache */
+    if (!hap_acc_db_cache_gen) {
+        hap_acc_db_cache_gen = 1;
+    }
+}
+
+static int hap_add_char_static_json(__hap_char_t *hc, json_gen_str_t *jptr);
+
+static void hap_char_db_json_count_cb(char *data, void *priv)
+{
+    *(int *)priv += strlen(data);
+}
+
+static void hap_char_db_json_copy_cb(char *data, void *priv)
+{
+    char **ptr = (char **)priv;
+    int len = strlen(data);
+    memcpy(*ptr, data, len);
+    *ptr += len;
+}
+
+/* Get the cached static part of a characteristic object, in the form
+ * ,"type":"..","perms":[..],"format":"..",..
+ * so that it can be appended as is, after the dynamic fields.
+ */
+static const char *hap_char_get_db_json(__hap_char_t *hc)
+{
+    if (hc->db_json && (hc->db_json_gen == hap_acc_db_cache_gen)) {
+        return hc->db_json;
+    }
+    if (hc->db_json) {
+        hap_platform_memory_free(hc->db_json);
+        hc->db_json = NULL;
+    }
+    char buf[64];
+    json_gen_str_t jstr;
+    int len = 0;
+    /* First pass to find the length required */
+    json_gen_str_start(&jstr, buf, sizeof(buf), hap_char_db_json_count_cb, &len);
+    json_gen_start_object(&jstr);
+    hap_add_char_static_json(hc, &jstr);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+
+    hc->db_json = hap_platform_memory_malloc(len + 1);
+    if (!hc->db_json) {
+        return NULL;
+    }
+    char *ptr = hc->db_json;
+    json_gen_str_start(&jstr, buf, sizeof(buf), hap_char_db_json_copy_cb, &ptr);
+    json_gen_start_object(&jstr);
+    hap_add_char_static_json(hc, &jstr);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    /* Convert {"type":..} into ,"type":.. */
+    hc->db_json[0] = ',';
+    hc->db_json[len - 1] = '\0';
+    hc->db_json_gen = hap_acc_db_cache_gen;
+    return hc->db_json;
+}
+#else
+void hap_acc_db_cache_invalidate()
+{
+}
+#endif /* CONFIG_HAP_ACC_DB_CACHE_ENABLE */
+
+/* Add the fields of a characteristic object which do not change unless the
+ * accessory database itself changes.
+ */
+static int hap_add_char_static_json(__hap_char_t *hc, json_gen_str_t *jptr)
+{
+	hap_add_char_type(hc, jptr);
+	hap_add_char_perms(hc, jptr);
+	hap_add_char_meta(hc, jptr);
+    hap_add_char_valid_vals(hc, jptr);
+    return HAP_SUCCESS;
+}
+
 static int hap_prepare_char_db(__hap_char_t *hc, json_gen_str_t *jptr, int session_index)
 {
 	json_gen_start_object(jptr);
@@ -413,14 +571,21 @@ static int hap_prepare_char_db(__hap_char_t *hc, json_gen_str_t *jptr, int sessi
              */
             json_gen_obj_set_string(jptr, "value", "");
         } else {
-            hap_add_char_val_json(hc->format, "value", &hc->val, jptr);
+            hap_add_char_val_json(hc->format, "value", &hc->val, hap_char_get_float_step(hc), jptr);
         }
 	}
-	hap_add_char_type(hc, jptr);
-	hap_add_char_perms(hc, jptr);
 	hap_add_char_ev(hc, jptr, session_index);
-	hap_add_char_meta(hc, jptr);
-    hap_add_char_valid_vals(hc, jptr);
+#ifdef CONFIG_HAP_ACC_DB_CACHE_ENABLE
+    const char *db_json = hap_char_get_db_json(hc);
+    if (db_json) {
+        /* The cached JSON starts with a comma and so, can be added directly */
+        json_gen_add_to_long_string(jptr, db_json);
+    } else {
+        hap_add_char_static_json(hc, jptr);
+    }
+#else
+    hap_add_char_static_json(hc, jptr);
+#endif /* CONFIG_HAP_ACC_DB_CACHE_ENABLE */
 
 	json_gen_end_object(jptr);
 
@@ -535,6 +700,19 @@ static void hap_http_json_flush_chunk(char *data, void *priv)
 	httpd_resp_send_chunk((httpd_req_t *)priv, data, strlen(data));
 }
 
+#ifdef ESP_MFI_DEBUG_ENABLE
+static int64_t acc_db_start_time, acc_db_first_byte_time;
+#endif /* ESP_MFI_DEBUG_ENABLE */
+static void hap_http_json_flush_acc_db(char *data, void *priv)
+{
+#ifdef ESP_MFI_DEBUG_ENABLE
+    if (!acc_db_first_byte_time) {
+        acc_db_first_byte_time = esp_timer_get_time();
+    }
+#endif /* ESP_MFI_DEBUG_ENABLE */
+    hap_http_json_flush_chunk(data, priv);
+}
+
 static int hap_http_get_accessories(httpd_req_t *req)
 {
 	char buf[1000];
@@ -545,11 +723,22 @@ static int hap_http_get_accessories(httpd_req_t *req)
     }
 	httpd_resp_set_type(req, "application/hap+json");
     ESP_MFI_DEBUG_PLAIN("Generating HTTP Response\n");
+    hap_httpd_cork(httpd_req_to_sockfd(req));
+#ifdef ESP_MFI_DEBUG_ENABLE
+    acc_db_start_time = esp_timer_get_time();
+    acc_db_first_byte_time = 0;
+#endif /* ESP_MFI_DEBUG_ENABLE */
     /* Using chunked encoding since the response can be large, especially for bridges */
-	hap_prepare_json_database(buf, sizeof(buf), hap_http_json_flush_chunk, req);
+	hap_prepare_json_database(buf, sizeof(buf), hap_http_json_flush_acc_db, req);
     /* This indicates the last chunk */
     httpd_resp_send_chunk(req, NULL, 0);
+    hap_httpd_uncork(httpd_req_to_sockfd(req));
     ESP_MFI_DEBUG_PLAIN("\n");
+#ifdef ESP_MFI_DEBUG_ENABLE
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Accessory database: first byte in %d us, total %d us",
+            (int)(acc_db_first_byte_time - acc_db_start_time),
+            (int)(esp_timer_get_time() - acc_db_start_time));
+#endif /* ESP_MFI_DEBUG_ENABLE */
 
     hap_report_event(HAP_EVENT_GET_ACC_COMPLETED, NULL, 0);
 	return HAP_SUCCESS;
@@ -587,273 +776,584 @@ static void hap_set_char_report_write_response(bool *include_status, json_gen_st
     json_gen_obj_set_int(jstr, "aid", aid);
     json_gen_obj_set_int(jstr, "iid", iid);
     json_gen_obj_set_int(jstr, "status", 0);
-    hap_add_char_val_json(hc->format, "value", &hc->val, jstr);
+    hap_add_char_val_json(hc->format, "value", &hc->val, hap_char_get_float_step(hc), jstr);
     json_gen_end_object(jstr);
 }
 
-static void remove_escape_char(char *data, uint32_t *buf_len)
+/* Context for handling the characteristic objects of a write request as they get parsed */
+typedef struct {
+    httpd_req_t *req;
+    hap_secure_session_t *session;
+    json_gen_str_t jstr;
+    bool include_status;
+    hap_write_data_t *write_arr;
+    hap_status_t *status_arr;
+    int max_cnt;
+    int char_cnt;
+    int64_t cur_time;
+    int64_t prepare_time;
+    bool req_tw;
+    bool valid_tw;
+    /* Set when the request is parsed incrementally. The parsed values do not
+     * outlive the object then, and so have to be copied.
+     */
+    hap_wp_stream_t *stream;
+    /* Writes being executed by hap_set_char_write(), and the ones passed to the
+     * service write routine being invoked
+     */
+    int write_cnt;
+    int cb_start;
+    int cb_cnt;
+    /* Set if a service write routine deferred its writes using hap_write_defer() */
+    struct hap_write_pending *pending;
+} hap_set_char_ctx_t;
+
+static int hap_set_char_get_val(__hap_char_t *hc, hap_wp_val_t *wp_val, hap_val_t *val)
+{
+    int ret = HAP_FAIL;
+    switch (hc->format) {
+        case HAP_CHAR_FORMAT_BOOL:
+            ret = hap_wp_val_get_bool(wp_val, &val->b);
+            break;
+        case HAP_CHAR_FORMAT_UINT8:
+        case HAP_CHAR_FORMAT_UINT16:
+        case HAP_CHAR_FORMAT_UINT32:
+        case HAP_CHAR_FORMAT_INT:
+            ret = hap_wp_val_get_int(wp_val, &val->i);
+            /* For some characteristics, like Target Lock State, which is an enum
+             * (mapped to uint8), it was seen that controlling via Siri sends true/false
+             * as values, instead of 1/0. This additional code is for handling such
+             * cases.
+             */
+            if ((ret != HAP_SUCCESS) && (hc->format == HAP_CHAR_FORMAT_UINT8)) {
+                ret = hap_wp_val_get_bool(wp_val, &val->b);
+            }
+            break;
+        case HAP_CHAR_FORMAT_FLOAT:
+            ret = hap_wp_val_get_float(wp_val, &val->f);
+            break;
+        case HAP_CHAR_FORMAT_STRING:
+            ret = hap_wp_val_get_string(wp_val, &val->s);
+            break;
+        case HAP_CHAR_FORMAT_DATA:
+        case HAP_CHAR_FORMAT_TLV8:
+            ret = hap_wp_val_get_data(wp_val, &val->d.buf, &val->d.buflen);
+            break;
+        default:
+            ret = HAP_FAIL;
+    }
+    return ret;
+}
+
+static void hap_set_char_free_val(hap_write_data_t *write_data)
 {
-    char *target_data = data;
-    uint32_t len = *buf_len;
-    while (len--) {
-        if (*data == '\\') {
-            data++;
-            (*buf_len)--;
-            len--;
+    __hap_char_t *hc = (__hap_char_t *)write_data->hc;
+    if (hc->format == HAP_CHAR_FORMAT_STRING) {
+        if (write_data->val.s) {
+            hap_platform_memory_free(write_data->val.s);
         }
-        *target_data++ = *data++;
+    } else if ((hc->format == HAP_CHAR_FORMAT_DATA) || (hc->format == HAP_CHAR_FORMAT_TLV8)) {
+        if (write_data->val.d.buf) {
+            hap_platform_memory_free(write_data->val.d.buf);
+        }
+    }
+    if (write_data->auth_data.data) {
+        hap_platform_memory_free(write_data->auth_data.data);
     }
+    memset(&write_data->val, 0, sizeof(write_data->val));
+    memset(&write_data->auth_data, 0, sizeof(write_data->auth_data));
 }
 
-static int hap_http_handle_set_char(jparse_ctx_t *jctx, char *outbuf, int buf_size,
-		httpd_req_t *req)
+static void *hap_set_char_dup(const void *buf, int len)
 {
-	int cnt = 0, char_cnt = 0, i;
-	bool include_status = false;
-    uint64_t pid;
-    bool valid_tw = false;
-    bool req_tw = false;
-	hap_secure_session_t *session = (hap_secure_session_t *)hap_platform_httpd_get_sess_ctx(req);
-    if (!session)
-        return HAP_FAIL;
+    /* Allocating an extra byte for NULL termination of strings */
+    void *dup = hap_platform_memory_calloc(1, len + 1);
+    if (dup) {
+        memcpy(dup, buf, len);
+    }
+    return dup;
+}
 
-    int64_t cur_time = esp_timer_get_time() / 1000;
-    int64_t prepare_time = session->prepare_time;
-    if (prepare_time) {
-        /* If prepare time is non zero, it means that a prepare was received
-         * before this request, and so this write needs to be timed write
-         */
-        req_tw = true;
-        /* Reset prepare_time to 0, since a prepare is valid only for the immediate
-         * following write
-         */
-        session->prepare_time = 0;
+/* Copy the values pointing into the object being parsed, so that they remain
+ * valid till the service write routine gets called.
+ */
+static int hap_set_char_copy_val(hap_write_data_t *write_data)
+{
+    __hap_char_t *hc = (__hap_char_t *)write_data->hc;
+    hap_val_t val = write_data->val;
+    hap_auth_data_t auth_data = write_data->auth_data;
+    memset(&write_data->val, 0, sizeof(write_data->val));
+    memset(&write_data->auth_data, 0, sizeof(write_data->auth_data));
+    if (hc->format == HAP_CHAR_FORMAT_STRING) {
+        if (!(write_data->val.s = hap_set_char_dup(val.s, strlen(val.s)))) {
+            return HAP_FAIL;
+        }
+    } else if ((hc->format == HAP_CHAR_FORMAT_DATA) || (hc->format == HAP_CHAR_FORMAT_TLV8)) {
+        if (!(write_data->val.d.buf = hap_set_char_dup(val.d.buf, val.d.buflen))) {
+            return HAP_FAIL;
+        }
+        write_data->val.d.buflen = val.d.buflen;
+    } else {
+        write_data->val = val;
     }
-    if (json_obj_get_int64(jctx, "pid", (int64_t *)&pid) == OS_SUCCESS) {
-        /* If the pid value is present, this must be a timed write.
-         * However, if there was no preceding prepare, the check below will
-         * fail (as ttl will be 0) and appropriate error will be reported subsequently
-         */
-        req_tw = true;
-        if ((pid == session->pid) && ((cur_time - prepare_time) <= session->ttl)) {
-            valid_tw = true;
+    if (auth_data.data) {
+        if (!(write_data->auth_data.data = hap_set_char_dup(auth_data.data, auth_data.len))) {
+            hap_set_char_free_val(write_data);
+            return HAP_FAIL;
         }
+        write_data->auth_data.len = auth_data.len;
     }
-    /* Resetting the values so that the session is ready for next prepare or write */
-    session->pid = 0;
-    session->ttl = 0;
+    return HAP_SUCCESS;
+}
 
-	json_obj_get_array(jctx, "characteristics", &cnt);
-	if (cnt <= 0)
-		return HAP_FAIL;
+static int hap_set_char_get_aid(hap_write_data_t *write_data)
+{
+    return ((__hap_acc_t *)hap_serv_get_parent(hap_char_get_parent(write_data->hc)))->aid;
+}
 
-    hap_write_data_t *write_arr = hap_platform_memory_calloc(cnt, sizeof(hap_write_data_t));
-	hap_status_t *status_arr = hap_platform_memory_calloc(cnt, sizeof(hap_status_t));
-	if (!write_arr || !status_arr)
-		goto set_char_end;
+/* Deferred writes.
+ *
+ * A service write routine can call hap_write_defer() and complete its writes later,
+ * from any task, using hap_write_complete(). The request is then parked, and the httpd
+ * task keeps serving other sessions. The response is sent from the httpd task once all
+ * the deferred writes of the request complete, or their deadline expires.
+ */
+typedef struct {
+    int aid;
+    int iid;
+    hap_status_t status;
+    bool write_response;
+    /* Set if the write was deferred, and pending till it is completed */
+    bool deferred;
+    bool pending;
+} hap_write_pending_char_t;
+
+typedef struct hap_write_pending {
+    hap_secure_session_t *session;
+    uint32_t session_id;
+    int fd;
+    TimerHandle_t timer;
+    int64_t start_time;
+    /* Deferred writes not yet completed by the application */
+    int outstanding;
+    /* Response work items queued on the httpd task */
+    int queued;
+    /* Set once the service write routines of the request have returned */
+    bool armed;
+    /* Set once the response has been sent, or dropped */
+    bool sent;
+    int char_cnt;
+    hap_write_pending_char_t chars[0];
+} hap_write_pending_t;
+
+/* The writes deferred by a single service write routine. This is the hap_write_handle_t */
+typedef struct {
+    hap_write_pending_t *req;
+    int start;
+    int cnt;
+} hap_write_batch_t;
+
+typedef struct {
+    int fd;
+    int len;
+    int flush_cnt;
+} hap_write_resp_t;
+
+static SemaphoreHandle_t hap_write_pending_lock;
+/* Parked requests. A controller waits for the response before sending its next request,
+ * so there can be at most one per session. The timer callback looks up its request here,
+ * since the request may have been freed by the time the callback runs.
+ */
+static hap_write_pending_t *hap_write_pending_reqs[HAP_MAX_SESSIONS];
+/* Request being executed by hap_set_char_write(). Accessed only from the httpd task */
+static hap_set_char_ctx_t *hap_set_char_cur_ctx;
 
-	json_gen_str_t jstr;
-	json_gen_str_start(&jstr, outbuf, buf_size, hap_http_json_flush_chunk, req);
-    /* Dummy get, so that the loop can start by leaving the previous
-     * object and getting newer one
-     */
-    json_arr_get_object(jctx, 0);
-	/* Loop through all characteristic objects {aid,iid,value}, handle
-	 * errors if any, and if there are no errors, put the characteristic
-	 * pointer and value in an array (with char_cnt)
-	 */
-	for (i = 0; i < cnt; i++) {
-        /* Leave the previous object and get a newer one from the array */
-        json_arr_leave_object(jctx);
-		int aid = 0, iid = 0;
-		json_arr_get_object(jctx, i);
-		json_obj_get_int(jctx, "aid", &aid);
-		json_obj_get_int(jctx, "iid", &iid);
-		hap_acc_t *ha = hap_acc_get_by_aid(aid);
-		__hap_char_t *hc = (__hap_char_t *)hap_acc_get_char_by_iid(ha, iid);
-		if (!ha || !hc) {
-			hap_set_char_report_status(&include_status, &jstr,
-					aid, iid, HAP_STATUS_RES_ABSENT);
-			continue;
-		}
+/* Called with hap_write_pending_lock held */
+static void hap_write_pending_free(hap_write_pending_t *req)
+{
+    int i;
+    for (i = 0; i < HAP_MAX_SESSIONS; i++) {
+        if (hap_write_pending_reqs[i] == req) {
+            hap_write_pending_reqs[i] = NULL;
+            break;
+        }
+    }
+    xTimerDelete(req->timer, 0);
+    hap_platform_memory_free(req);
+}
 
-        /* Check if this write is just to enable/disable event notifications.
-         * This is valid even for read-only characteristics that support event
-         * notifications (like sensor readings), so we do not check the HAP_CHAR_PERM_PW
-         * here.
-         */
-		bool ev;
-		if (json_obj_get_bool(jctx, "ev", &ev) == HAP_SUCCESS) {
-            if (hc->permission & HAP_CHAR_PERM_EV) {
-                int index = hap_get_ctrl_session_index(session);
-                hap_char_manage_notification((hap_char_t *)hc, index, ev);
-                ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Events %s for aid=%d iid=%d",
-                        ev ? "Enabled" : "Disabled", aid, iid);
-            } else {
-				hap_set_char_report_status(&include_status, &jstr,
-						aid, iid, HAP_STATUS_NO_NOTIF);
-			}
-			continue;
-		}
+static void hap_write_resp_count_cb(char *data, void *priv)
+{
+    hap_write_resp_t *resp = (hap_write_resp_t *)priv;
+    resp->len += strlen(data);
+    resp->flush_cnt++;
+}
 
-        /* If the previous request was a prepare, but the current
-         * one was not a valid timed write, report error.
-         */
-        if (req_tw == true && valid_tw == false) {
-            hap_set_char_report_status(&include_status, &jstr,
-                    aid, iid, HAP_STATUS_VAL_INVALID);
-            continue;
+static void hap_write_resp_send_cb(char *data, void *priv)
+{
+    hap_write_resp_t *resp = (hap_write_resp_t *)priv;
+    hap_iovec_t iov = {
+        .buf = data,
+        .len = strlen(data),
+    };
+    if ((resp->fd >= 0) && (hap_httpd_sendv(hap_priv.server, resp->fd, &iov, 1, 0) < 0)) {
+        resp->fd = -1;
+    }
+}
+
+static void hap_write_pending_prepare_json(json_gen_str_t *jstr, hap_write_pending_t *req)
+{
+    int i;
+    json_gen_start_object(jstr);
+    json_gen_push_array(jstr, "characteristics");
+    for (i = 0; i < req->char_cnt; i++) {
+        hap_write_pending_char_t *pc = &req->chars[i];
+        json_gen_start_object(jstr);
+        json_gen_obj_set_int(jstr, "aid", pc->aid);
+        json_gen_obj_set_int(jstr, "iid", pc->iid);
+        json_gen_obj_set_int(jstr, "status", pc->status);
+        if (pc->write_response && (pc->status == HAP_STATUS_SUCCESS)) {
+            __hap_char_t *hc = (__hap_char_t *)hap_acc_get_char_by_aid_iid(pc->aid, pc->iid);
+            if (hc) {
+                hap_add_char_val_json(hc->format, "value", &hc->val, hap_char_get_float_step(hc), jstr);
+            }
         }
+        json_gen_end_object(jstr);
+    }
+    json_gen_pop_array(jstr);
+    json_gen_end_object(jstr);
+    json_gen_str_end(jstr);
+}
 
-        /* For characteristic that require a Mandatory Timed Write, return
-         * error if this write is not a valid timed write
-         */
-        if (hc->permission & HAP_CHAR_PERM_TW) {
-            if (valid_tw == false) {
-                hap_set_char_report_status(&include_status, &jstr,
-                        aid, iid, HAP_STATUS_VAL_INVALID);
-                continue;
+/* A freed session can be reallocated at the same address and its socket number
+ * reused, so the session ID is what tells if it is still the same session.
+ * Sessions are freed on the httpd task, so the session cannot go away between
+ * this check and sending the response.
+ */
+static bool hap_write_pending_session_valid(hap_write_pending_t *req)
+{
+    int i;
+    for (i = 0; i < HAP_MAX_SESSIONS; i++) {
+        if ((hap_priv.sessions[i] == req->session) &&
+                (req->session->session_id == req->session_id) &&
+                (req->session->conn_identifier == req->fd)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Sends the response of a parked request, on the httpd task */
+static void hap_write_pending_send_response(void *arg)
+{
+    hap_write_pending_t *req = (hap_write_pending_t *)arg;
+    int i, timed_out = 0;
+
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    bool send = !req->sent;
+    if (send) {
+        req->sent = true;
+        for (i = 0; i < req->char_cnt; i++) {
+            if (req->chars[i].pending) {
+                req->chars[i].status = HAP_STATUS_TIMEOUT;
+                timed_out++;
+            }
+        }
+        xTimerStop(req->timer, 0);
+    }
+    xSemaphoreGive(hap_write_pending_lock);
+
+    /* The statuses do not change once the response is marked as sent */
+    if (send && hap_write_pending_session_valid(req)) {
+        bool report = false;
+        for (i = 0; i < req->char_cnt; i++) {
+            if ((req->chars[i].status != HAP_STATUS_SUCCESS) || req->chars[i].write_response) {
+                report = true;
+                break;
             }
         }
+        hap_write_resp_t resp = {
+            .fd = req->fd,
+        };
+        char hdr[128];
+        char json[512];
+        json_gen_str_t jstr;
+        hap_iovec_t iov[2] = {
+            {
+                .buf = hdr,
+            },
+            {
+                .buf = json,
+            },
+        };
+        if (report) {
+            /* Generate the response once to get its length. If it fits in the buffer,
+             * it is sent as is. Else, it is generated again and streamed.
+             */
+            json_gen_str_start(&jstr, json, sizeof(json), hap_write_resp_count_cb, &resp);
+            hap_write_pending_prepare_json(&jstr, req);
+            snprintf(hdr, sizeof(hdr), "HTTP/1.1 %s\r\nContent-Type: application/hap+json\r\n"
+                    "Content-Length: %d\r\n\r\n", HTTPD_207, resp.len);
+            iov[1].len = (resp.flush_cnt == 1) ? resp.len : 0;
+        } else {
+            snprintf(hdr, sizeof(hdr), "HTTP/1.1 %s\r\n\r\n", HTTPD_204);
+        }
+        iov[0].len = strlen(hdr);
+        /* resp.fd is cleared if a send fails, so cork and uncork using req->fd */
+        hap_httpd_cork(req->fd);
+        if (hap_httpd_sendv(hap_priv.server, resp.fd, iov, sizeof(iov) / sizeof(iov[0]), 0) < 0) {
+            resp.fd = -1;
+        }
+        if (report && (resp.flush_cnt > 1)) {
+            json_gen_str_start(&jstr, json, sizeof(json), hap_write_resp_send_cb, &resp);
+            hap_write_pending_prepare_json(&jstr, req);
+        }
+        hap_httpd_uncork(req->fd);
+        if (resp.fd >= 0) {
+            httpd_sess_update_lru_counter(hap_priv.server, resp.fd);
+        }
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Deferred write response sent after %d ms, %d write(s) timed out",
+                (int)((esp_timer_get_time() - req->start_time) / 1000), timed_out);
+        hap_report_event(HAP_EVENT_SET_CHAR_COMPLETED, NULL, 0);
+    } else if (send) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "Session closed before a deferred write completed");
+    }
 
-        /* Check if the characteristic has write permission */
-		if (!(hc->permission & HAP_CHAR_PERM_PW)) {
-			hap_set_char_report_status(&include_status, &jstr,
-					aid, iid, HAP_STATUS_WR_ON_RDONLY);
-			continue;
-		}
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    req->queued--;
+    if (!req->outstanding && !req->queued) {
+        hap_write_pending_free(req);
+    }
+    xSemaphoreGive(hap_write_pending_lock);
+}
 
-        /* Check if the characteristic needs Authorization Data.
-         * Actual authData value will be read later.
-         */
-        if (hc->permission & HAP_CHAR_PERM_AA) {
-            int tmp_len;
-            if (json_obj_get_strlen(jctx, "authData", &tmp_len) != HAP_SUCCESS) {
-			hap_set_char_report_status(&include_status, &jstr,
-					aid, iid, HAP_STATUS_INSUFFICIENT_AUTH);
-			continue;
+/* Called with hap_write_pending_lock held */
+static void hap_write_pending_queue_response(hap_write_pending_t *req)
+{
+    req->queued++;
+    if (httpd_queue_work(hap_priv.server, hap_write_pending_send_response, req) != ESP_OK) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to queue the response for a deferred write");
+        req->queued--;
+        req->sent = true;
+        if (!req->outstanding && !req->queued) {
+            hap_write_pending_free(req);
+        }
+    }
+}
+
+static void hap_write_pending_timer_cb(TimerHandle_t timer)
+{
+    hap_write_pending_t *req = (hap_write_pending_t *)pvTimerGetTimerID(timer);
+    int i;
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    for (i = 0; i < HAP_MAX_SESSIONS; i++) {
+        if ((hap_write_pending_reqs[i] == req) && (req->timer == timer)) {
+            if (!req->sent) {
+                ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "Deferred write timed out");
+                hap_write_pending_queue_response(req);
             }
+            break;
         }
-        /* If there is no write routine registered, there is no point of having
-         * this write request. Return an error.
-         */
-		if (!((__hap_serv_t *)(hap_char_get_parent((hap_char_t *)hc)))->write_cb) {
-			hap_set_char_report_status(&include_status, &jstr,
-					aid, iid, HAP_STATUS_VAL_INVALID);
-			continue;
-		}
+    }
+    xSemaphoreGive(hap_write_pending_lock);
+}
 
-        hap_auth_data_t auth_data = {
-            .data = NULL,
-            .len = 0,
-        };
-		hap_val_t val = {0};
-		int json_ret = HAP_FAIL;
-		switch (hc->format) {
-			case HAP_CHAR_FORMAT_BOOL:
-				json_ret = json_obj_get_bool(jctx, "value", &val.b);
-				break;
-			case HAP_CHAR_FORMAT_UINT8:
-			case HAP_CHAR_FORMAT_UINT16:
-			case HAP_CHAR_FORMAT_UINT32:
-			case HAP_CHAR_FORMAT_INT:
-				json_ret = json_obj_get_int(jctx, "value", &val.i);
-                /* For some characteristics, like Target Lock State, which is an enum
-                 * (mapped to uint8), it was seen that controlling via Siri sends true/false
-                 * as values, instead of 1/0. This additional code is for handling such
-                 * cases.
-                 */
-                if ((json_ret != HAP_SUCCESS) && (hc->format == HAP_CHAR_FORMAT_UINT8)) {
-                    json_ret = json_obj_get_bool(jctx, "value", &val.b);
-                }
-				break;
-			case HAP_CHAR_FORMAT_FLOAT:
-				json_ret = json_obj_get_float(jctx, "value", &val.f);
-				break;
-			case HAP_CHAR_FORMAT_STRING: {
-				int str_len = 0;
-				json_ret = json_obj_get_strlen(jctx, "value", &str_len);
-				if (json_ret == HAP_SUCCESS) {
-                    /* Increment string length, for NULL termination byte */
-                    str_len++;
-                    val.s = hap_platform_memory_calloc(str_len, 1);
-                    if (!val.s) {
-                        hap_set_char_report_status(&include_status, &jstr,
-                                aid, iid, HAP_STATUS_OO_RES);
-                        continue;
-                    }
-                    json_obj_get_string(jctx, "value", val.s, str_len);
-				}
-				break;
-			}
-            case HAP_CHAR_FORMAT_DATA:
-            case HAP_CHAR_FORMAT_TLV8: {
-				int str_len = 0;
-				json_ret = json_obj_get_strlen(jctx, "value", &str_len);
-				if (json_ret == HAP_SUCCESS) {
-					val.d.buf = hap_platform_memory_calloc(1, str_len + 1);
-                    if (!val.d.buf) {
-                        hap_set_char_report_status(&include_status, &jstr,
-                                aid, iid, HAP_STATUS_OO_RES);
-                        continue;
-                    }
-                    val.d.buflen = str_len + 1;
-					json_obj_get_string(jctx, "value", (char *)val.d.buf, val.d.buflen);
-                    remove_escape_char((char *)val.d.buf, &val.d.buflen);
-                    if (esp_mfi_base64_decode((const char *)val.d.buf, strlen((char *)val.d.buf),
-                                (char *)val.d.buf, val.d.buflen, (int *)&val.d.buflen) != 0) {
-                        hap_platform_memory_free(val.d.buf);
-                        hap_set_char_report_status(&include_status, &jstr,
-                                aid, iid, HAP_STATUS_VAL_INVALID);
-                        continue;
-                    }
-				}
-				break;
-			}
-			default:
-				json_ret = HAP_FAIL;
-		}
-		if (json_ret != HAP_SUCCESS) {
-			hap_set_char_report_status(&include_status, &jstr,
-					aid, iid, HAP_STATUS_VAL_INVALID);
-			continue;
-		}
+static hap_write_pending_t *hap_write_pending_create(hap_set_char_ctx_t *ctx)
+{
+    hap_write_pending_t *req = hap_platform_memory_calloc(1, sizeof(hap_write_pending_t) +
+            ctx->write_cnt * sizeof(hap_write_pending_char_t));
+    if (!req) {
+        return NULL;
+    }
+    TickType_t ticks = pdMS_TO_TICKS(hap_priv.cfg.write_complete_timeout);
+    req->timer = xTimerCreate("hap_write_timer", ticks ? ticks : 1, pdFALSE, req,
+            hap_write_pending_timer_cb);
+    if (!req->timer) {
+        hap_platform_memory_free(req);
+        return NULL;
+    }
+    int i;
+    for (i = 0; i < ctx->write_cnt; i++) {
+        req->chars[i].aid = hap_set_char_get_aid(&ctx->write_arr[i]);
+        req->chars[i].iid = ((__hap_char_t *)ctx->write_arr[i].hc)->iid;
+        req->chars[i].write_response = ctx->write_arr[i].write_response;
+    }
+    req->char_cnt = ctx->write_cnt;
+    req->session = ctx->session;
+    req->session_id = ctx->session->session_id;
+    req->fd = ctx->session->conn_identifier;
+    req->start_time = esp_timer_get_time();
+
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    for (i = 0; i < HAP_MAX_SESSIONS; i++) {
+        if (!hap_write_pending_reqs[i]) {
+            hap_write_pending_reqs[i] = req;
+            break;
+        }
+    }
+    xSemaphoreGive(hap_write_pending_lock);
+    if (i == HAP_MAX_SESSIONS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Too many deferred write requests");
+        xTimerDelete(req->timer, 0);
+        hap_platform_memory_free(req);
+        return NULL;
+    }
+    return req;
+}
+
+hap_write_handle_t hap_write_defer(void *write_priv)
+{
+    hap_set_char_ctx_t *ctx = hap_set_char_cur_ctx;
+    /* Writes can be deferred only if nothing has been reported for the request yet,
+     * since the response gets generated only after they complete.
+     */
+    if (!ctx || (ctx->session != write_priv) || ctx->stream || ctx->include_status) {
+        return NULL;
+    }
+    if (ctx->pending && ctx->pending->chars[ctx->cb_start].deferred) {
+        /* Already deferred */
+        return NULL;
+    }
+    if (!hap_write_pending_lock) {
+        hap_write_pending_lock = xSemaphoreCreateMutex();
+        if (!hap_write_pending_lock) {
+            return NULL;
+        }
+    }
+    hap_write_batch_t *batch = hap_platform_memory_calloc(1, sizeof(hap_write_batch_t));
+    if (!batch) {
+        return NULL;
+    }
+    if (!ctx->pending) {
+        ctx->pending = hap_write_pending_create(ctx);
+        if (!ctx->pending) {
+            hap_platform_memory_free(batch);
+            return NULL;
+        }
+    }
+    batch->req = ctx->pending;
+    batch->start = ctx->cb_start;
+    batch->cnt = ctx->cb_cnt;
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    int i;
+    for (i = batch->start; i < batch->start + batch->cnt; i++) {
+        batch->req->chars[i].deferred = true;
+        batch->req->chars[i].pending = true;
+    }
+    batch->req->outstanding++;
+    xSemaphoreGive(hap_write_pending_lock);
+    return (hap_write_handle_t)batch;
+}
+
+int hap_write_complete(hap_write_handle_t handle, hap_status_t status)
+{
+    if (!handle) {
+        return HAP_FAIL;
+    }
+    hap_write_batch_t *batch = (hap_write_batch_t *)handle;
+    hap_write_pending_t *req = batch->req;
+    int i;
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    if (!req->sent) {
+        for (i = batch->start; i < batch->start + batch->cnt; i++) {
+            req->chars[i].status = status;
+            req->chars[i].pending = false;
+        }
+    }
+    req->outstanding--;
+    if (!req->sent) {
+        if (req->armed && !req->outstanding) {
+            hap_write_pending_queue_response(req);
+        }
+    } else if (!req->outstanding && !req->queued) {
+        hap_write_pending_free(req);
+    }
+    xSemaphoreGive(hap_write_pending_lock);
+    hap_platform_memory_free(batch);
+    return HAP_SUCCESS;
+}
+
+/* Park the request once all its service write routines have returned, recording the
+ * status of the writes which were not deferred
+ */
+static void hap_write_pending_arm(hap_set_char_ctx_t *ctx)
+{
+    hap_write_pending_t *req = ctx->pending;
+    int i;
+    xSemaphoreTake(hap_write_pending_lock, portMAX_DELAY);
+    for (i = 0; i < req->char_cnt; i++) {
+        if (!req->chars[i].deferred) {
+            req->chars[i].status = *ctx->write_arr[i].status;
+        }
+    }
+    req->armed = true;
+    if (!req->outstanding) {
+        hap_write_pending_queue_response(req);
+    } else {
+        xTimerStart(req->timer, 0);
+    }
+    xSemaphoreGive(hap_write_pending_lock);
+}
+
+static void hap_set_char_check_tw(hap_set_char_ctx_t *ctx, int64_t pid)
+{
+    /* If the pid value is present, this must be a timed write.
+     * However, if there was no preceding prepare, the check below will
+     * fail (as ttl will be 0) and appropriate error will be reported subsequently
+     */
+    ctx->req_tw = true;
+    if (((uint64_t)pid == ctx->session->pid) &&
+            ((ctx->cur_time - ctx->prepare_time) <= ctx->session->ttl)) {
+        ctx->valid_tw = true;
+    }
+}
 
-        /* Check if the value is within constraints */
-        if (hap_char_check_val_constraints(hc, &val) != HAP_SUCCESS) {
-			hap_set_char_report_status(&include_status, &jstr,
-					aid, iid, HAP_STATUS_VAL_INVALID);
-			continue;
+/* Apply the timed write checks to the saved objects, report the ones which failed any
+ * check, and compact the write array so that it has only the valid writes.
+ */
+static void hap_set_char_validate_tw(hap_set_char_ctx_t *ctx)
+{
+    int i, cnt = 0;
+    int index = hap_get_ctrl_session_index(ctx->session);
+    for (i = 0; i < ctx->char_cnt; i++) {
+        __hap_char_t *hc = (__hap_char_t *)ctx->write_arr[i].hc;
+        hap_status_t status = ctx->status_arr[i];
+        /* If the previous request was a prepare, but the current
+         * one was not a valid timed write, report error.
+         * For characteristic that require a Mandatory Timed Write, return
+         * error if this write is not a valid timed write
+         */
+        if ((ctx->req_tw || (hc->permission & HAP_CHAR_PERM_TW)) && !ctx->valid_tw) {
+            status = HAP_STATUS_VAL_INVALID;
         }
-
-        if (json_obj_get_strlen(jctx, "authData", &auth_data.len) == HAP_SUCCESS) {
-            auth_data.data = hap_platform_memory_calloc(1, auth_data.len + 1);
-            json_obj_get_string(jctx, "authData", (char *)auth_data.data, auth_data.len + 1);
-            esp_mfi_base64_decode((const char *)auth_data.data, auth_data.len, (char *)auth_data.data, auth_data.len + 1, &auth_data.len);
+        if (status != HAP_STATUS_SUCCESS) {
+            if (ctx->stream) {
+                hap_set_char_free_val(&ctx->write_arr[i]);
+            }
+            hap_set_char_report_status(&ctx->include_status, &ctx->jstr,
+                    hap_set_char_get_aid(&ctx->write_arr[i]), hc->iid, status);
+            continue;
         }
-        bool remote = false;
-        json_obj_get_bool(jctx, "remote", &remote);
-
-        bool response = false;
-        if (hc->permission & HAP_CHAR_PERM_WR) {
-            json_obj_get_bool(jctx, "r", &response);
+        hap_char_set_owner_ctrl((hap_char_t *)hc, index);
+        if (cnt != i) {
+            ctx->write_arr[cnt] = ctx->write_arr[i];
         }
+        ctx->write_arr[cnt].status = &ctx->status_arr[cnt];
+        ctx->status_arr[cnt] = HAP_STATUS_SUCCESS;
+        cnt++;
+    }
+    ctx->char_cnt = cnt;
+}
 
-        int index = hap_get_ctrl_session_index(session);
-        hap_char_set_owner_ctrl((hap_char_t *)hc, index);
-		/* No errors in the object data itself. Save the characteristic
-		 * pointer and value, to be used later
-		 */
-		write_arr[char_cnt].hc = (hap_char_t *)hc;
-		write_arr[char_cnt].val = val;
-        write_arr[char_cnt].auth_data = auth_data;
-        write_arr[char_cnt].remote = remote;
-        write_arr[char_cnt].write_response = response;
-        write_arr[char_cnt].status = &status_arr[char_cnt];
-		char_cnt++;
-	}
-	if (!char_cnt)
-		goto set_char_end;
+/* Invoke the service write routines for the first char_cnt saved characteristics
+ * and report the statuses
+ */
+static void hap_set_char_write(hap_set_char_ctx_t *ctx, int char_cnt)
+{
+    hap_write_data_t *write_arr = ctx->write_arr;
+    int i;
+    if (!char_cnt)
+        return;
 
 	/* The logic here is to loop through all the saved characteristic
 	 * pointers, and invoke a single write callback for all consecutive
@@ -865,6 +1365,8 @@ static int hap_http_handle_set_char(jparse_ctx_t *jctx, char *outbuf, int buf_si
 	bool write_err = false;
     bool write_response = false;
 	__hap_serv_t *hs = (__hap_serv_t *)hap_char_get_parent(write_arr[0].hc);
+    ctx->write_cnt = char_cnt;
+    hap_set_char_cur_ctx = ctx;
 	/* The counter here will go till char_cnt instead of char_cnt - 1.
 	 * When i == char_cnt, it will mean that all elements in the array
 	 * have been looped through.
@@ -889,8 +1391,10 @@ static int hap_http_handle_set_char(jparse_ctx_t *jctx, char *outbuf, int buf_si
 			 * Number of elements of the array are indicated by
 			 * i - hs_index
 			 */
+            ctx->cb_start = hs_index;
+            ctx->cb_cnt = i - hs_index;
 			if (hs->write_cb(&write_arr[hs_index], i - hs_index,
-					hs->priv, hap_platform_httpd_get_sess_ctx(req)) != HAP_SUCCESS)
+					hs->priv, ctx->session) != HAP_SUCCESS)
 				write_err = true;
 			if (i < char_cnt) {
 				hs = (__hap_serv_t *)hap_char_get_parent(write_arr[i].hc);
@@ -898,102 +1402,354 @@ static int hap_http_handle_set_char(jparse_ctx_t *jctx, char *outbuf, int buf_si
 			}
 		}
 	}
-	if (write_err || include_status || write_response) {
+    hap_set_char_cur_ctx = NULL;
+    if (ctx->pending) {
+        /* The response will be sent once the deferred writes complete */
+        hap_write_pending_arm(ctx);
+        return;
+    }
+	if (write_err || ctx->include_status || write_response) {
 		for (i = 0; i < char_cnt; i++) {
-            /* TODO: The code to get aid looks complex. Simplify */
             if (write_arr[i].write_response && (*write_arr[i].status == HAP_STATUS_SUCCESS)) {
-                hap_set_char_report_write_response(&include_status, &jstr,
-                        ((__hap_acc_t *)hap_serv_get_parent(hap_char_get_parent(write_arr[i].hc)))->aid,
+                hap_set_char_report_write_response(&ctx->include_status, &ctx->jstr,
+                        hap_set_char_get_aid(&write_arr[i]),
                         ((__hap_char_t *)(write_arr[i].hc))->iid, (__hap_char_t *)(write_arr[i].hc));
                 continue;
             }
-            hap_set_char_report_status(&include_status, &jstr,
-                    ((__hap_acc_t *)hap_serv_get_parent(hap_char_get_parent(write_arr[i].hc)))->aid,
+            hap_set_char_report_status(&ctx->include_status, &ctx->jstr,
+                    hap_set_char_get_aid(&write_arr[i]),
                     ((__hap_char_t *)(write_arr[i].hc))->iid, *write_arr[i].status);
 		}
 	}
+    if (ctx->stream) {
+        for (i = 0; i < char_cnt; i++) {
+            hap_set_char_free_val(&write_arr[i]);
+        }
+    }
+}
 
-	int ret = HAP_SUCCESS;
-set_char_end:
-	if (include_status) {
-		json_gen_pop_array(&jstr);
-		json_gen_end_object(&jstr);
-		json_gen_str_end(&jstr);
-		ret = HAP_FAIL;
-	}
-
-	if (write_arr) {
-		for (i = 0; i < char_cnt; i++) {
-			if (((__hap_char_t *)write_arr[i].hc)->format == HAP_CHAR_FORMAT_STRING) {
-				if (write_arr[i].val.s) {
-                    hap_platform_memory_free(write_arr[i].val.s);
-                }
-			} else if ((((__hap_char_t *)write_arr[i].hc)->format == HAP_CHAR_FORMAT_DATA) ||
-                    (((__hap_char_t *)write_arr[i].hc)->format == HAP_CHAR_FORMAT_TLV8)) {
-                    hap_platform_memory_free(write_arr[i].val.d.buf);
-            }
-            if (write_arr[i].auth_data.data) {
-                hap_platform_memory_free(write_arr[i].auth_data.data);
-            }
-		}
-	}
-	if (write_arr)
-		hap_platform_memory_free(write_arr);
-	if (status_arr)
-		hap_platform_memory_free(status_arr);
-	return ret;
+/* While parsing incrementally, the number of characteristics is not known up front,
+ * so the write array starts small and is grown as required. None of the writes can
+ * be executed before the complete request is parsed, since a "pid" following them
+ * can still make the request an invalid timed write, which must not change anything.
+ * Only the parsed writes are buffered, not the request itself.
+ */
+static int hap_set_char_grow(hap_set_char_ctx_t *ctx)
+{
+    int i, max_cnt = ctx->max_cnt * 2;
+    hap_write_data_t *write_arr = hap_platform_memory_calloc(max_cnt, sizeof(hap_write_data_t));
+    hap_status_t *status_arr = hap_platform_memory_calloc(max_cnt, sizeof(hap_status_t));
+    if (!write_arr || !status_arr) {
+        if (write_arr)
+            hap_platform_memory_free(write_arr);
+        if (status_arr)
+            hap_platform_memory_free(status_arr);
+        return HAP_FAIL;
+    }
+    memcpy(write_arr, ctx->write_arr, ctx->char_cnt * sizeof(hap_write_data_t));
+    memcpy(status_arr, ctx->status_arr, ctx->char_cnt * sizeof(hap_status_t));
+    for (i = 0; i < ctx->char_cnt; i++) {
+        write_arr[i].status = &status_arr[i];
+    }
+    hap_platform_memory_free(ctx->write_arr);
+    hap_platform_memory_free(ctx->status_arr);
+    ctx->write_arr = write_arr;
+    ctx->status_arr = status_arr;
+    ctx->max_cnt = max_cnt;
+    return HAP_SUCCESS;
 }
 
-static int hap_http_put_characteristics(httpd_req_t *req)
+/* Handles a single {aid,iid,value} object of the write request.
+ * Errors which can be detected without knowing whether this is a valid timed write are
+ * reported right away. All other objects are saved in the write array, along with their
+ * status, which is finalised in hap_set_char_validate_tw() once the "pid" is known,
+ * since it can be anywhere in the request.
+ * The string and data values point into the request buffer, which has been decoded in place.
+ */
+static int hap_set_char_handle_obj(hap_wp_obj_t *obj, void *priv)
 {
-    char stack_inbuf[512] = {0};
-    char outbuf[512] = {0};
-    char *heap_inbuf = NULL;
-    char *inbuf = stack_inbuf;
+    hap_set_char_ctx_t *ctx = (hap_set_char_ctx_t *)priv;
+    int aid = 0, iid = 0;
+    hap_wp_val_get_int(&obj->aid, &aid);
+    hap_wp_val_get_int(&obj->iid, &iid);
+    __hap_char_t *hc = (__hap_char_t *)hap_acc_get_char_by_aid_iid(aid, iid);
+    if (!hc) {
+        hap_set_char_report_status(&ctx->include_status, &ctx->jstr,
+                aid, iid, HAP_STATUS_RES_ABSENT);
+        return HAP_SUCCESS;
+    }
 
-    ESP_MFI_DEBUG_PLAIN("Socket fd: %d; HTTP Request %s %s\n", httpd_req_to_sockfd(req), hap_platform_httpd_get_req_method(req), hap_platform_httpd_get_req_uri(req));
-    hap_secure_session_t *session = (hap_secure_session_t *)hap_platform_httpd_get_sess_ctx(req);
-    if (!hap_is_req_secure(session)) {
-        return hap_http_session_not_authorized(req);
+    /* Check if this write is just to enable/disable event notifications.
+     * This is valid even for read-only characteristics that support event
+     * notifications (like sensor readings), so we do not check the HAP_CHAR_PERM_PW
+     * here.
+     */
+    bool ev;
+    if (hap_wp_val_get_bool(&obj->ev, &ev) == HAP_SUCCESS) {
+        if (hc->permission & HAP_CHAR_PERM_EV) {
+            int index = hap_get_ctrl_session_index(ctx->session);
+            hap_char_manage_notification((hap_char_t *)hc, index, ev);
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Events %s for aid=%d iid=%d",
+                    ev ? "Enabled" : "Disabled", aid, iid);
+        } else {
+            hap_set_char_report_status(&ctx->include_status, &ctx->jstr,
+                    aid, iid, HAP_STATUS_NO_NOTIF);
+        }
+        return HAP_SUCCESS;
     }
 
-    /* If received content is larger than the buffer on stack, allocate one from heap.
-     * This will mostly be required only in case of bridges, wherein there could be a request to
-     * control all/many accessories at once.
+    if ((ctx->char_cnt >= ctx->max_cnt) && ctx->stream) {
+        hap_set_char_grow(ctx);
+    }
+    if (ctx->char_cnt >= ctx->max_cnt) {
+        hap_set_char_report_status(&ctx->include_status, &ctx->jstr,
+                aid, iid, HAP_STATUS_OO_RES);
+        return HAP_SUCCESS;
+    }
+    hap_write_data_t *write_data = &ctx->write_arr[ctx->char_cnt];
+    hap_status_t *status = &ctx->status_arr[ctx->char_cnt];
+    memset(write_data, 0, sizeof(hap_write_data_t));
+    write_data->hc = (hap_char_t *)hc;
+    write_data->status = status;
+    ctx->char_cnt++;
+
+    /* Check if the characteristic has write permission */
+    if (!(hc->permission & HAP_CHAR_PERM_PW)) {
+        *status = HAP_STATUS_WR_ON_RDONLY;
+        return HAP_SUCCESS;
+    }
+    /* Check if the characteristic needs Authorization Data.
+     * Actual authData value will be read later.
      */
-    int content_len = hap_platform_httpd_get_content_len(req);
-    if (content_len > sizeof(stack_inbuf)) {
-        heap_inbuf = hap_platform_memory_calloc(content_len + 1, 1); /* Allocating an extra byte for NULL termination */
-        if (!heap_inbuf) {
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to read HTTPD Data");
-            httpd_resp_set_status(req, HTTPD_500);
-            return httpd_resp_send(req, NULL, 0);
+    if ((hc->permission & HAP_CHAR_PERM_AA) && (obj->auth_data.type != HAP_WP_VAL_STRING)) {
+        *status = HAP_STATUS_INSUFFICIENT_AUTH;
+        return HAP_SUCCESS;
+    }
+    /* If there is no write routine registered, there is no point of having
+     * this write request. Return an error.
+     */
+    if (!((__hap_serv_t *)(hap_char_get_parent((hap_char_t *)hc)))->write_cb) {
+        *status = HAP_STATUS_VAL_INVALID;
+        return HAP_SUCCESS;
+    }
+    hap_val_t val = {0};
+    if (hap_set_char_get_val(hc, &obj->value, &val) != HAP_SUCCESS) {
+        *status = HAP_STATUS_VAL_INVALID;
+        return HAP_SUCCESS;
+    }
+    /* Check if the value is within constraints */
+    if (hap_char_check_val_constraints(hc, &val) != HAP_SUCCESS) {
+        *status = HAP_STATUS_VAL_INVALID;
+        return HAP_SUCCESS;
+    }
+    write_data->val = val;
+    if (obj->auth_data.type == HAP_WP_VAL_STRING) {
+        uint32_t auth_len = 0;
+        if (hap_wp_val_get_data(&obj->auth_data, &write_data->auth_data.data,
+                    &auth_len) == HAP_SUCCESS) {
+            write_data->auth_data.len = auth_len;
         }
-        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Allocated buffer of size %d for the large PUT",
-                    content_len + 1)
-        inbuf = heap_inbuf;
     }
-	int data_len = hap_httpd_get_data(req, inbuf, content_len);
-	if (data_len < 0) {
+    if (ctx->stream && (hap_set_char_copy_val(write_data) != HAP_SUCCESS)) {
+        *status = HAP_STATUS_OO_RES;
+        return HAP_SUCCESS;
+    }
+    hap_wp_val_get_bool(&obj->remote, &write_data->remote);
+    if (hc->permission & HAP_CHAR_PERM_WR) {
+        hap_wp_val_get_bool(&obj->r, &write_data->write_response);
+    }
+    *status = HAP_STATUS_SUCCESS;
+    return HAP_SUCCESS;
+}
+
+/* An upper bound on the number of characteristic objects in the request, so that
+ * the write array can be allocated before parsing. Every object has an opening brace,
+ * apart from the top level one.
+ */
+static int hap_set_char_max_cnt(const char *inbuf, int data_len)
+{
+    int cnt = 0;
+    const char *p = inbuf;
+    const char *end = inbuf + data_len;
+    while ((p = memchr(p, '{', end - p)) != NULL) {
+        cnt++;
+        p++;
+    }
+    return cnt - 1;
+}
+
+/* Initial size of the write array, when the request is parsed incrementally */
+#define HAP_SET_CHAR_STREAM_BATCH   16
+
+#define HAP_SET_CHAR_BAD_REQ    -2
+#define HAP_SET_CHAR_DEFERRED   -3
+
+/* Parse a request which fits in inbuf in place */
+static int hap_set_char_parse(hap_set_char_ctx_t *ctx, char *inbuf, int content_len)
+{
+	int data_len = hap_httpd_get_data(ctx->req, inbuf, content_len);
+	if (data_len != content_len) {
 		ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to read HTTPD Data");
-		httpd_resp_set_status(req, HTTPD_500);
-        if (heap_inbuf) {
-            hap_platform_memory_free(heap_inbuf);
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Freed allocated buffer for PUT");
+        return HAP_SET_CHAR_BAD_REQ;
+    }
+    ESP_MFI_DEBUG_PLAIN("Data Received: %.*s\n", data_len, inbuf);
+    ctx->max_cnt = hap_set_char_max_cnt(inbuf, data_len);
+    if (ctx->max_cnt < 0)
+        return HAP_SET_CHAR_BAD_REQ;
+    if (ctx->max_cnt == 0)
+        return HAP_FAIL;
+    ctx->write_arr = hap_platform_memory_calloc(ctx->max_cnt, sizeof(hap_write_data_t));
+	ctx->status_arr = hap_platform_memory_calloc(ctx->max_cnt, sizeof(hap_status_t));
+	if (!ctx->write_arr || !ctx->status_arr)
+        return HAP_SET_CHAR_BAD_REQ;
+
+    int64_t pid = 0;
+    bool pid_found = false;
+    if (hap_wp_parse(inbuf, data_len, hap_set_char_handle_obj, ctx, &pid, &pid_found) != HAP_SUCCESS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to parse HTTPD JSON Data");
+        return HAP_SET_CHAR_BAD_REQ;
+    }
+    if (pid_found) {
+        hap_set_char_check_tw(ctx, pid);
+    }
+    return HAP_SUCCESS;
+}
+
+/* Parse a request larger than inbuf as it gets received, one chunk at a time */
+static int hap_set_char_parse_stream(hap_set_char_ctx_t *ctx, char *inbuf, int inbuf_size,
+        int content_len)
+{
+    hap_wp_stream_t stream;
+    int ret = HAP_SUCCESS;
+
+    ctx->max_cnt = HAP_SET_CHAR_STREAM_BATCH;
+    ctx->write_arr = hap_platform_memory_calloc(ctx->max_cnt, sizeof(hap_write_data_t));
+	ctx->status_arr = hap_platform_memory_calloc(ctx->max_cnt, sizeof(hap_status_t));
+	if (!ctx->write_arr || !ctx->status_arr)
+        return HAP_SET_CHAR_BAD_REQ;
+
+    hap_wp_stream_init(&stream, content_len, hap_set_char_handle_obj, ctx);
+    ctx->stream = &stream;
+    ESP_MFI_DEBUG_PLAIN("Data Received: ");
+    int remaining = content_len;
+    while (remaining > 0) {
+        int len = remaining < inbuf_size ? remaining : inbuf_size;
+        if (hap_httpd_get_data(ctx->req, inbuf, len) != len) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to read HTTPD Data");
+            ret = HAP_SET_CHAR_BAD_REQ;
+            break;
         }
-		return httpd_resp_send(req, NULL, 0);
-	}
-    ESP_MFI_DEBUG_PLAIN("Data Received: %s\n", inbuf);
-	jparse_ctx_t jctx;
-	if (json_parse_start(&jctx, inbuf, data_len) != HAP_SUCCESS) {
-		ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to parse HTTPD JSON Data");
-		httpd_resp_set_status(req, HTTPD_500);
-        if (heap_inbuf) {
-            hap_platform_memory_free(heap_inbuf);
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Freed allocated buffer for PUT");
+        ESP_MFI_DEBUG_PLAIN("%.*s", len, inbuf);
+        if (hap_wp_stream_feed(&stream, inbuf, len) != HAP_SUCCESS) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to parse HTTPD JSON Data");
+            ret = HAP_SET_CHAR_BAD_REQ;
+            break;
         }
-		return httpd_resp_send(req, NULL, 0);
+        remaining -= len;
+    }
+    ESP_MFI_DEBUG_PLAIN("\n");
+    if ((hap_wp_stream_end(&stream) != HAP_SUCCESS) && (ret == HAP_SUCCESS)) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Incomplete HTTPD JSON Data");
+        ret = HAP_SET_CHAR_BAD_REQ;
+    }
+    if (stream.pid_found) {
+        hap_set_char_check_tw(ctx, stream.pid);
+    }
+    return ret;
+}
+
+/* Reads and parses the write request and handles the writes.
+ *
+ * Returns HAP_SUCCESS if all writes succeeded, HAP_FAIL if a status response was
+ * generated, HAP_SET_CHAR_BAD_REQ if the request could not be read or parsed, and
+ * HAP_SET_CHAR_DEFERRED if the response will be sent once the deferred writes complete.
+ */
+static int hap_http_handle_set_char(char *inbuf, int inbuf_size, char *outbuf, int buf_size,
+		httpd_req_t *req)
+{
+    int ret;
+	hap_secure_session_t *session = (hap_secure_session_t *)hap_platform_httpd_get_sess_ctx(req);
+    if (!session)
+        return HAP_FAIL;
+
+    hap_set_char_ctx_t ctx = {
+        .req = req,
+        .session = session,
+        .cur_time = esp_timer_get_time() / 1000,
+        .prepare_time = session->prepare_time,
+    };
+    if (ctx.prepare_time) {
+        /* If prepare time is non zero, it means that a prepare was received
+         * before this request, and so this write needs to be timed write
+         */
+        ctx.req_tw = true;
+        /* Reset prepare_time to 0, since a prepare is valid only for the immediate
+         * following write
+         */
+        session->prepare_time = 0;
+    }
+
+	json_gen_str_start(&ctx.jstr, outbuf, buf_size, hap_http_json_flush_chunk, req);
+#ifdef ESP_MFI_DEBUG_ENABLE
+    int64_t parse_start_time = esp_timer_get_time();
+#endif /* ESP_MFI_DEBUG_ENABLE */
+	/* Loop through all characteristic objects {aid,iid,value}, handle
+	 * errors if any, and if there are no errors, put the characteristic
+	 * pointer and value in an array (with char_cnt)
+	 */
+    int content_len = hap_platform_httpd_get_content_len(req);
+    if (content_len <= inbuf_size) {
+        ret = hap_set_char_parse(&ctx, inbuf, content_len);
+    } else {
+        /* This will mostly be required only in case of bridges, wherein there could be a
+         * request to control all/many accessories at once.
+         */
+        ret = hap_set_char_parse_stream(&ctx, inbuf, inbuf_size, content_len);
+    }
+#ifdef ESP_MFI_DEBUG_ENABLE
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Write request: %d bytes parsed in %d us",
+            content_len, (int)(esp_timer_get_time() - parse_start_time));
+#endif /* ESP_MFI_DEBUG_ENABLE */
+    /* Resetting the values so that the session is ready for next prepare or write */
+    session->pid = 0;
+    session->ttl = 0;
+
+    if (ret == HAP_SUCCESS) {
+        hap_set_char_validate_tw(&ctx);
+        hap_set_char_write(&ctx, ctx.char_cnt);
+    } else if (ctx.stream) {
+        /* Do not execute any pending writes from a malformed request */
+        int i;
+        for (i = 0; i < ctx.char_cnt; i++) {
+            hap_set_char_free_val(&ctx.write_arr[i]);
+        }
+    }
+
+	if (ctx.pending) {
+		ret = HAP_SET_CHAR_DEFERRED;
+	} else if (ctx.include_status) {
+		json_gen_pop_array(&ctx.jstr);
+		json_gen_end_object(&ctx.jstr);
+		json_gen_str_end(&ctx.jstr);
+		ret = HAP_FAIL;
 	}
+	if (ctx.write_arr)
+		hap_platform_memory_free(ctx.write_arr);
+	if (ctx.status_arr)
+		hap_platform_memory_free(ctx.status_arr);
+	return ret;
+}
+
+static int __hap_http_put_characteristics(httpd_req_t *req)
+{
+    char inbuf[512];
+    char outbuf[512] = {0};
+
+    ESP_MFI_DEBUG_PLAIN("Socket fd: %d; HTTP Request %s %s\n", httpd_req_to_sockfd(req), hap_platform_httpd_get_req_method(req), hap_platform_httpd_get_req_uri(req));
+    hap_secure_session_t *session = (hap_secure_session_t *)hap_platform_httpd_get_sess_ctx(req);
+    if (!hap_is_req_secure(session)) {
+        return hap_http_session_not_authorized(req);
+    }
 
 	httpd_resp_set_type(req, "application/hap+json");
 	/* Setting response type to indicate error.
@@ -1002,10 +1758,21 @@ static int hap_http_put_characteristics(httpd_req_t *req)
 	 * Else, the response type will be set to 204
 	 */
 	httpd_resp_set_status(req, HTTPD_207);
-	if (hap_http_handle_set_char(&jctx, outbuf, sizeof(outbuf), req) == HAP_SUCCESS)
-	{
+    /* Requests larger than inbuf are parsed as they are received, instead of
+     * allocating a buffer for the complete request.
+     */
+    int ret = hap_http_handle_set_char(inbuf, sizeof(inbuf), outbuf, sizeof(outbuf), req);
+	if (ret == HAP_SUCCESS) {
 		snprintf(outbuf, sizeof(outbuf), "HTTP/1.1 %s\r\n\r\n", HTTPD_204);
 		httpd_send(req, outbuf, strlen(outbuf));
+	} else if (ret == HAP_SET_CHAR_BAD_REQ) {
+		httpd_resp_set_status(req, HTTPD_500);
+		httpd_resp_send(req, NULL, 0);
+	} else if (ret == HAP_SET_CHAR_DEFERRED) {
+        /* Nothing to be sent now. The response is sent, and the event reported,
+         * once the deferred writes complete.
+         */
+        return HAP_SUCCESS;
 	} else {
         /* If a failure was encountered, it would mean that a response has been generated,
          * which will be chunk encoded. So, sending the last chunk here and also printing
@@ -1014,12 +1781,6 @@ static int hap_http_put_characteristics(httpd_req_t *req)
         httpd_resp_send_chunk(req, NULL, 0);
         ESP_MFI_DEBUG_PLAIN("\n");
     }
-    json_parse_end(&jctx);
-
-    if (heap_inbuf) {
-        hap_platform_memory_free(heap_inbuf);
-        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Freed allocated buffer for PUT");
-    }
 
     hap_report_event(HAP_EVENT_SET_CHAR_COMPLETED, NULL, 0);
     return HAP_SUCCESS;
@@ -1035,7 +1796,7 @@ static bool hap_get_bool_url_param(char *query_str, char *key)
 	return false;
 }
 
-static int hap_http_get_characteristics(httpd_req_t *req)
+static int __hap_http_get_characteristics(httpd_req_t *req)
 {
     char outbuf[512];
     char stack_val_buf[512] = {0};
@@ -1153,7 +1914,7 @@ static int hap_http_get_characteristics(httpd_req_t *req)
 		p = strsep(&val_ptr, ",");
 		iid = atoi(p);
 		p = strsep(&val_ptr, ".");
-		hap_char_t *hc = hap_acc_get_char_by_iid(hap_acc_get_by_aid(aid), iid);
+		hap_char_t *hc = hap_acc_get_char_by_aid_iid(aid, iid);
 		if (!hc) {
 			hap_set_char_report_status(&include_status, &jstr,
 					aid, iid, HAP_STATUS_RES_ABSENT);
@@ -1242,7 +2003,7 @@ static int hap_http_get_characteristics(httpd_req_t *req)
         } else {
             /* Include "value" only if status is SUCCESS */
             if (*read_arr[i].status == HAP_STATUS_SUCCESS) {
-                hap_add_char_val_json(hc->format, "value", &hc->val, &jstr);
+                hap_add_char_val_json(hc->format, "value", &hc->val, hap_char_get_float_step(hc), &jstr);
             }
         }
 		/* Include status only if it was already included because of
@@ -1287,6 +2048,28 @@ get_char_return:
     hap_report_event(HAP_EVENT_GET_CHAR_COMPLETED, NULL, 0);
 	return HAP_SUCCESS;
 }
+
+/* The /characteristics responses are sent with the socket corked, so that the
+ * HTTP headers, chunk sizes and data are packed into as few frames as possible.
+ */
+static int hap_http_get_characteristics(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    hap_httpd_cork(fd);
+    int ret = __hap_http_get_characteristics(req);
+    hap_httpd_uncork(fd);
+    return ret;
+}
+
+static int hap_http_put_characteristics(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    hap_httpd_cork(fd);
+    int ret = __hap_http_put_characteristics(req);
+    hap_httpd_uncork(fd);
+    return ret;
+}
+
 static struct httpd_uri hap_characteristics_get = {
 	.uri = "/characteristics",
     .method = HTTP_GET,
@@ -1393,6 +2176,62 @@ static struct httpd_uri hap_prepare = {
     .handler = hap_http_put_prepare,
 };
 
+#define HTTPD_HDR_STR      "EVENT/1.0 200 OK\r\n"                   \
+		"Content-Type: application/hap+json\r\n"           \
+		"Content-Length: %d\r\n"
+
+/* Sessions which have to be sent the same notification */
+typedef struct {
+    int fds[HAP_MAX_SESSIONS];
+    int cnt;
+    int len;
+    int flush_cnt;
+} hap_notif_group_t;
+
+static void hap_notif_json_count_cb(char *data, void *priv)
+{
+    hap_notif_group_t *group = (hap_notif_group_t *)priv;
+    group->len += strlen(data);
+    group->flush_cnt++;
+}
+
+static void hap_notif_json_send_cb(char *data, void *priv)
+{
+    hap_notif_group_t *group = (hap_notif_group_t *)priv;
+    hap_iovec_t iov = {
+        .buf = data,
+        .len = strlen(data),
+    };
+    int i;
+    for (i = 0; i < group->cnt; i++) {
+        if ((group->fds[i] >= 0) && (hap_httpd_sendv(hap_priv.server, group->fds[i], &iov, 1, 0) < 0)) {
+            group->fds[i] = -1;
+        }
+    }
+}
+
+static void hap_prepare_notif_json(json_gen_str_t *jstr, hap_char_t **char_arr, int num_notif_chars, uint32_t *mask)
+{
+    json_gen_start_object(jstr);
+    json_gen_push_array(jstr, "characteristics");
+    int j;
+    for (j = 0; j < num_notif_chars; j++) {
+        if (!(mask[j / 32] & (1U << (j % 32)))) {
+            continue;
+        }
+        __hap_char_t *_hc = (__hap_char_t *)char_arr[j];
+        json_gen_start_object(jstr);
+        hap_acc_t *ha = hap_serv_get_parent(hap_char_get_parent(char_arr[j]));
+        json_gen_obj_set_int(jstr, "aid", ((__hap_acc_t *)ha)->aid);
+        json_gen_obj_set_int(jstr, "iid", _hc->iid);
+        hap_add_char_val_json(_hc->format, "value", &_hc->val, hap_char_get_float_step(_hc), jstr);
+        json_gen_end_object(jstr);
+    }
+    json_gen_pop_array(jstr);
+    json_gen_end_object(jstr);
+    json_gen_str_end(jstr);
+}
+
 static void hap_send_notification(void *arg)
 {
     int num_char = hap_priv.cfg.max_event_notif_chars;
@@ -1400,86 +2239,122 @@ static void hap_send_notification(void *arg)
     hap_char_t **char_arr = hap_platform_memory_calloc(num_char, sizeof(hap_char_t *));
 
     if (!char_arr) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to allocate memory for notifications");
+        hap_drop_pending_notif_chars();
         return;
     }
 
-    int i, num_notif_chars;
-    for (i = 0; i < num_char; i++) {
-        hc = hap_get_pending_notif_char();
-        if (hc) {
-            char_arr[i] = hc;
-        } else {
-            break;
-        }
-    }
+    int i, j, num_notif_chars;
+    int64_t start_time = esp_timer_get_time();
+    num_notif_chars = hap_get_pending_notif_chars(char_arr, num_char);
     /* If no characteristic notifications are pending, free char_arr and exit */ 
-    if (i == 0) {
+    if (num_notif_chars == 0) {
 	hap_platform_memory_free(char_arr); 
         return;
     }
-    num_notif_chars = i;
+    /* Bitmap per session, indicating the characteristics to be notified to it */
+    int mask_words = (num_notif_chars + 31) / 32;
+    uint32_t *masks = hap_platform_memory_calloc(HAP_MAX_SESSIONS * mask_words, sizeof(uint32_t));
+    if (!masks) {
+        hap_notif_stats_add(0, num_notif_chars);
+        hap_platform_memory_free(char_arr);
+        return;
+    }
 	hap_secure_session_t *session;
     /* Flag to indicate if any controller was connected */
     bool ctrl_connected = false;
-	char buf[250];
+    int notif_cnt[HAP_MAX_SESSIONS] = {0};
 	for (i = 0; i < HAP_MAX_SESSIONS; i++) {
 		session = hap_priv.sessions[i];
 		if (!session)
 			continue;
         ctrl_connected = true;
-		int fd = session->conn_identifier;
-#define HTTPD_HDR_STR      "EVENT/1.0 200 OK\r\n"                   \
-		"Content-Type: application/hap+json\r\n"           \
-		"Content-Length: %d\r\n"
-		char notif_json[1024];
-		json_gen_str_t jstr;
-		json_gen_str_start(&jstr, notif_json, sizeof(notif_json), NULL, NULL);
-		json_gen_start_object(&jstr);
-		json_gen_push_array(&jstr, "characteristics");
-
-        int j;
-        bool notif_to_send = false;
         for (j = 0; j < num_notif_chars; j++) {
             hc = char_arr[j];
-            __hap_char_t *_hc = ( __hap_char_t *)hc;
             /* If the controller is the owner, dont send notification to it */
             if (hap_char_is_ctrl_owner(hc, i)) {
-                /* Since there can be only one owner, which we are anyways skipping,
-                 * we can reset owner value to 0
-                 */
-                _hc->owner_ctrl = 0;
                 continue;
             }
             if (!hap_char_is_ctrl_subscribed(hc, i))
                 continue;
-
-            json_gen_start_object(&jstr);
-            hap_acc_t *ha = hap_serv_get_parent(hap_char_get_parent(hc));
-            int aid = ((__hap_acc_t *)ha)->aid;
-            json_gen_obj_set_int(&jstr, "aid", aid);
-            json_gen_obj_set_int(&jstr, "iid", _hc->iid);
-            hap_add_char_val_json(_hc->format, "value", &_hc->val, &jstr);
-            json_gen_end_object(&jstr);
-            notif_to_send = true;
+            masks[i * mask_words + j / 32] |= (1U << (j % 32));
+            notif_cnt[i]++;
         }
-        if (!notif_to_send) {
+    }
+    for (j = 0; j < num_notif_chars; j++) {
+        __hap_char_t *_hc = (__hap_char_t *)char_arr[j];
+        /* Since there can be only one owner, which we are anyways skipping,
+         * we can reset owner value to 0
+         */
+        for (i = 0; i < HAP_MAX_SESSIONS; i++) {
+            if (hap_priv.sessions[i] && hap_char_is_ctrl_owner(char_arr[j], i)) {
+                _hc->owner_ctrl = 0;
+                break;
+            }
+        }
+    }
+
+	char buf[250];
+    bool grouped[HAP_MAX_SESSIONS] = {0};
+    int num_groups = 0;
+	for (i = 0; i < HAP_MAX_SESSIONS; i++) {
+        if (!hap_priv.sessions[i] || grouped[i] || !notif_cnt[i]) {
             /* No notification required for this controller. Just continue */
             continue;
         }
-
-        json_gen_pop_array(&jstr);
-		json_gen_end_object(&jstr);
-		json_gen_str_end(&jstr);
-
-		snprintf(buf, sizeof(buf), HTTPD_HDR_STR,
-				strlen(notif_json));
-		hap_httpd_send(hap_priv.server, fd, buf, strlen(buf), 0);
-		/* Space for sending additional headers based on set_header */
-		hap_httpd_send(hap_priv.server, fd, "\r\n", strlen("\r\n"), 0);
-		hap_httpd_send(hap_priv.server, fd, notif_json, strlen(notif_json), 0);
-        httpd_sess_update_lru_counter(hap_priv.server, fd);
-		ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Notification Sent");
-        ESP_MFI_DEBUG_PLAIN("Socket fd: %d; Event message: %s\n", fd, notif_json);
+        /* Group all the sessions which need exactly the same notification, so that
+         * the notification is generated only once.
+         */
+        hap_notif_group_t group = {0};
+        num_groups++;
+        for (j = i; j < HAP_MAX_SESSIONS; j++) {
+            if (hap_priv.sessions[j] && !grouped[j] &&
+                    !memcmp(&masks[i * mask_words], &masks[j * mask_words], mask_words * sizeof(uint32_t))) {
+                grouped[j] = true;
+                group.fds[group.cnt++] = hap_priv.sessions[j]->conn_identifier;
+            }
+        }
+		char notif_json[1024];
+		json_gen_str_t jstr;
+        /* Generate the notification once to get its length. If it fits in the buffer,
+         * it is sent as is. Else, it is generated again and streamed.
+         */
+		json_gen_str_start(&jstr, notif_json, sizeof(notif_json), hap_notif_json_count_cb, &group);
+        hap_prepare_notif_json(&jstr, char_arr, num_notif_chars, &masks[i * mask_words]);
+
+		snprintf(buf, sizeof(buf), HTTPD_HDR_STR "\r\n", group.len);
+        for (j = 0; j < group.cnt; j++) {
+		    /* Space for sending additional headers based on set_header */
+            hap_iovec_t iov[] = {
+                {
+                    .buf = buf,
+                    .len = strlen(buf),
+                },
+                {
+                    .buf = notif_json,
+                    .len = (group.flush_cnt == 1) ? group.len : 0,
+                },
+            };
+            /* Send the headers and the body together, so that they go out in a single frame */
+            if (hap_httpd_sendv(hap_priv.server, group.fds[j], iov, sizeof(iov) / sizeof(iov[0]), 0) < 0) {
+                group.fds[j] = -1;
+            }
+        }
+        if (group.flush_cnt > 1) {
+            json_gen_str_start(&jstr, notif_json, sizeof(notif_json), hap_notif_json_send_cb, &group);
+            hap_prepare_notif_json(&jstr, char_arr, num_notif_chars, &masks[i * mask_words]);
+        }
+        for (j = 0; j < group.cnt; j++) {
+            if (group.fds[j] < 0) {
+                hap_notif_stats_add(0, notif_cnt[i]);
+                continue;
+            }
+            hap_notif_stats_add(notif_cnt[i], 0);
+            httpd_sess_update_lru_counter(hap_priv.server, group.fds[j]);
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Notification Sent");
+            ESP_MFI_DEBUG_PLAIN("Socket fd: %d; Event message: %s\n", group.fds[j],
+                    (group.flush_cnt == 1) ? notif_json : "<streamed>");
+        }
 	}
     /* If no controller was connected and no disconnected event was sent,
      * reannaounce mDNS. That will increment state number as required
@@ -1489,6 +2364,9 @@ static void hap_send_notification(void *arg)
         hap_mdns_announce(false);
         hap_priv.disconnected_event_sent = true;
     }
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Notified %d characteristics with %d distinct message(s) in %d us",
+            num_notif_chars, num_groups, (int)(esp_timer_get_time() - start_time));
+    hap_platform_memory_free(masks);
     hap_platform_memory_free(char_arr);
 }
 
@@ -1562,6 +2440,9 @@ httpd_handle_t * hap_httpd_get_handle()
 }
 static bool first_announce_done;
 
+/* This does not wait for the goodbye packets to go out on the network. Callers
+ * which take the network down afterwards should wait for HAP_MDNS_DEANNOUNCE_WAIT_MS.
+ */
 int hap_mdns_deannounce(void)
 {
     int ret = HAP_SUCCESS;
@@ -1569,8 +2450,6 @@ int hap_mdns_deannounce(void)
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Deannouncing _hap._tcp mDNS service");
         ret = hap_mdns_serv_stop(&hap_priv.hap_mdns_handle);
         if (ret == HAP_SUCCESS) {
-            /* Wait for some time for the packets to go out on network */
-            vTaskDelay(2000 / hap_platform_os_get_msec_per_tick());
             first_announce_done = false;
         }
     }
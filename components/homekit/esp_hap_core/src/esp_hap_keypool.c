@@ -0,0 +1,194 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <sodium/crypto_scalarmult_curve25519.h>
+#include <sodium/utils.h>
+#include <hap.h>
+
+#include <esp_hap_pair_common.h>
+#include <esp_hap_pair_setup.h>
+#include <esp_hap_controllers.h>
+#include <esp_hap_keypool.h>
+#include <esp_mfi_debug.h>
+#include <esp_mfi_rand.h>
+
+#define HAP_KEYPOOL_TASK_STACK      (4 * 1024)
+#define HAP_KEYPOOL_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+
+#if (CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0) || (CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0)
+#define HAP_KEYPOOL_ENABLED
+#endif
+
+static SemaphoreHandle_t hap_keypool_mutex;
+static TaskHandle_t hap_keypool_task_handle;
+
+typedef struct {
+    uint8_t sk[CURVE_KEY_LEN];
+    uint8_t pk[CURVE_KEY_LEN];
+} hap_curve_key_t;
+
+#if CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0
+static hap_curve_key_t hap_curve_pool[CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE];
+static int hap_curve_pool_cnt;
+#endif /* CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0 */
+static hap_key_pool_stats_t hap_curve_pool_stats;
+
+void hap_keypool_lock(void)
+{
+    if (hap_keypool_mutex) {
+        xSemaphoreTake(hap_keypool_mutex, portMAX_DELAY);
+    }
+}
+
+void hap_keypool_unlock(void)
+{
+    if (hap_keypool_mutex) {
+        xSemaphoreGive(hap_keypool_mutex);
+    }
+}
+
+void hap_keypool_refill(void)
+{
+    if (hap_keypool_task_handle) {
+        xTaskNotifyGive(hap_keypool_task_handle);
+    }
+}
+
+bool hap_curve_keypool_take(uint8_t *sk, uint8_t *pk)
+{
+    bool found = false;
+    hap_keypool_lock();
+#if CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0
+    if (hap_curve_pool_cnt > 0) {
+        hap_curve_pool_cnt--;
+        hap_curve_key_t *key = &hap_curve_pool[hap_curve_pool_cnt];
+        memcpy(sk, key->sk, CURVE_KEY_LEN);
+        memcpy(pk, key->pk, CURVE_KEY_LEN);
+        sodium_memzero(key, sizeof(*key));
+        found = true;
+    }
+#endif /* CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0 */
+    if (found) {
+        hap_curve_pool_stats.hits++;
+    } else {
+        hap_curve_pool_stats.misses++;
+    }
+    hap_keypool_unlock();
+    if (found) {
+        hap_keypool_refill();
+    }
+    return found;
+}
+
+void hap_get_pair_verify_key_pool_stats(hap_key_pool_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    hap_keypool_lock();
+    memcpy(stats, &hap_curve_pool_stats, sizeof(hap_key_pool_stats_t));
+    hap_keypool_unlock();
+}
+
+#ifdef HAP_KEYPOOL_ENABLED
+#if CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0
+static int hap_curve_key_generate(hap_curve_key_t *key)
+{
+    /* This particular value of basepoint is required to generate the public key
+     * from secret key
+     */
+    uint8_t basepoint[32] = {9};
+    esp_mfi_get_random(key->sk, CURVE_KEY_LEN);
+    if (crypto_scalarmult_curve25519(key->pk, key->sk, basepoint) == -1) {
+        sodium_memzero(key, sizeof(*key));
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
+}
+
+#endif /* CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0 */
+
+/* Pair Verify is only possible once paired, so keys are generated only then */
+static void hap_curve_keypool_fill(void)
+{
+#if CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0
+    while (is_accessory_paired()) {
+        hap_keypool_lock();
+        int cnt = hap_curve_pool_cnt;
+        hap_keypool_unlock();
+        if (cnt >= CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE) {
+            break;
+        }
+        hap_curve_key_t key;
+        if (hap_curve_key_generate(&key) != HAP_SUCCESS) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to pre-generate Curve25519 key");
+            break;
+        }
+        hap_keypool_lock();
+        if (hap_curve_pool_cnt < CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE) {
+            memcpy(&hap_curve_pool[hap_curve_pool_cnt++], &key, sizeof(key));
+        }
+        hap_keypool_unlock();
+        sodium_memzero(&key, sizeof(key));
+    }
+#endif /* CONFIG_HAP_PAIR_VERIFY_KEY_POOL_SIZE > 0 */
+}
+
+static void hap_keypool_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        /* Pair Verify keys first, since they are quick and needed on every reconnect */
+        hap_curve_keypool_fill();
+        hap_srp_pool_update();
+    }
+}
+#endif /* HAP_KEYPOOL_ENABLED */
+
+int hap_keypool_init(void)
+{
+#ifdef HAP_KEYPOOL_ENABLED
+    if (hap_keypool_task_handle) {
+        return HAP_SUCCESS;
+    }
+    hap_keypool_mutex = xSemaphoreCreateMutex();
+    if (!hap_keypool_mutex) {
+        return HAP_FAIL;
+    }
+    if (xTaskCreate(hap_keypool_task, "hap-keypool", HAP_KEYPOOL_TASK_STACK, NULL,
+                HAP_KEYPOOL_TASK_PRIORITY, &hap_keypool_task_handle) != pdPASS) {
+        vSemaphoreDelete(hap_keypool_mutex);
+        hap_keypool_mutex = NULL;
+        hap_keypool_task_handle = NULL;
+        return HAP_FAIL;
+    }
+    hap_keypool_refill();
+#endif /* HAP_KEYPOOL_ENABLED */
+    return HAP_SUCCESS;
+}
@@ -21,14 +21,36 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *
  */
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/timers.h>
 #include <hap.h>
 #include <esp_mfi_debug.h>
 #include <hap_platform_keystore.h>
+#include <hap_platform_os.h>
+#include <esp_hap_main.h>
 
 static bool keystore_init_done;
 static char *hap_platform_nvs_partition;
 static char *hap_platform_factory_nvs_partition;
 
+/* Small values which change often, but need not be written immediately */
+#define HAP_KEYSTORE_DEFERRED_MAX       4
+#define HAP_KEYSTORE_DEFERRED_VAL_LEN   8
+#define HAP_KEYSTORE_DEFERRED_DELAY_MS  (CONFIG_HAP_KEYSTORE_WRITE_BEHIND_DELAY * 1000)
+
+typedef struct {
+    const char *name_space;
+    const char *key;
+    uint8_t val[HAP_KEYSTORE_DEFERRED_VAL_LEN];
+    size_t val_len;
+} hap_keystore_deferred_t;
+
+static hap_keystore_deferred_t deferred_writes[HAP_KEYSTORE_DEFERRED_MAX];
+static SemaphoreHandle_t deferred_lock;
+static TimerHandle_t deferred_timer;
+
 int hap_keystore_init()
 {
     if (keystore_init_done) {
@@ -45,6 +67,7 @@ int hap_keystore_init()
     hap_platform_factory_nvs_partition = hap_platform_keystore_get_factory_nvs_partition_name();
     hap_platform_keystore_init_partition(hap_platform_factory_nvs_partition, true);
 
+    deferred_lock = xSemaphoreCreateMutex();
     keystore_init_done = true;
     ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Keystore initialised");
     return HAP_SUCCESS;
@@ -62,9 +85,47 @@ int __hap_keystore_get(const char *part_name, const char *name_space, const char
     }
     return HAP_SUCCESS;
 }
-int hap_keystore_get(const char *name_space, const char *key, uint8_t *val, size_t *val_size)
+static hap_keystore_deferred_t *hap_keystore_deferred_find(const char *name_space, const char *key)
 {
+    int i;
+    for (i = 0; i < HAP_KEYSTORE_DEFERRED_MAX; i++) {
+        if (deferred_writes[i].key && !strcmp(deferred_writes[i].name_space, name_space)
+                && !strcmp(deferred_writes[i].key, key)) {
+            return &deferred_writes[i];
+        }
+    }
+    return NULL;
+}
 
+static void hap_keystore_deferred_drop(const char *name_space, const char *key)
+{
+    if (!deferred_lock) {
+        return;
+    }
+    xSemaphoreTake(deferred_lock, portMAX_DELAY);
+    int i;
+    for (i = 0; i < HAP_KEYSTORE_DEFERRED_MAX; i++) {
+        if (deferred_writes[i].key && (!name_space || !strcmp(deferred_writes[i].name_space, name_space))
+                && (!key || !strcmp(deferred_writes[i].key, key))) {
+            memset(&deferred_writes[i], 0, sizeof(hap_keystore_deferred_t));
+        }
+    }
+    xSemaphoreGive(deferred_lock);
+}
+
+int hap_keystore_get(const char *name_space, const char *key, uint8_t *val, size_t *val_size)
+{
+    if (deferred_lock) {
+        xSemaphoreTake(deferred_lock, portMAX_DELAY);
+        hap_keystore_deferred_t *entry = hap_keystore_deferred_find(name_space, key);
+        if (entry && *val_size >= entry->val_len) {
+            memcpy(val, entry->val, entry->val_len);
+            *val_size = entry->val_len;
+            xSemaphoreGive(deferred_lock);
+            return HAP_SUCCESS;
+        }
+        xSemaphoreGive(deferred_lock);
+    }
     return __hap_keystore_get(hap_platform_nvs_partition, name_space, key, val, val_size);
 }
 int hap_factory_keystore_get(const char *name_space, const char *key, uint8_t *val, size_t *val_size)
@@ -88,9 +149,89 @@ int __hap_keystore_set(const char *part_name, const char *name_space, const char
 
 int hap_keystore_set(const char *name_space, const char *key, const uint8_t *val, const size_t val_len)
 {
+    /* A pending deferred value must not overwrite this one later */
+    hap_keystore_deferred_drop(name_space, key);
     return __hap_keystore_set(hap_platform_nvs_partition, name_space, key, val, val_len);
 }
 
+static void hap_keystore_deferred_timer_cb(TimerHandle_t handle)
+{
+    /* Write from the HAP loop, rather than the timer task, which has a small stack.
+     * If the loop is not running yet, try again later.
+     */
+    if (hap_send_event(HAP_INTERNAL_EVENT_KEYSTORE_FLUSH) != HAP_SUCCESS) {
+        xTimerReset(handle, 0);
+    }
+}
+
+/* The value is held in RAM and written after CONFIG_HAP_KEYSTORE_WRITE_BEHIND_DELAY
+ * seconds, so that frequent updates cost a single flash write. Use only for values
+ * whose loss on a power cut is harmless.
+ */
+int hap_keystore_set_deferred(const char *name_space, const char *key, const uint8_t *val, const size_t val_len)
+{
+    if (!keystore_init_done) {
+        return HAP_FAIL;
+    }
+    if (HAP_KEYSTORE_DEFERRED_DELAY_MS == 0 || val_len > HAP_KEYSTORE_DEFERRED_VAL_LEN) {
+        return hap_keystore_set(name_space, key, val, val_len);
+    }
+    if (!deferred_timer) {
+        deferred_timer = xTimerCreate("hap_ks_flush_timer",
+                HAP_KEYSTORE_DEFERRED_DELAY_MS / hap_platform_os_get_msec_per_tick(),
+                pdFALSE, NULL, hap_keystore_deferred_timer_cb);
+    }
+    xSemaphoreTake(deferred_lock, portMAX_DELAY);
+    hap_keystore_deferred_t *entry = hap_keystore_deferred_find(name_space, key);
+    int i;
+    for (i = 0; !entry && i < HAP_KEYSTORE_DEFERRED_MAX; i++) {
+        if (!deferred_writes[i].key) {
+            entry = &deferred_writes[i];
+        }
+    }
+    if (!entry || !deferred_timer) {
+        xSemaphoreGive(deferred_lock);
+        return hap_keystore_set(name_space, key, val, val_len);
+    }
+    entry->name_space = name_space;
+    entry->key = key;
+    memcpy(entry->val, val, val_len);
+    entry->val_len = val_len;
+    xSemaphoreGive(deferred_lock);
+    /* Do not restart the timer if it is running, so that continuous updates
+     * still get written within the delay.
+     */
+    if (xTimerIsTimerActive(deferred_timer) == pdFALSE) {
+        xTimerStart(deferred_timer, 0);
+    }
+    return HAP_SUCCESS;
+}
+
+void hap_keystore_flush()
+{
+    if (!deferred_lock) {
+        return;
+    }
+    int cnt = 0, i;
+    xSemaphoreTake(deferred_lock, portMAX_DELAY);
+    for (i = 0; i < HAP_KEYSTORE_DEFERRED_MAX; i++) {
+        hap_keystore_deferred_t *entry = &deferred_writes[i];
+        if (entry->key) {
+            __hap_keystore_set(hap_platform_nvs_partition, entry->name_space, entry->key,
+                    entry->val, entry->val_len);
+            memset(entry, 0, sizeof(hap_keystore_deferred_t));
+            cnt++;
+        }
+    }
+    xSemaphoreGive(deferred_lock);
+    if (deferred_timer) {
+        xTimerStop(deferred_timer, 0);
+    }
+    if (cnt) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Flushed %d deferred keystore write(s)", cnt);
+    }
+}
+
 int hap_factory_keystore_set(const char *name_space, const char *key, const uint8_t *val, const size_t val_len)
 {
     return __hap_keystore_set(hap_platform_factory_nvs_partition, name_space, key, val, val_len);
@@ -101,6 +242,7 @@ int hap_keystore_delete(const char *name_space, const char *key)
     if (!keystore_init_done) {
         return HAP_FAIL;
     }
+    hap_keystore_deferred_drop(name_space, key);
 
     int err = hap_platform_keystore_delete(hap_platform_nvs_partition, name_space, key);
     if (err != 0) {
@@ -114,6 +256,7 @@ int hap_keystore_delete_namespace(const char *name_space)
     if (!keystore_init_done) {
         return HAP_FAIL;
     }
+    hap_keystore_deferred_drop(name_space, NULL);
 
     int err = hap_platform_keystore_delete_namespace(hap_platform_nvs_partition, name_space);
     if (err != 0) {
@@ -124,5 +267,6 @@ int hap_keystore_delete_namespace(const char *name_space)
 
 void hap_keystore_erase_all_data()
 {
+    hap_keystore_deferred_drop(NULL, NULL);
     hap_platfrom_keystore_erase_partition(hap_platform_nvs_partition);
 }
@@ -26,7 +26,9 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
+#include <freertos/timers.h>
 #include <esp_event.h>
+#include <esp_timer.h>
 
 #include <esp_mfi_debug.h>
 #include <esp_hap_acc.h>
@@ -40,6 +42,8 @@
 #include <esp_hap_wac.h>
 #include <esp_hap_bct_priv.h>
 #include <esp_hap_pair_verify.h>
+#include <esp_hap_keypool.h>
+#include <esp_hap_type_id.h>
 #include <hap_platform_os.h>
 
 static QueueHandle_t xQueue;
@@ -49,29 +53,257 @@ const char * hap_get_version(void)
 {
     return MFI_VER;
 }
+#define HAP_LOOP_MAX_OPS        4
+/* Steps common to all operations which end with a reboot */
+#define HAP_LOOP_STEP_REBOOT    100
+
+/* Operations like reset and network switch need to wait between their steps,
+ * for responses and mDNS goodbye packets to go out. Rather than sleeping in the
+ * loop, each step schedules the next one on a timer, so that the loop keeps
+ * processing other events, like notifications, in between. Operations run one
+ * at a time, in the order in which they were requested.
+ */
+static struct {
+    hap_internal_event_t ops[HAP_LOOP_MAX_OPS];
+    uint8_t op_cnt;
+    uint8_t step;
+    char *reboot_reason;
+    TimerHandle_t timer;
+    TaskHandle_t task;
+    uint32_t max_queued;
+    uint32_t dropped;
+    uint32_t dropped_reported;
+    uint32_t coalesced;
+    uint8_t queue_size;
+} hap_loop;
+
+/* Events are delivered to the loop in two classes:
+ * - Triggers, like the notification trigger, which only say that something needs
+ *   to be done. These are task notification bits, so any number of them cost a
+ *   single pending bit and can never be dropped.
+ * - Control events, like resets and pairing changes, which go through a bounded
+ *   queue, so that a burst of triggers can never push them out.
+ */
+#define HAP_LOOP_BIT_QUEUE      (1 << 0)
+#define HAP_LOOP_BIT_DROPPED    (1 << 1)
+#define HAP_LOOP_BIT_TRIGGER(i) (1 << ((i) + 2))
+
+static const hap_internal_event_t hap_loop_triggers[] = {
+    HAP_INTERNAL_EVENT_TRIGGER_NOTIF,
+    HAP_INTERNAL_EVENT_LOOP_CONTINUE,
+    HAP_INTERNAL_EVENT_KEYSTORE_FLUSH,
+};
+/* All the notification bits used by the loop */
+#define HAP_LOOP_BITS_ALL   (HAP_LOOP_BIT_TRIGGER(sizeof(hap_loop_triggers) / sizeof(hap_loop_triggers[0])) - 1)
+
+/* Returns the notification bit of a trigger event, 0 for control events */
+static uint32_t hap_loop_trigger_bit(hap_internal_event_t event)
+{
+    int i;
+    for (i = 0; i < sizeof(hap_loop_triggers) / sizeof(hap_loop_triggers[0]); i++) {
+        if (hap_loop_triggers[i] == event) {
+            return HAP_LOOP_BIT_TRIGGER(i);
+        }
+    }
+    return 0;
+}
+
+static void hap_loop_timer_cb(TimerHandle_t handle)
+{
+    hap_send_event(HAP_INTERNAL_EVENT_LOOP_CONTINUE);
+}
+
+/* Run the next step of the current operation after delay_ms */
+static void hap_loop_continue_after(uint32_t delay_ms)
+{
+    TickType_t ticks = delay_ms / hap_platform_os_get_msec_per_tick();
+    hap_loop.step++;
+    /* Changing the period also starts the timer */
+    xTimerChangePeriod(hap_loop.timer, ticks ? ticks : 1, 0);
+}
+
+static void hap_loop_reboot(char *reboot_reason)
+{
+    hap_loop.reboot_reason = reboot_reason;
+    hap_loop.step = HAP_LOOP_STEP_REBOOT;
+    hap_loop_continue_after(0);
+}
+
+static void hap_loop_op_done(void);
+
+/* Returns true if the event is an operation handled by hap_loop_op_step() */
+static bool hap_loop_is_op(hap_internal_event_t event)
+{
+    switch (event) {
+        case HAP_INTERNAL_EVENT_BCT_CHANGE_NAME:
+        case HAP_INTERNAL_EVENT_BCT_HOT_PLUG:
+        case HAP_INTERNAL_EVENT_RESET_PAIRINGS:
+        case HAP_INTERNAL_EVENT_RESET_TO_FACTORY:
+        case HAP_INTERNAL_EVENT_REBOOT:
+        case HAP_INTERNAL_EVENT_RESET_NETWORK:
+        case HAP_INTERNAL_EVENT_RESET_HOMEKIT_DATA:
+        case HAP_INTERNAL_EVENT_NETWORK_SWITCH:
+        case HAP_INTERNAL_EVENT_NETWORK_REVERT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void hap_loop_op_step(void)
+{
+    hap_internal_event_t event = hap_loop.ops[0];
+
+    /* Common reboot steps */
+    if (hap_loop.step == HAP_LOOP_STEP_REBOOT + 1) {
+        /* Write any pending values which may have survived the erase */
+        hap_keystore_flush();
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Rebooting...");
+        hap_report_event(HAP_EVENT_ACC_REBOOTING, hap_loop.reboot_reason,
+                strlen(hap_loop.reboot_reason) + 1);
+        /* Wait for some time after performing the operations and then reboot */
+        hap_loop_continue_after(1000);
+        return;
+    } else if (hap_loop.step == HAP_LOOP_STEP_REBOOT + 2) {
+        esp_restart();
+        return;
+    }
+
+    switch (event) {
+        case HAP_INTERNAL_EVENT_BCT_CHANGE_NAME:
+            if (hap_loop.step == 0) {
+                /* Waiting for sometime to allow the response to reach the host */
+                hap_loop_continue_after(1000);
+            } else {
+                hap_handle_bct_change_name();
+                hap_loop_op_done();
+            }
+            break;
+        case HAP_INTERNAL_EVENT_BCT_HOT_PLUG:
+            if (hap_loop.step == 0) {
+                /* Waiting for sometime to allow the response to reach the host */
+                hap_loop_continue_after(1000);
+            } else if (hap_loop.step == 1) {
+                hap_handle_hot_plug_begin();
+                /* Keep the network down for 10 seconds */
+                hap_loop_continue_after(10 * 1000);
+            } else {
+                hap_handle_hot_plug_end();
+                hap_loop_op_done();
+            }
+            break;
+        case HAP_INTERNAL_EVENT_RESET_PAIRINGS:
+        case HAP_INTERNAL_EVENT_RESET_TO_FACTORY:
+        case HAP_INTERNAL_EVENT_RESET_HOMEKIT_DATA:
+        case HAP_INTERNAL_EVENT_RESET_NETWORK:
+        case HAP_INTERNAL_EVENT_REBOOT:
+            if (hap_loop.step == 0) {
+                if (event == HAP_INTERNAL_EVENT_RESET_PAIRINGS) {
+                    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting all Pairing Information");
+                } else if (event == HAP_INTERNAL_EVENT_RESET_TO_FACTORY) {
+                    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting to Factory Defaults");
+                } else if (event == HAP_INTERNAL_EVENT_RESET_HOMEKIT_DATA) {
+                    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting all HomeKit Data");
+                } else if (event == HAP_INTERNAL_EVENT_RESET_NETWORK) {
+                    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting Network Credentials");
+                }
+                /* Wait for some time before erasing the information, so that the callee
+                 * gets some time for any additional operations
+                 */
+                hap_loop_continue_after(1000);
+            } else if (hap_loop.step == 1) {
+                hap_close_all_sessions();
+                hap_mdns_deannounce();
+                hap_loop_continue_after(HAP_MDNS_DEANNOUNCE_WAIT_MS);
+            } else {
+                char *reboot_reason = HAP_REBOOT_REASON_UNKNOWN;
+                if (event == HAP_INTERNAL_EVENT_RESET_PAIRINGS) {
+                    hap_erase_controller_info();
+                    hap_erase_accessory_info();
+                    reboot_reason = HAP_REBOOT_REASON_RESET_PAIRINGS;
+                } else if (event == HAP_INTERNAL_EVENT_RESET_TO_FACTORY) {
+                    hap_keystore_erase_all_data();
+                    reboot_reason = HAP_REBOOT_REASON_RESET_TO_FACTORY;
+                } else if (event == HAP_INTERNAL_EVENT_RESET_HOMEKIT_DATA) {
+                    hap_erase_controller_info();
+                    hap_erase_network_info();
+                    hap_erase_accessory_info();
+                    reboot_reason = HAP_REBOOT_REASON_RESET_HOMEKIT_DATA;
+                } else if (event == HAP_INTERNAL_EVENT_RESET_NETWORK) {
+                    hap_erase_network_info();
+                    reboot_reason = HAP_REBOOT_REASON_RESET_NETWORK;
+                } else {
+                    reboot_reason = HAP_REBOOT_REASON_REBOOT_ACC;
+                }
+                hap_loop_reboot(reboot_reason);
+            }
+            break;
+        case HAP_INTERNAL_EVENT_NETWORK_SWITCH:
+        case HAP_INTERNAL_EVENT_NETWORK_REVERT:
+            if (hap_loop.step == 0) {
+                ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Taking the network down");
+                /* wait for some time, close all the active sessions and then
+                 * switch the network.
+                 */
+                hap_loop_continue_after(2000);
+            } else if (hap_loop.step == 1) {
+                hap_close_all_sessions();
+                hap_mdns_deannounce();
+                hap_loop_continue_after(HAP_MDNS_DEANNOUNCE_WAIT_MS + 1000);
+            } else {
+                if (event == HAP_INTERNAL_EVENT_NETWORK_SWITCH) {
+                    hap_wifi_config_sta_connect();
+                } else {
+                    hap_wifi_config_revert_network();
+                }
+                hap_loop_op_done();
+            }
+            break;
+        default:
+            hap_loop_op_done();
+            break;
+    }
+}
+
+static void hap_loop_op_done(void)
+{
+    hap_loop.op_cnt--;
+    memmove(&hap_loop.ops[0], &hap_loop.ops[1], hap_loop.op_cnt * sizeof(hap_loop.ops[0]));
+    hap_loop.step = 0;
+    if (hap_loop.op_cnt) {
+        hap_loop_op_step();
+    }
+}
+
+static void hap_loop_op_add(hap_internal_event_t event)
+{
+    if (hap_loop.op_cnt == HAP_LOOP_MAX_OPS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "Too many pending operations. Dropping %d", event);
+        return;
+    }
+    hap_loop.ops[hap_loop.op_cnt++] = event;
+    /* Start right away, if nothing else is in progress */
+    if (hap_loop.op_cnt == 1) {
+        hap_loop_op_step();
+    }
+}
+
 static void hap_nw_configured_sm(hap_internal_event_t event, hap_state_t *state)
 {
     switch (event) {
         case HAP_INTERNAL_EVENT_ACC_PAIRED:
             hap_mdns_announce(false);
+            hap_keypool_refill();
             break;
         case HAP_INTERNAL_EVENT_ACC_UNPAIRED:
             hap_mdns_announce(false);
+            hap_keypool_refill();
             break;
         case HAP_INTERNAL_EVENT_CONFIG_NUM_UPDATED:
+            hap_acc_db_cache_invalidate();
             hap_increment_and_save_config_num();
             hap_mdns_announce(false);
             break;
-        case HAP_INTERNAL_EVENT_BCT_CHANGE_NAME:
-            /* Waiting for sometime to allow the response to reach the host */
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_handle_bct_change_name();
-            break;
-        case HAP_INTERNAL_EVENT_BCT_HOT_PLUG:
-            /* Waiting for sometime to allow the response to reach the host */
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_handle_hot_plug();
-            break;
         default:
             break;
     }
@@ -79,139 +311,136 @@ static void hap_nw_configured_sm(hap_internal_event_t event, hap_state_t *state)
 
 static void hap_common_sm(hap_internal_event_t event)
 {
-    char *reboot_reason = HAP_REBOOT_REASON_UNKNOWN;
     switch (event) {
-        case HAP_INTERNAL_EVENT_RESET_PAIRINGS:
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting all Pairing Information");
-            /* Wait for some time before erasing the information, so that the callee
-             * gets some time for any additional operations
-             */
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            hap_erase_controller_info();
-            hap_erase_accessory_info();
-            reboot_reason = HAP_REBOOT_REASON_RESET_PAIRINGS;
+        case HAP_INTERNAL_EVENT_KEYSTORE_FLUSH:
+            hap_keystore_flush();
             break;
-        case HAP_INTERNAL_EVENT_RESET_TO_FACTORY:
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting to Factory Defaults");
-            /* Wait for some time before erasing the information, so that the callee
-             * gets some time for any additional operations
-             */
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            hap_keystore_erase_all_data();
-            reboot_reason = HAP_REBOOT_REASON_RESET_TO_FACTORY;
-            break;
-        case HAP_INTERNAL_EVENT_RESET_HOMEKIT_DATA:
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting all HomeKit Data");
-            /* Wait for some time before erasing the information, so that the callee
-             * gets some time for any additional operations
-             */
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            hap_erase_controller_info();
-            hap_erase_network_info();
-            hap_erase_accessory_info();
-            reboot_reason = HAP_REBOOT_REASON_RESET_HOMEKIT_DATA;
-            break;
-        case HAP_INTERNAL_EVENT_REBOOT:
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            /* Wait for some time and then close all the active sessions
-             */
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            reboot_reason = HAP_REBOOT_REASON_REBOOT_ACC;
+        case HAP_INTERNAL_EVENT_TRIGGER_NOTIF:
+            hap_handle_notif_trigger();
             break;
-        case HAP_INTERNAL_EVENT_RESET_NETWORK:
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Resetting Network Credentials");
-            /* Wait for some time, close all the active sessions and then
-             * erase network info.
-             */
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            hap_erase_network_info();
-            reboot_reason = HAP_REBOOT_REASON_RESET_NETWORK;
+        case HAP_INTERNAL_EVENT_LOOP_CONTINUE:
+            if (hap_loop.op_cnt) {
+                hap_loop_op_step();
+            }
             break;
-        case HAP_INTERNAL_EVENT_TRIGGER_NOTIF:
-/* TODO: Avoid direct http function. Notification could be even for iCloud or BLE.
- */
-            hap_http_send_notif();
-            return;
-        case HAP_INTERNAL_EVENT_NETWORK_SWITCH:
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Taking the network down");
-            /* wait for some time, close all the active sessions and then
-             * erase network info.
-             */
-            vTaskDelay(2000 / hap_platform_os_get_msec_per_tick());
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_wifi_config_sta_connect();
-            return;
-        case HAP_INTERNAL_EVENT_NETWORK_REVERT:
-            ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Taking the network down");
-            /* wait for some time, close all the active sessions and then
-             * erase network info.
-             */
-            vTaskDelay(2000 / hap_platform_os_get_msec_per_tick());
-            hap_close_all_sessions();
-            hap_mdns_deannounce();
-            vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-            hap_wifi_config_revert_network();
-            return;
         default:
-            return;
-        }
-
-    /* Wait for some time after peeforming the operations and then reboot */
-    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Rebooting...");
-    hap_report_event(HAP_EVENT_ACC_REBOOTING, reboot_reason, strlen(reboot_reason) + 1);
-    vTaskDelay(1000 / hap_platform_os_get_msec_per_tick());
-    esp_restart();
+            if (hap_loop_is_op(event)) {
+                hap_loop_op_add(event);
+            }
+            break;
+    }
 }
 
 static void hap_loop_task(void *param)
 {
     hap_state_t cur_state = HAP_STATE_NONE;
-    xQueue = xQueueCreate( 10, sizeof(hap_event_ctx_t) );
     hap_event_ctx_t hap_event;
     bool loop_continue = true;
+    uint32_t bits;
+    int i;
     ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "HAP Main Loop Started");
     while (loop_continue) {
-        if (xQueueReceive(xQueue, &hap_event, portMAX_DELAY) != pdTRUE) {
+        if (xTaskNotifyWait(0, HAP_LOOP_BITS_ALL, &bits, portMAX_DELAY) != pdTRUE) {
             continue;
         }
-        if (hap_event.event == HAP_INTERNAL_EVENT_LOOP_STOP) {
-            loop_continue = false;
-            continue;
+        for (i = 0; i < sizeof(hap_loop_triggers) / sizeof(hap_loop_triggers[0]); i++) {
+            if (bits & HAP_LOOP_BIT_TRIGGER(i)) {
+                hap_common_sm(hap_loop_triggers[i]);
+            }
+        }
+        if (bits & HAP_LOOP_BIT_DROPPED) {
+            uint32_t dropped = hap_loop.dropped;
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "HAP loop queue full. %d event(s) dropped",
+                    dropped - hap_loop.dropped_reported);
+            hap_loop.dropped_reported = dropped;
+            hap_report_event(HAP_EVENT_LOOP_QUEUE_OVERFLOW, &dropped, sizeof(dropped));
+        }
+        /* Check the queue even if HAP_LOOP_BIT_QUEUE is not set, since events
+         * may have been queued after the bits were read in an earlier iteration.
+         */
+        while (xQueueReceive(xQueue, &hap_event, 0) == pdTRUE) {
+            if (hap_event.event == HAP_INTERNAL_EVENT_LOOP_STOP) {
+                loop_continue = false;
+                break;
+            }
+            hap_common_sm(hap_event.event);
+            hap_nw_configured_sm(hap_event.event, &cur_state);
         }
-        hap_common_sm(hap_event.event);
-        hap_nw_configured_sm(hap_event.event, &cur_state);
     }
+    xTimerDelete(hap_loop.timer, 0);
+    hap_loop.timer = NULL;
     vQueueDelete(xQueue);
     xQueue = NULL;
     vTaskDelete(NULL);
 }
 
+void hap_get_loop_stats(hap_loop_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(hap_loop_stats_t));
+    stats->queue_size = hap_loop.queue_size;
+    if (xQueue) {
+        stats->queued = uxQueueMessagesWaiting(xQueue);
+    }
+    stats->max_queued = hap_loop.max_queued;
+    stats->pending_ops = hap_loop.op_cnt;
+    stats->dropped = hap_loop.dropped;
+    stats->coalesced = hap_loop.coalesced;
+}
+
 static bool loop_started;
 int hap_loop_start()
 {
     if (!loop_started) {
+        /* Created here rather than in the task, so that events sent right after
+         * this returns are not lost.
+         */
+        /* 0 is what a configuration without this field set has */
+        hap_loop.queue_size = hap_priv.cfg.loop_queue_size ? hap_priv.cfg.loop_queue_size : HAP_LOOP_QUEUE_SIZE;
+        xQueue = xQueueCreate(hap_loop.queue_size, sizeof(hap_event_ctx_t));
+        hap_loop.timer = xTimerCreate("hap_loop_timer", 1, pdFALSE, NULL, hap_loop_timer_cb);
+        if (!xQueue || !hap_loop.timer) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to create HAP loop queue/timer");
+            goto loop_start_fail;
+        }
+        if (xTaskCreate(hap_loop_task, "hap-loop", hap_priv.cfg.task_stack_size, NULL,
+                        hap_priv.cfg.task_priority, &hap_loop.task) != pdPASS) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to create HAP loop task");
+            goto loop_start_fail;
+        }
         loop_started = true;
-        xTaskCreate(hap_loop_task, "hap-loop", hap_priv.cfg.task_stack_size, NULL,
-                        hap_priv.cfg.task_priority, NULL);
     }
     return HAP_SUCCESS;
+loop_start_fail:
+    if (hap_loop.timer) {
+        xTimerDelete(hap_loop.timer, 0);
+        hap_loop.timer = NULL;
+    }
+    if (xQueue) {
+        vQueueDelete(xQueue);
+        xQueue = NULL;
+    }
+    return HAP_FAIL;
 }
 
 bool is_hap_loop_started()
 {
     return loop_started;
 }
+/* Sets notification bits of the loop task and returns the bits which were set earlier */
+static uint32_t hap_loop_notify(uint32_t bits, bool in_isr)
+{
+    uint32_t prev = 0;
+    if (in_isr) {
+        xTaskNotifyAndQueryFromISR(hap_loop.task, bits, eSetBits, &prev, NULL);
+    } else {
+        xTaskNotifyAndQuery(hap_loop.task, bits, eSetBits, &prev);
+    }
+    return prev;
+}
+
 int hap_send_event(hap_internal_event_t event)
 {
     if (!is_hap_loop_started()) {
@@ -220,18 +449,37 @@ int hap_send_event(hap_internal_event_t event)
     if (!xQueue) {
         return HAP_FAIL;
     }
+    bool in_isr = (xPortInIsrContext() == pdTRUE);
+    uint32_t bit = hap_loop_trigger_bit(event);
+    if (bit) {
+        /* If the trigger is already pending, this one gets handled along with it */
+        if (hap_loop_notify(bit, in_isr) & bit) {
+            hap_loop.coalesced++;
+        }
+        return HAP_SUCCESS;
+    }
     hap_event_ctx_t hap_event = {
         .event = event,
     };
     BaseType_t ret;
-    if (xPortInIsrContext() == pdTRUE) {
+    UBaseType_t queued;
+    if (in_isr) {
         ret = xQueueSendFromISR(xQueue, &hap_event, NULL);
+        queued = uxQueueMessagesWaitingFromISR(xQueue);
     } else {
         ret = xQueueSend(xQueue, &hap_event, 0);
+        queued = uxQueueMessagesWaiting(xQueue);
+    }
+    if (queued > hap_loop.max_queued) {
+        hap_loop.max_queued = queued;
     }
     if (ret == pdTRUE) {
+        hap_loop_notify(HAP_LOOP_BIT_QUEUE, in_isr);
         return HAP_SUCCESS;
     }
+    /* Reported from the loop, since this may be an ISR */
+    hap_loop.dropped++;
+    hap_loop_notify(HAP_LOOP_BIT_DROPPED, in_isr);
     return HAP_FAIL;
 }
 
@@ -255,9 +503,24 @@ static void hap_network_event_handler(void* arg, esp_event_base_t event_base,
     }
 }
 #endif
+static hap_startup_profile_t hap_startup_profile;
+
+static void hap_startup_stage_done(hap_startup_stage_t stage, int64_t start)
+{
+    int64_t now = esp_timer_get_time();
+    hap_startup_profile.stage_end_us[stage] = now;
+    hap_startup_profile.stage_duration_us[stage] = (uint32_t)(now - start);
+}
+
+const hap_startup_profile_t *hap_get_startup_profile(void)
+{
+    return &hap_startup_profile;
+}
+
 int hap_init(hap_transport_t method)
 {
     int ret = HAP_SUCCESS;
+    int64_t start;
     if (!(method & (HAP_TRANSPORT_WIFI | HAP_TRANSPORT_ETHERNET))) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Invalid Transport");
         return HAP_FAIL;
@@ -265,17 +528,26 @@ int hap_init(hap_transport_t method)
 
     hap_priv.transport = method;
 
+    ret = hap_type_id_init();
+    if (ret != HAP_SUCCESS) {
+        return ret;
+    }
+
+    start = esp_timer_get_time();
     ret = hap_keystore_init();
     if (ret != 0 ) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HAP Key Store Init failed");
         return ret;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_KEYSTORE_INIT, start);
 
+    start = esp_timer_get_time();
     ret = hap_database_init();
     if (ret != 0 ) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HAP Database Init failed");
         return ret;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_DATABASE_INIT, start);
     ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "HAP Initialization succeeded. Version : %s", hap_get_version());
 
     return ret;
@@ -326,6 +598,7 @@ int hap_trigger_network_revert(void)
 int hap_start(void)
 {
     int ret = 0;
+    int64_t start = esp_timer_get_time();
 #ifdef CONFIG_HAP_MFI_ENABLE
     if (hap_priv.auth_type == HAP_MFI_AUTH_HW) {
         ret = hap_enable_hw_auth();
@@ -338,24 +611,22 @@ int hap_start(void)
                 hap_priv.auth_type == HAP_MFI_AUTH_HW ? "HW" : "SW");
         return HAP_FAIL;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_MFI_AUTH, start);
 
     if (!hap_get_first_acc()) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to start HAP. Please add an Accessory before hap_start()");
         return HAP_FAIL;
     }
 
+    start = esp_timer_get_time();
     ret = hap_acc_setup_init();
     if (ret != HAP_SUCCESS) {
          ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Accessory Setup init failed");
          return ret;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_SETUP_INIT, start);
 
-    ret = hap_httpd_start();
-    if (ret != HAP_SUCCESS) {
-         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HTTPD START Failed [%d]", ret);
-         return ret;
-    }
-
+    start = esp_timer_get_time();
     ret = hap_event_queue_init();
     if (ret != HAP_SUCCESS) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Queue Initialisation for Event Notifications Failed");
@@ -367,17 +638,48 @@ int hap_start(void)
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HAP Loop Failed: [%d]", ret);
         return ret;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_LOOP_START, start);
+
+    /* mDNS is started before the HTTP server so that its task can begin probing
+     * for the host name while the server sockets are being set up.
+     */
+    start = esp_timer_get_time();
     ret = hap_mdns_init();
     if (ret != 0 ) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HAP mDNS Init failed");
         return ret;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_MDNS_INIT, start);
 
+    start = esp_timer_get_time();
+    ret = hap_httpd_start();
+    if (ret != HAP_SUCCESS) {
+         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HTTPD START Failed [%d]", ret);
+         return ret;
+    }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_HTTPD_START, start);
+
+    start = esp_timer_get_time();
     ret = hap_ip_services_start();
     if (ret != 0) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "HAP IP Services Start Failed [%d]", ret);
         return ret;
     }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_ANNOUNCE, start);
+
+    /* The key pool only speeds up pairing, so start it once the accessory is
+     * discoverable. Not fatal. Pair Setup and Pair Verify will just generate
+     * their keys inline.
+     */
+    start = esp_timer_get_time();
+    if (hap_keypool_init() != HAP_SUCCESS) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_WARN, "Key pool init failed");
+    }
+    hap_startup_stage_done(HAP_STARTUP_STAGE_KEYPOOL_INIT, start);
+
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "HAP started. Discoverable %d ms after boot",
+            (int)(hap_startup_profile.stage_end_us[HAP_STARTUP_STAGE_ANNOUNCE] / 1000));
+    hap_report_event(HAP_EVENT_STARTUP_COMPLETE, &hap_startup_profile, sizeof(hap_startup_profile));
     return HAP_SUCCESS;
 }
 
@@ -33,9 +33,9 @@
 #include <esp_hap_database.h>
 #include <esp_hap_pair_common.h>
 #include <esp_hap_pair_verify.h>
+#include <esp_hap_network_io.h>
 
-#define HAP_MAX_NW_FRAME_SIZE	1024 /* As per HAP Specifications */
-#define AUTH_TAG_LEN            16
+#define AUTH_TAG_LEN            POLY_AUTHTAG_LEN
 typedef struct {
 	uint8_t pkt_size[2];
 	uint8_t data[HAP_MAX_NW_FRAME_SIZE];
@@ -46,13 +46,6 @@ typedef struct {
 	uint8_t poly_auth_tag[AUTH_TAG_LEN];
 } hap_encrypt_frame_t;
 
-typedef struct {
-	uint16_t pkt_size;
-	uint16_t bytes_read;
-	uint8_t data[HAP_MAX_NW_FRAME_SIZE + AUTH_TAG_LEN];
-	hap_secure_session_t *session;
-} hap_decrypt_frame_t;
-
 typedef int (*hap_decrypt_read_fn_t) (uint8_t *buf, int buf_size, void *context);
 static int min(int val1, int val2)
 {
@@ -80,6 +73,7 @@ int hap_encrypt_data(hap_encrypt_frame_t *frame, hap_secure_session_t *session,
 	/* Encrypt the received data as per Chacha20-Poly1305 AEAD algorithm.
 	 * The authTag will be appended at the end of data. Hence, pointer given as
 	 * frame->data + nlen
+	 * buf can also be frame->data itself, for in place encryption.
 	 */
     unsigned long long mlen = 16;
     uint8_t newnonce[12];
@@ -110,10 +104,6 @@ int hap_decrypt_data(hap_decrypt_frame_t *frame, hap_secure_session_t *session,
 {
 	if (!frame || !session)
 		return -1;
-	if (frame->session != session) {
-		memset(frame, 0, sizeof(hap_decrypt_frame_t));
-		frame->session = session;
-	}
 	if ((frame->pkt_size - frame->bytes_read) == 0) {
 		if (read_fn(frame->data, 2, context) < 2)
 			return hap_session_error(session);
@@ -154,36 +144,155 @@ int hap_decrypt_data(hap_decrypt_frame_t *frame, hap_secure_session_t *session,
 	return bytes;
 }
 
-int hap_httpd_send(httpd_handle_t hd, int sockfd, const char *buf, unsigned buf_len, int flags)
+/* Number of encrypted frames that are written to the socket in one go */
+#define HAP_TX_MAX_FRAMES       2
+
+/* The send path is used only from the HTTP server's task context (including the
+ * work queued using httpd_queue_work()) and so, static buffers are safe here.
+ */
+static uint8_t hap_tx_buf[HAP_TX_MAX_FRAMES * sizeof(hap_encrypt_frame_t)];
+
+static struct {
+	int fd;
+	int len;
+	uint8_t buf[HAP_MAX_NW_FRAME_SIZE];
+	uint32_t bytes;
+	uint32_t frames;
+	uint32_t writes;
+} hap_tx_cork = {
+	.fd = -1,
+};
+
+static int hap_send_all(int sockfd, uint8_t *buf, int buf_len, int flags)
+{
+	hap_tx_cork.writes++;
+	hap_tx_cork.bytes += buf_len;
+	while (buf_len) {
+		int ret = send(sockfd, buf, buf_len, flags);
+		if (ret <= 0)
+			return HAP_FAIL;
+		buf += ret;
+		buf_len -= ret;
+	}
+	return HAP_SUCCESS;
+}
+
+int hap_httpd_sendv(httpd_handle_t hd, int sockfd, const hap_iovec_t *iov, int iovcnt, int flags)
 {
+	int total_len = 0, i;
+	for (i = 0; i < iovcnt; i++) {
+		total_len += iov[i].len;
+	}
 	hap_secure_session_t *session = httpd_sess_get_ctx(hap_priv.server, sockfd);
-	if (session && (session->state == STATE_VERIFIED)) {
-		uint8_t *buf_ptr = (uint8_t *)buf;
-		int tmp_buf_len = buf_len;
-		while (tmp_buf_len) {
-			hap_encrypt_frame_t encrypt_frame;
-			memset(&encrypt_frame, 0, sizeof(encrypt_frame));
-			int len = min(tmp_buf_len, HAP_MAX_NW_FRAME_SIZE);
-			int send_len = hap_encrypt_data(&encrypt_frame, session, buf_ptr, len);
-			if (send(sockfd, (uint8_t *)&encrypt_frame, send_len, flags) <= 0)
+	if (!session || (session->state != STATE_VERIFIED)) {
+		for (i = 0; i < iovcnt; i++) {
+			if (iov[i].len && (hap_send_all(sockfd, (uint8_t *)iov[i].buf, iov[i].len, flags) != HAP_SUCCESS))
 				return HAP_FAIL;
-			tmp_buf_len -= len;
-			buf_ptr += len;
 		}
-		/* Return the total length at the end since this API expects so
+		return total_len;
+	}
+	/* Gather the data from all the buffers into as few frames as possible,
+	 * encrypt them in place and write out multiple frames at a time.
+	 */
+	int tx_len = 0, iov_offset = 0;
+	i = 0;
+	while (i < iovcnt) {
+		hap_encrypt_frame_t *frame = (hap_encrypt_frame_t *)&hap_tx_buf[tx_len];
+		int frame_len = 0;
+		while ((i < iovcnt) && (frame_len < HAP_MAX_NW_FRAME_SIZE)) {
+			int len = min(iov[i].len - iov_offset, HAP_MAX_NW_FRAME_SIZE - frame_len);
+			memcpy(&frame->data[frame_len], (uint8_t *)iov[i].buf + iov_offset, len);
+			frame_len += len;
+			iov_offset += len;
+			if (iov_offset == iov[i].len) {
+				iov_offset = 0;
+				i++;
+			}
+		}
+		if (!frame_len)
+			break;
+		tx_len += hap_encrypt_data(frame, session, frame->data, frame_len);
+		hap_tx_cork.frames++;
+		if ((sizeof(hap_tx_buf) - tx_len) < sizeof(hap_encrypt_frame_t)) {
+			if (hap_send_all(sockfd, hap_tx_buf, tx_len, flags) != HAP_SUCCESS)
+				return HAP_FAIL;
+			tx_len = 0;
+		}
+	}
+	if (tx_len && (hap_send_all(sockfd, hap_tx_buf, tx_len, flags) != HAP_SUCCESS))
+		return HAP_FAIL;
+	return total_len;
+}
+
+void hap_httpd_cork(int sockfd)
+{
+	hap_tx_cork.fd = sockfd;
+	hap_tx_cork.len = 0;
+	hap_tx_cork.bytes = 0;
+	hap_tx_cork.frames = 0;
+	hap_tx_cork.writes = 0;
+}
+
+int hap_httpd_uncork(int sockfd)
+{
+	if (hap_tx_cork.fd != sockfd)
+		return HAP_FAIL;
+	int ret = HAP_SUCCESS;
+	if (hap_tx_cork.len) {
+		hap_iovec_t iov = {
+			.buf = hap_tx_cork.buf,
+			.len = hap_tx_cork.len,
+		};
+		if (hap_httpd_sendv(hap_priv.server, sockfd, &iov, 1, 0) < 0)
+			ret = HAP_FAIL;
+	}
+	ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Socket fd: %d; Sent %u bytes in %u frames and %u writes",
+			sockfd, (unsigned)hap_tx_cork.bytes, (unsigned)hap_tx_cork.frames, (unsigned)hap_tx_cork.writes);
+	hap_tx_cork.fd = -1;
+	hap_tx_cork.len = 0;
+	return ret;
+}
+
+int hap_httpd_send(httpd_handle_t hd, int sockfd, const char *buf, unsigned buf_len, int flags)
+{
+	if (hap_tx_cork.fd == sockfd) {
+		/* Just buffer the data if it fits. Else, send it out along with
+		 * the data buffered so far.
 		 */
+		if ((hap_tx_cork.len + buf_len) <= sizeof(hap_tx_cork.buf)) {
+			memcpy(&hap_tx_cork.buf[hap_tx_cork.len], buf, buf_len);
+			hap_tx_cork.len += buf_len;
+			return buf_len;
+		}
+		hap_iovec_t iov[2] = {
+			{
+				.buf = hap_tx_cork.buf,
+				.len = hap_tx_cork.len,
+			},
+			{
+				.buf = buf,
+				.len = buf_len,
+			},
+		};
+		hap_tx_cork.len = 0;
+		if (hap_httpd_sendv(hd, sockfd, iov, 2, flags) < 0)
+			return HAP_FAIL;
+		/* Return only the length of this buffer since this API expects so */
 		return buf_len;
 	}
-	return send(sockfd, buf, buf_len, flags);
+	hap_iovec_t iov = {
+		.buf = buf,
+		.len = buf_len,
+	};
+	return hap_httpd_sendv(hd, sockfd, &iov, 1, flags);
 }
 
 int hap_httpd_recv(httpd_handle_t hd, int sockfd, char *buf, unsigned buf_len, int flags)
 {
-	static hap_decrypt_frame_t decrypt_frame;
 	hap_secure_session_t *session = httpd_sess_get_ctx(hap_priv.server, sockfd);
 	if (session) {
 		if (session->state == STATE_VERIFIED) {
-			return hap_decrypt_data(&decrypt_frame, session, buf, buf_len,
+			return hap_decrypt_data(&session->decrypt_frame, session, buf, buf_len,
 					hap_httpd_raw_recv, &sockfd);
 		} else {
 			/* If the session state is invalid, we return an error.
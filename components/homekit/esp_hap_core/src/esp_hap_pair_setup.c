@@ -26,6 +26,7 @@
 #include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/timers.h>
+#include <esp_timer.h>
 #include <mu_srp.h>
 #include <sodium/crypto_aead_chacha20poly1305.h>
 #include <hkdf-sha.h>
@@ -37,6 +38,7 @@
 #include <esp_hap_ip_services.h>
 #include <esp_hap_pair_common.h>
 #include <esp_hap_pair_setup.h>
+#include <esp_hap_keypool.h>
 #include <esp_hap_database.h>
 #include <esp_hap_main.h>
 #include <esp_hap_acc.h>
@@ -96,6 +98,149 @@ void hap_pair_setup_re_enable(void)
     hap_start_pairing_mode_timer();
 }
 
+/* k * v for the configured verifier. It stays the same across Pair Setup attempts
+ * and so, is calculated just once.
+ */
+static char *hap_srp_kv;
+static int hap_srp_kv_len;
+
+#if CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0
+static mu_srp_ephemeral_t hap_srp_pool[CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE];
+static int hap_srp_pool_cnt;
+#endif /* CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0 */
+
+/* Must be called with the lock held */
+static void hap_srp_kv_cache_store(mu_srp_handle_t *hd)
+{
+    if (hap_srp_kv) {
+        return;
+    }
+    if (mu_srp_get_kv(hd, &hap_srp_kv, &hap_srp_kv_len) < 0) {
+        hap_srp_kv = NULL;
+        hap_srp_kv_len = 0;
+    }
+}
+
+static void hap_srp_kv_cache_clear(void)
+{
+    hap_keypool_lock();
+    if (hap_srp_kv) {
+        free(hap_srp_kv);
+        hap_srp_kv = NULL;
+        hap_srp_kv_len = 0;
+    }
+    hap_keypool_unlock();
+}
+
+/* Moves a pre-computed ephemeral, if available, into eph.
+ * Returns true on a pool hit.
+ */
+static bool hap_srp_pool_take(mu_srp_ephemeral_t *eph)
+{
+    bool found = false;
+#if CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0
+    hap_keypool_lock();
+    if (hap_srp_pool_cnt > 0) {
+        hap_srp_pool_cnt--;
+        *eph = hap_srp_pool[hap_srp_pool_cnt];
+        memset(&hap_srp_pool[hap_srp_pool_cnt], 0, sizeof(mu_srp_ephemeral_t));
+        found = true;
+    }
+    hap_keypool_unlock();
+#endif /* CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0 */
+    return found;
+}
+
+#if CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0
+static void hap_srp_pool_flush(void)
+{
+    int i;
+    hap_keypool_lock();
+    for (i = 0; i < hap_srp_pool_cnt; i++) {
+        mu_srp_free_ephemeral(&hap_srp_pool[i]);
+    }
+    hap_srp_pool_cnt = 0;
+    hap_keypool_unlock();
+}
+
+static void hap_srp_pool_fill(void)
+{
+    mu_srp_handle_t hd;
+    memset(&hd, 0, sizeof(hd));
+    if (mu_srp_init(&hd, MU_NG_3072) < 0) {
+        return;
+    }
+    /* One time setup, if the fixed-base table needs to be calculated at runtime */
+    mu_srp_prepare_fixed_base(&hd);
+
+    /* The setup code case generates a new salt and verifier for every attempt,
+     * so k * v can be cached only for the production salt-verifier case.
+     */
+    hap_keypool_lock();
+    bool need_kv = !hap_priv.setup_code && hap_priv.setup_info && !hap_srp_kv;
+    hap_keypool_unlock();
+    if (need_kv) {
+        if (mu_srp_set_salt_verifier(&hd, (char *)hap_priv.setup_info->salt, sizeof(hap_priv.setup_info->salt),
+                    (char *)hap_priv.setup_info->verifier, sizeof(hap_priv.setup_info->verifier)) == 0) {
+            char *bytes_kv;
+            int len_kv;
+            if (mu_srp_get_kv(&hd, &bytes_kv, &len_kv) == 0) {
+                hap_keypool_lock();
+                if (!hap_srp_kv) {
+                    hap_srp_kv = bytes_kv;
+                    hap_srp_kv_len = len_kv;
+                    bytes_kv = NULL;
+                }
+                hap_keypool_unlock();
+                if (bytes_kv) {
+                    free(bytes_kv);
+                }
+            }
+        }
+    }
+
+    while (!is_accessory_paired()) {
+        hap_keypool_lock();
+        int cnt = hap_srp_pool_cnt;
+        hap_keypool_unlock();
+        if (cnt >= CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE) {
+            break;
+        }
+        mu_srp_ephemeral_t eph;
+        int64_t start_time = esp_timer_get_time();
+        if (mu_srp_gen_ephemeral(&hd, &eph) < 0) {
+            ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to pre-compute SRP ephemeral");
+            break;
+        }
+        hap_keypool_lock();
+        if (hap_srp_pool_cnt < CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE) {
+            hap_srp_pool[hap_srp_pool_cnt++] = eph;
+            memset(&eph, 0, sizeof(eph));
+        }
+        hap_keypool_unlock();
+        mu_srp_free_ephemeral(&eph);
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Pre-computed SRP ephemeral in %d ms",
+                (int)((esp_timer_get_time() - start_time) / 1000));
+    }
+    mu_srp_free(&hd);
+}
+#endif /* CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0 */
+
+/* Called from the key pool task. Keeps ephemerals ready while unpaired and
+ * releases them once paired, since they are of no use then.
+ */
+void hap_srp_pool_update(void)
+{
+#if CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0
+    if (!is_accessory_paired()) {
+        hap_srp_pool_fill();
+    }
+    if (is_accessory_paired()) {
+        hap_srp_pool_flush();
+    }
+#endif /* CONFIG_HAP_SRP_EPHEMERAL_POOL_SIZE > 0 */
+}
+
 static int hap_pair_setup_process_srp_start(pair_setup_ctx_t *ps_ctx, uint8_t *buf, int inlen,
 		int bufsize, int *outlen)
 {
@@ -163,11 +308,22 @@ static int hap_pair_setup_process_srp_start(pair_setup_ctx_t *ps_ctx, uint8_t *b
     hap_priv.pairing_flags = ps_ctx->pairing_flags;
 
 	int len_B = 0;
-	char *bytes_B;
+	char *bytes_B = NULL;
+    int64_t start_time = esp_timer_get_time();
 
 	/* Create SRP Salt and Verifier for the provided pairing PIN */
     mu_srp_init(&ps_ctx->srp_hd, MU_NG_3072);
 
+    /* Use a pre-computed ephemeral, if available, so that only B = kv + g^b
+     * needs to be calculated here.
+     */
+    mu_srp_ephemeral_t eph;
+    bool pool_hit = hap_srp_pool_take(&eph);
+    if (pool_hit) {
+        mu_srp_set_ephemeral(&ps_ctx->srp_hd, &eph);
+        hap_keypool_refill();
+    }
+
     /* If a setup code is explicitly set, use it */
     if (hap_priv.setup_code) {
         ps_ctx->len_s = 16;
@@ -182,15 +338,26 @@ static int hap_pair_setup_process_srp_start(pair_setup_ctx_t *ps_ctx, uint8_t *b
             hap_prepare_error_tlv(STATE_M2, kTLVError_Unknown, buf, bufsize, outlen);
             return HAP_FAIL;
         }
+        hap_keypool_lock();
+        if (hap_srp_kv) {
+            mu_srp_set_kv(&ps_ctx->srp_hd, hap_srp_kv, hap_srp_kv_len);
+        }
+        hap_keypool_unlock();
         ps_ctx->bytes_s = (char *)hap_priv.setup_info->salt;
         ps_ctx->len_s = sizeof(hap_priv.setup_info->salt);
-        mu_srp_srv_pubkey_from_salt_verifier(&ps_ctx->srp_hd, &bytes_B, &len_B);
+        if (mu_srp_srv_pubkey_from_salt_verifier(&ps_ctx->srp_hd, &bytes_B, &len_B) == 0) {
+            hap_keypool_lock();
+            hap_srp_kv_cache_store(&ps_ctx->srp_hd);
+            hap_keypool_unlock();
+        }
     }
 	if (!ps_ctx->bytes_s || !bytes_B) {
 		ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "SRP-6a Verifier Creation Failed");
 		hap_prepare_error_tlv(STATE_M2, kTLVError_Unknown, buf, bufsize, outlen);
 		return HAP_FAIL;
 	}
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "SRP public key generated in %d ms (pre-computed ephemeral %s)",
+            (int)((esp_timer_get_time() - start_time) / 1000), pool_hit ? "used" : "unavailable");
 
 	hex_dbg_with_name("salt", (uint8_t *)ps_ctx->bytes_s, ps_ctx->len_s);
 	hex_dbg_with_name("acc_srp_public_key", (uint8_t *)bytes_B, len_B);
@@ -595,6 +762,8 @@ int hap_set_setup_info(const hap_setup_info_t *setup_info)
     if (!hap_priv.setup_info)
         return HAP_FAIL;
     memcpy(hap_priv.setup_info, setup_info, sizeof(hap_setup_info_t));
+    /* The cached k * v belongs to the earlier verifier */
+    hap_srp_kv_cache_clear();
     return HAP_SUCCESS;
 }
 
@@ -28,13 +28,16 @@
 #include <sodium/crypto_sign_ed25519.h>
 #include <hkdf-sha.h>
 #include <sodium/crypto_aead_chacha20poly1305.h>
+#include <sodium/utils.h>
 #include <esp_http_server.h>
+#include <esp_timer.h>
 #include <hap_platform_memory.h>
 
 #include <esp_hap_main.h>
 #include <esp_hap_pair_common.h>
 #include <esp_hap_database.h>
 #include <esp_hap_char.h>
+#include <esp_hap_keypool.h>
 #include <hexdump.h>
 #include <esp_mfi_debug.h>
 #include <esp_mfi_rand.h>
@@ -118,9 +121,11 @@ void hap_close_all_sessions()
 
 static void hap_add_secure_session(hap_secure_session_t *session)
 {
+	static uint32_t last_session_id;
 	int i;
 	for (i = 0; i < HAP_MAX_SESSIONS; i++) {
 		if (hap_priv.sessions[i] == NULL) {
+			session->session_id = ++last_session_id;
 			hap_priv.sessions[i] = session;
             hap_report_event(HAP_EVENT_CTRL_CONNECTED, session->ctrl->info.id,
                             sizeof(session->ctrl->info.id));
@@ -180,22 +185,30 @@ static int hap_pair_verify_process_start(pair_verify_ctx_t *pv_ctx, uint8_t *buf
 
 	ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Pair Verify M1 Received");
 	hex_dbg_with_name("ctrl curve pk", pv_ctx->ctrl_curve_pk, 32);
+    int64_t start_time = esp_timer_get_time();
 
-	/* Generate a new Curve25519 Key Pair */
+	/* Use a pre-generated Curve25519 Key Pair if available, else generate a new one */
 	uint8_t acc_curve_sk[CURVE_KEY_LEN];
-	esp_mfi_get_random(acc_curve_sk, CURVE_KEY_LEN);
-	/* This particular value of basepoint is required to generate the public key
-	 * from secret key
-	 */
-	uint8_t basepoint[32] = {9};
-    if (crypto_scalarmult_curve25519(pv_ctx->acc_curve_pk, acc_curve_sk, basepoint) == -1) {
-        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Curve25519 Error");
-		hap_prepare_error_tlv(STATE_M2, kTLVError_Unknown, buf, bufsize, outlen);
-		return HAP_FAIL;
-    }
+	bool pool_hit = hap_curve_keypool_take(acc_curve_sk, pv_ctx->acc_curve_pk);
+	if (!pool_hit) {
+		esp_mfi_get_random(acc_curve_sk, CURVE_KEY_LEN);
+		/* This particular value of basepoint is required to generate the public key
+		 * from secret key
+		 */
+		uint8_t basepoint[32] = {9};
+		if (crypto_scalarmult_curve25519(pv_ctx->acc_curve_pk, acc_curve_sk, basepoint) == -1) {
+			ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Curve25519 Error");
+			sodium_memzero(acc_curve_sk, sizeof(acc_curve_sk));
+			hap_prepare_error_tlv(STATE_M2, kTLVError_Unknown, buf, bufsize, outlen);
+			return HAP_FAIL;
+		}
+	}
 	hex_dbg_with_name("acc curve sk", acc_curve_sk, 32);
 	hex_dbg_with_name("acc curve pk", pv_ctx->acc_curve_pk, 32);
-    if (crypto_scalarmult_curve25519(pv_ctx->shared_secret, acc_curve_sk, pv_ctx->ctrl_curve_pk) == -1) {
+    int ret = crypto_scalarmult_curve25519(pv_ctx->shared_secret, acc_curve_sk, pv_ctx->ctrl_curve_pk);
+    /* The secret key is not required anymore */
+    sodium_memzero(acc_curve_sk, sizeof(acc_curve_sk));
+    if (ret == -1) {
         ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Curve25519 Error");
 		hap_prepare_error_tlv(STATE_M2, kTLVError_Unknown, buf, bufsize, outlen);
 		return HAP_FAIL;
@@ -281,7 +294,8 @@ static int hap_pair_verify_process_start(pair_verify_ctx_t *pv_ctx, uint8_t *buf
 	*outlen = tlv_data.curlen;
 	hex_dbg_with_name("M2", buf, *outlen);
 	pv_ctx->state = STATE_M2;
-	ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Pair Verify M2 Successful");
+	ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Pair Verify M2 Successful in %d ms (pre-generated key %s)",
+            (int)((esp_timer_get_time() - start_time) / 1000), pool_hit ? "used" : "unavailable");
 	return HAP_SUCCESS;
 }
 
@@ -364,7 +378,7 @@ static int hap_pair_verify_process_finish(pair_verify_ctx_t *pv_ctx, uint8_t *bu
 	ios_dev_info_len += CURVE_KEY_LEN;
 
 	/* Validate the signature with the received iOSDeviceSignature */
-    if (crypto_sign_ed25519_verify_detached(ed_sign, ios_dev_info, ios_dev_info_len, ctrl->info.ltpk) != 0) {
+    if (hap_controller_verify_sign(ctrl, ed_sign, ios_dev_info, ios_dev_info_len) != 0) {
 		ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Signature mismatch");
 		hap_prepare_error_tlv(STATE_M4, kTLVError_Authentication, buf, bufsize, outlen);
 		return HAP_FAIL;
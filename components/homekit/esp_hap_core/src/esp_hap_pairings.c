@@ -74,9 +74,9 @@ void hap_remove_all_controllers()
 	for (i = 0; i < HAP_MAX_CONTROLLERS; i++) {
 		if (hap_priv.controllers[i].valid) {
 			hap_close_sessions_of_ctrl(&hap_priv.controllers[i]);
-			hap_controller_remove(&hap_priv.controllers[i]);
 		}
 	}
+	hap_controller_remove_all();
 }
 static int hap_process_pair_remove(uint8_t *buf, int inlen, int bufsize, int *outlen)
 {
@@ -146,9 +146,8 @@ static int hap_process_pair_add(uint8_t *buf, int inlen, int bufsize, int *outle
 			return HAP_FAIL;
 		} else {
 			/* Else, just change the permissions */
-			ctrl->info.perms = perms;
 	        ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Modifying Existing Controller %s", ctrl_id);
-			hap_controller_save(ctrl);
+			hap_controller_set_perms(ctrl, perms);
 		}
 	} else {
 		/* Check if there is space available for a new controller */
@@ -23,6 +23,8 @@
   */
 #include <string.h>
 #include <hap_platform_memory.h>
+#include <esp_hap_db_arena.h>
+#include <esp_hap_type_id.h>
 
 #include <esp_hap_serv.h>
 #include <esp_mfi_debug.h>
@@ -99,9 +101,13 @@ hap_char_t *hap_serv_get_char_by_uuid(hap_serv_t *hs, const char *uuid)
     if (!hs | !uuid)
         return NULL;
 
+    hap_type_id_t type_id = hap_type_id_find(uuid);
+    if (type_id == HAP_TYPE_ID_INVALID)
+        return NULL;
+
     hap_char_t *hc;
     for (hc = hap_serv_get_first_char(hs); hc; hc = hap_char_get_next(hc)) {
-        if (!strcmp(((__hap_char_t *)hc)->type_uuid, uuid))
+        if (((__hap_char_t *)hc)->type_id == type_id)
             return hc;
     }
     return NULL;
@@ -148,12 +154,18 @@ static int hap_serv_def_bulk_read_cb(hap_read_data_t read_data[], int count,
 hap_serv_t *hap_serv_create(char *type_uuid)
 {
     ESP_MFI_ASSERT(type_uuid);
-    __hap_serv_t *_hs = hap_platform_memory_calloc(1, sizeof(__hap_serv_t));
+    hap_type_id_t type_id = hap_type_id_get(type_uuid);
+    if (type_id == HAP_TYPE_ID_INVALID) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to get type ID for service %s", type_uuid);
+        return NULL;
+    }
+    __hap_serv_t *_hs = hap_db_calloc(1, sizeof(__hap_serv_t));
     if (!_hs) {
         return NULL;
     }
 
     _hs->type_uuid = type_uuid;
+    _hs->type_id = type_id;
     _hs->bulk_read = hap_serv_def_bulk_read_cb;
 
     return (hap_serv_t *)_hs;
@@ -164,7 +176,7 @@ int hap_serv_link_serv(hap_serv_t *hs, hap_serv_t *linked_serv)
     if (!hs || !linked_serv)
         return HAP_FAIL;
 
-    hap_linked_serv_t *cur = hap_platform_memory_calloc(1, sizeof(hap_linked_serv_t));
+    hap_linked_serv_t *cur = hap_db_calloc(1, sizeof(hap_linked_serv_t));
     if (!cur)
         return HAP_FAIL;
     cur->hs = linked_serv;
@@ -208,6 +220,14 @@ char *hap_serv_get_type_uuid(hap_serv_t *hs)
     return tmp->type_uuid;
 }
 
+hap_type_id_t hap_serv_get_type_id(hap_serv_t *hs)
+{
+    if (!hs)
+       return HAP_TYPE_ID_INVALID;
+
+    return ((__hap_serv_t *)hs)->type_id;
+}
+
 /**
  * @brief HAP delete target service
  */
@@ -229,13 +249,13 @@ void hap_serv_delete(hap_serv_t *hs)
         hap_linked_serv_t *cur = _hs->linked_servs;
         hap_linked_serv_t *next = cur->next;
         while (next) {
-            hap_platform_memory_free(cur);
+            hap_db_free(cur);
             cur = next;
             next = cur->next;
         }
-        hap_platform_memory_free(cur);
+        hap_db_free(cur);
     }
-    hap_platform_memory_free(hs);
+    hap_db_free(hs);
 }
 
 /**
@@ -267,6 +287,7 @@ int hap_serv_add_char(hap_serv_t *hs, hap_char_t *hc)
     }
     if (_hs->parent) {
         _hc->iid = ((__hap_acc_t *)(_hs->parent))->next_iid++;
+        hap_acc_char_index_invalidate();
     }
     _hc->parent = hs;
     return 0;
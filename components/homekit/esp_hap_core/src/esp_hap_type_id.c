@@ -0,0 +1,163 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+#include <strings.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <hap.h>
+#include <esp_mfi_debug.h>
+#include <hap_platform_memory.h>
+#include <esp_hap_type_id.h>
+
+/* Suffix which turns an Apple short UUID into the full 128-bit form */
+#define HAP_APPLE_UUID_SUFFIX       "-0000-1000-8000-0026BB765291"
+#define HAP_SHORT_UUID_MAX_LEN      8
+
+#define HAP_TYPE_ID_TABLE_GROW      4
+
+/* Interned custom (non Apple) UUIDs. The type ID of a custom UUID is its
+ * index in this table, with HAP_TYPE_ID_CUSTOM_FLAG set. Lookups can run in any
+ * task while a bridged accessory added at runtime grows the table, so it is
+ * guarded by a mutex.
+ */
+static struct {
+    char **uuids;
+    uint32_t cnt;
+    uint32_t size;
+    SemaphoreHandle_t lock;
+} hap_type_id_table;
+
+int hap_type_id_init()
+{
+    if (hap_type_id_table.lock) {
+        return HAP_SUCCESS;
+    }
+    hap_type_id_table.lock = xSemaphoreCreateMutex();
+    if (!hap_type_id_table.lock) {
+        ESP_MFI_DEBUG(ESP_MFI_DEBUG_ERR, "Failed to create type ID table lock");
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
+}
+
+/* Parse an Apple UUID, either in short form (e.g. "25") or in the full 128-bit
+ * form with the Apple base suffix. Returns HAP_TYPE_ID_INVALID for any other UUID.
+ */
+static hap_type_id_t hap_type_id_parse_apple(const char *uuid)
+{
+    size_t len = strspn(uuid, "0123456789abcdefABCDEF");
+    if (len == 0 || len > HAP_SHORT_UUID_MAX_LEN) {
+        return HAP_TYPE_ID_INVALID;
+    }
+    if (uuid[len] != '\0' && (len != HAP_SHORT_UUID_MAX_LEN
+                || strcasecmp(uuid + len, HAP_APPLE_UUID_SUFFIX))) {
+        return HAP_TYPE_ID_INVALID;
+    }
+    hap_type_id_t id = 0;
+    size_t i;
+    for (i = 0; i < len; i++) {
+        char c = uuid[i];
+        id <<= 4;
+        if (c <= '9') {
+            id |= c - '0';
+        } else {
+            id |= (c | 0x20) - 'a' + 10;
+        }
+    }
+    /* Values which collide with the custom ID space are treated as custom UUIDs */
+    if (id & HAP_TYPE_ID_CUSTOM_FLAG) {
+        return HAP_TYPE_ID_INVALID;
+    }
+    return id;
+}
+
+/* Must be called with the table lock held */
+static hap_type_id_t hap_type_id_table_lookup(const char *uuid, bool add)
+{
+    uint32_t i;
+    for (i = 0; i < hap_type_id_table.cnt; i++) {
+        if (!strcasecmp(hap_type_id_table.uuids[i], uuid)) {
+            return HAP_TYPE_ID_CUSTOM_FLAG | i;
+        }
+    }
+    if (!add) {
+        return HAP_TYPE_ID_INVALID;
+    }
+    if (hap_type_id_table.cnt == hap_type_id_table.size) {
+        uint32_t size = hap_type_id_table.size + HAP_TYPE_ID_TABLE_GROW;
+        char **uuids = hap_platform_memory_calloc(size, sizeof(char *));
+        if (!uuids) {
+            return HAP_TYPE_ID_INVALID;
+        }
+        if (hap_type_id_table.uuids) {
+            memcpy(uuids, hap_type_id_table.uuids, hap_type_id_table.cnt * sizeof(char *));
+            hap_platform_memory_free(hap_type_id_table.uuids);
+        }
+        hap_type_id_table.uuids = uuids;
+        hap_type_id_table.size = size;
+    }
+    size_t len = strlen(uuid) + 1;
+    char *copy = hap_platform_memory_malloc(len);
+    if (!copy) {
+        return HAP_TYPE_ID_INVALID;
+    }
+    memcpy(copy, uuid, len);
+    hap_type_id_table.uuids[hap_type_id_table.cnt] = copy;
+    ESP_MFI_DEBUG(ESP_MFI_DEBUG_INFO, "Interned custom UUID %s as type ID 0x%x",
+            uuid, (unsigned)(HAP_TYPE_ID_CUSTOM_FLAG | hap_type_id_table.cnt));
+    return HAP_TYPE_ID_CUSTOM_FLAG | hap_type_id_table.cnt++;
+}
+
+static hap_type_id_t hap_type_id_lookup(const char *uuid, bool add)
+{
+    if (!uuid) {
+        return HAP_TYPE_ID_INVALID;
+    }
+    hap_type_id_t id = hap_type_id_parse_apple(uuid);
+    if (id != HAP_TYPE_ID_INVALID) {
+        return id;
+    }
+    /* The lock is created in hap_init(). Objects created before that are
+     * created before any other task can use the table.
+     */
+    if (hap_type_id_table.lock) {
+        xSemaphoreTake(hap_type_id_table.lock, portMAX_DELAY);
+    }
+    id = hap_type_id_table_lookup(uuid, add);
+    if (hap_type_id_table.lock) {
+        xSemaphoreGive(hap_type_id_table.lock);
+    }
+    return id;
+}
+
+hap_type_id_t hap_type_id_get(const char *type_uuid)
+{
+    return hap_type_id_lookup(type_uuid, true);
+}
+
+hap_type_id_t hap_type_id_find(const char *type_uuid)
+{
+    return hap_type_id_lookup(type_uuid, false);
+}
@@ -0,0 +1,677 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <string.h>
+#include <hap.h>
+#include <hap_platform_memory.h>
+#include <esp_mfi_base64.h>
+#include <num_convert.h>
+#include <esp_hap_write_parser.h>
+
+/* A HAP write request has a fixed schema:
+ * {"characteristics":[{"aid":1,"iid":9,"value":true,...},...],"pid":..}
+ * So instead of first tokenizing the whole JSON and then looking up each key by
+ * name, the request is walked just once, and the values of the known keys are
+ * recorded as they are found. Strings are unescaped in place, since the result is
+ * never longer than the escaped representation.
+ */
+typedef struct {
+    char *cur;
+    char *end;
+} hap_wp_cursor_t;
+
+static bool hap_wp_is_ws(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+static bool hap_wp_is_delim(char c)
+{
+    return (hap_wp_is_ws(c) || c == ',' || c == '}' || c == ']' || c == ':' || c == '\0');
+}
+
+static void hap_wp_skip_ws(hap_wp_cursor_t *c)
+{
+    while (c->cur < c->end && hap_wp_is_ws(*c->cur)) {
+        c->cur++;
+    }
+}
+
+static bool hap_wp_expect(hap_wp_cursor_t *c, char ch)
+{
+    hap_wp_skip_ws(c);
+    if (c->cur < c->end && *c->cur == ch) {
+        c->cur++;
+        return true;
+    }
+    return false;
+}
+
+static int hap_wp_hex4(const char *s, uint32_t *out)
+{
+    uint32_t val = 0;
+    int i;
+    for (i = 0; i < 4; i++) {
+        char ch = s[i];
+        val <<= 4;
+        if (ch >= '0' && ch <= '9') {
+            val |= ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            val |= ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            val |= ch - 'A' + 10;
+        } else {
+            return HAP_FAIL;
+        }
+    }
+    *out = val;
+    return HAP_SUCCESS;
+}
+
+static int hap_wp_utf8_encode(char *out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out[0] = cp;
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = 0xC0 | (cp >> 6);
+        out[1] = 0x80 | (cp & 0x3F);
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = 0xE0 | (cp >> 12);
+        out[1] = 0x80 | ((cp >> 6) & 0x3F);
+        out[2] = 0x80 | (cp & 0x3F);
+        return 3;
+    }
+    out[0] = 0xF0 | (cp >> 18);
+    out[1] = 0x80 | ((cp >> 12) & 0x3F);
+    out[2] = 0x80 | ((cp >> 6) & 0x3F);
+    out[3] = 0x80 | (cp & 0x3F);
+    return 4;
+}
+
+/* Parse a string starting at the opening quote, unescaping it in place.
+ * The NULL termination is written at the closing quote (or earlier, if there
+ * were escape sequences), which has already been consumed by then.
+ */
+static int hap_wp_parse_string(hap_wp_cursor_t *c, char **str, int *len)
+{
+    char *src = c->cur + 1;
+    char *dst = src;
+    *str = src;
+    while (src < c->end) {
+        char ch = *src++;
+        if (ch == '"') {
+            *dst = '\0';
+            *len = dst - *str;
+            c->cur = src;
+            return HAP_SUCCESS;
+        }
+        if (ch != '\\') {
+            *dst++ = ch;
+            continue;
+        }
+        if (src >= c->end) {
+            break;
+        }
+        ch = *src++;
+        switch (ch) {
+            case '"':
+            case '\\':
+            case '/':
+                *dst++ = ch;
+                break;
+            case 'b':
+                *dst++ = '\b';
+                break;
+            case 'f':
+                *dst++ = '\f';
+                break;
+            case 'n':
+                *dst++ = '\n';
+                break;
+            case 'r':
+                *dst++ = '\r';
+                break;
+            case 't':
+                *dst++ = '\t';
+                break;
+            case 'u': {
+                uint32_t cp, low;
+                if ((c->end - src < 4) || (hap_wp_hex4(src, &cp) != HAP_SUCCESS)) {
+                    return HAP_FAIL;
+                }
+                src += 4;
+                /* Combine a surrogate pair into a single code point */
+                if ((cp >= 0xD800) && (cp <= 0xDBFF) && (c->end - src >= 6) &&
+                        (src[0] == '\\') && (src[1] == 'u') &&
+                        (hap_wp_hex4(src + 2, &low) == HAP_SUCCESS) &&
+                        (low >= 0xDC00) && (low <= 0xDFFF)) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    src += 6;
+                }
+                dst += hap_wp_utf8_encode(dst, cp);
+                break;
+            }
+            default:
+                return HAP_FAIL;
+        }
+    }
+    return HAP_FAIL;
+}
+
+/* Skip a nested object or array, without interpreting its contents */
+static int hap_wp_skip_container(hap_wp_cursor_t *c)
+{
+    int depth = 0;
+    bool in_str = false;
+    while (c->cur < c->end) {
+        char ch = *c->cur++;
+        if (in_str) {
+            if (ch == '\\') {
+                c->cur++;
+            } else if (ch == '"') {
+                in_str = false;
+            }
+        } else if (ch == '"') {
+            in_str = true;
+        } else if (ch == '{' || ch == '[') {
+            depth++;
+        } else if (ch == '}' || ch == ']') {
+            if (--depth == 0) {
+                return HAP_SUCCESS;
+            }
+        }
+    }
+    return HAP_FAIL;
+}
+
+static int hap_wp_parse_val(hap_wp_cursor_t *c, hap_wp_val_t *val)
+{
+    hap_wp_skip_ws(c);
+    if (c->cur >= c->end) {
+        return HAP_FAIL;
+    }
+    char ch = *c->cur;
+    if (ch == '"') {
+        val->type = HAP_WP_VAL_STRING;
+        return hap_wp_parse_string(c, &val->str, &val->len);
+    }
+    val->str = c->cur;
+    if (ch == '{' || ch == '[') {
+        val->type = HAP_WP_VAL_OTHER;
+        int ret = hap_wp_skip_container(c);
+        val->len = c->cur - val->str;
+        return ret;
+    }
+    while (c->cur < c->end && !hap_wp_is_delim(*c->cur)) {
+        c->cur++;
+    }
+    val->len = c->cur - val->str;
+    if ((val->len == 4) && !strncmp(val->str, "true", 4)) {
+        val->type = HAP_WP_VAL_TRUE;
+    } else if ((val->len == 5) && !strncmp(val->str, "false", 5)) {
+        val->type = HAP_WP_VAL_FALSE;
+    } else if ((val->len == 4) && !strncmp(val->str, "null", 4)) {
+        val->type = HAP_WP_VAL_NULL;
+    } else if ((ch == '-') || (ch >= '0' && ch <= '9')) {
+        val->type = HAP_WP_VAL_NUMBER;
+    } else {
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
+}
+
+static int hap_wp_parse_key(hap_wp_cursor_t *c, char **key, int *key_len)
+{
+    hap_wp_skip_ws(c);
+    if ((c->cur >= c->end) || (*c->cur != '"')) {
+        return HAP_FAIL;
+    }
+    if (hap_wp_parse_string(c, key, key_len) != HAP_SUCCESS) {
+        return HAP_FAIL;
+    }
+    return hap_wp_expect(c, ':') ? HAP_SUCCESS : HAP_FAIL;
+}
+
+static hap_wp_val_t *hap_wp_obj_field(hap_wp_obj_t *obj, const char *key, int key_len)
+{
+    switch (key_len) {
+        case 1:
+            if (key[0] == 'r')
+                return &obj->r;
+            break;
+        case 2:
+            if (!memcmp(key, "ev", 2))
+                return &obj->ev;
+            break;
+        case 3:
+            if (!memcmp(key, "aid", 3))
+                return &obj->aid;
+            if (!memcmp(key, "iid", 3))
+                return &obj->iid;
+            break;
+        case 5:
+            if (!memcmp(key, "value", 5))
+                return &obj->value;
+            break;
+        case 6:
+            if (!memcmp(key, "remote", 6))
+                return &obj->remote;
+            break;
+        case 8:
+            if (!memcmp(key, "authData", 8))
+                return &obj->auth_data;
+            break;
+        default:
+            break;
+    }
+    return NULL;
+}
+
+static int hap_wp_parse_obj(hap_wp_cursor_t *c, hap_wp_obj_t *obj)
+{
+    memset(obj, 0, sizeof(hap_wp_obj_t));
+    if (!hap_wp_expect(c, '{')) {
+        return HAP_FAIL;
+    }
+    if (hap_wp_expect(c, '}')) {
+        return HAP_SUCCESS;
+    }
+    do {
+        char *key;
+        int key_len;
+        hap_wp_val_t unused;
+        if (hap_wp_parse_key(c, &key, &key_len) != HAP_SUCCESS) {
+            return HAP_FAIL;
+        }
+        hap_wp_val_t *val = hap_wp_obj_field(obj, key, key_len);
+        if (hap_wp_parse_val(c, val ? val : &unused) != HAP_SUCCESS) {
+            return HAP_FAIL;
+        }
+    } while (hap_wp_expect(c, ','));
+    return hap_wp_expect(c, '}') ? HAP_SUCCESS : HAP_FAIL;
+}
+
+static int hap_wp_parse_char_arr(hap_wp_cursor_t *c, hap_wp_obj_cb_t obj_cb, void *priv)
+{
+    if (!hap_wp_expect(c, '[')) {
+        return HAP_FAIL;
+    }
+    if (hap_wp_expect(c, ']')) {
+        return HAP_SUCCESS;
+    }
+    do {
+        hap_wp_obj_t obj;
+        if (hap_wp_parse_obj(c, &obj) != HAP_SUCCESS) {
+            return HAP_FAIL;
+        }
+        if (obj_cb(&obj, priv) != HAP_SUCCESS) {
+            return HAP_FAIL;
+        }
+    } while (hap_wp_expect(c, ','));
+    return hap_wp_expect(c, ']') ? HAP_SUCCESS : HAP_FAIL;
+}
+
+int hap_wp_parse(char *buf, int len, hap_wp_obj_cb_t obj_cb, void *priv,
+        int64_t *pid, bool *pid_found)
+{
+    hap_wp_cursor_t c = {
+        .cur = buf,
+        .end = buf + len,
+    };
+    *pid_found = false;
+    if (!hap_wp_expect(&c, '{')) {
+        return HAP_FAIL;
+    }
+    if (hap_wp_expect(&c, '}')) {
+        return HAP_SUCCESS;
+    }
+    do {
+        char *key;
+        int key_len;
+        if (hap_wp_parse_key(&c, &key, &key_len) != HAP_SUCCESS) {
+            return HAP_FAIL;
+        }
+        if ((key_len == strlen("characteristics")) && !memcmp(key, "characteristics", key_len)) {
+            if (hap_wp_parse_char_arr(&c, obj_cb, priv) != HAP_SUCCESS) {
+                return HAP_FAIL;
+            }
+            continue;
+        }
+        hap_wp_val_t val;
+        if (hap_wp_parse_val(&c, &val) != HAP_SUCCESS) {
+            return HAP_FAIL;
+        }
+        if ((key_len == 3) && !memcmp(key, "pid", 3)) {
+            if (hap_wp_val_get_int64(&val, pid) == HAP_SUCCESS) {
+                *pid_found = true;
+            }
+        }
+    } while (hap_wp_expect(&c, ','));
+    return hap_wp_expect(&c, '}') ? HAP_SUCCESS : HAP_FAIL;
+}
+
+#define HAP_WP_OBJ_BUF_INIT_SIZE    128
+
+void hap_wp_stream_init(hap_wp_stream_t *stream, int obj_max, hap_wp_obj_cb_t obj_cb, void *priv)
+{
+    memset(stream, 0, sizeof(hap_wp_stream_t));
+    stream->obj_max = obj_max;
+    stream->obj_cb = obj_cb;
+    stream->priv = priv;
+}
+
+static int hap_wp_stream_obj_append(hap_wp_stream_t *stream, char ch)
+{
+    if (stream->obj_len == stream->obj_size) {
+        int new_size = stream->obj_size ? stream->obj_size * 2 : HAP_WP_OBJ_BUF_INIT_SIZE;
+        if (new_size > stream->obj_max) {
+            new_size = stream->obj_max;
+        }
+        if (new_size <= stream->obj_len) {
+            return HAP_FAIL;
+        }
+        char *new_buf = hap_platform_memory_malloc(new_size);
+        if (!new_buf) {
+            return HAP_FAIL;
+        }
+        if (stream->obj_buf) {
+            memcpy(new_buf, stream->obj_buf, stream->obj_len);
+            hap_platform_memory_free(stream->obj_buf);
+        }
+        stream->obj_buf = new_buf;
+        stream->obj_size = new_size;
+    }
+    stream->obj_buf[stream->obj_len++] = ch;
+    return HAP_SUCCESS;
+}
+
+static int hap_wp_stream_obj_end(hap_wp_stream_t *stream)
+{
+    hap_wp_cursor_t c = {
+        .cur = stream->obj_buf,
+        .end = stream->obj_buf + stream->obj_len,
+    };
+    hap_wp_obj_t obj;
+    if (hap_wp_parse_obj(&c, &obj) != HAP_SUCCESS) {
+        return HAP_FAIL;
+    }
+    stream->obj_len = 0;
+    return stream->obj_cb(&obj, stream->priv);
+}
+
+static void hap_wp_stream_member_append(hap_wp_stream_t *stream, char ch)
+{
+    if (stream->member_len < 0) {
+        return;
+    }
+    /* Leave space for NULL termination */
+    if (stream->member_len >= sizeof(stream->member) - 1) {
+        stream->member_len = -1;
+        return;
+    }
+    stream->member[stream->member_len++] = ch;
+}
+
+/* Parse the key of the member collected so far, which should be followed only by the colon */
+static int hap_wp_stream_member_key(hap_wp_stream_t *stream, hap_wp_cursor_t *c,
+        char **key, int *key_len)
+{
+    if (stream->member_len < 0) {
+        return HAP_FAIL;
+    }
+    stream->member[stream->member_len] = '\0';
+    c->cur = stream->member;
+    c->end = stream->member + stream->member_len;
+    return hap_wp_parse_key(c, key, key_len);
+}
+
+static int hap_wp_stream_member_end(hap_wp_stream_t *stream)
+{
+    hap_wp_cursor_t c;
+    char *key;
+    int key_len;
+    hap_wp_val_t val;
+    if (stream->member_len <= 0) {
+        stream->member_len = 0;
+        return HAP_SUCCESS;
+    }
+    int ret = hap_wp_stream_member_key(stream, &c, &key, &key_len);
+    stream->member_len = 0;
+    if (ret != HAP_SUCCESS) {
+        /* Nothing but whitespace, as in an empty object, is fine */
+        c.cur = stream->member;
+        hap_wp_skip_ws(&c);
+        return (c.cur == c.end) ? HAP_SUCCESS : HAP_FAIL;
+    }
+    if (hap_wp_parse_val(&c, &val) != HAP_SUCCESS) {
+        return HAP_FAIL;
+    }
+    hap_wp_skip_ws(&c);
+    if (c.cur != c.end) {
+        return HAP_FAIL;
+    }
+    if ((key_len == 3) && !memcmp(key, "pid", 3)) {
+        if (hap_wp_val_get_int64(&val, &stream->pid) == HAP_SUCCESS) {
+            stream->pid_found = true;
+        }
+    }
+    return HAP_SUCCESS;
+}
+
+static bool hap_wp_stream_is_chars_member(hap_wp_stream_t *stream)
+{
+    hap_wp_cursor_t c;
+    char *key;
+    int key_len;
+    if (hap_wp_stream_member_key(stream, &c, &key, &key_len) != HAP_SUCCESS) {
+        return false;
+    }
+    hap_wp_skip_ws(&c);
+    return ((c.cur == c.end) && (key_len == strlen("characteristics")) &&
+            !memcmp(key, "characteristics", key_len));
+}
+
+/* Track strings, and return true if the character is outside a string */
+static bool hap_wp_stream_is_structural(hap_wp_stream_t *stream, char ch)
+{
+    if (stream->in_str) {
+        if (stream->esc) {
+            stream->esc = false;
+        } else if (ch == '\\') {
+            stream->esc = true;
+        } else if (ch == '"') {
+            stream->in_str = false;
+        }
+        return false;
+    }
+    if (ch == '"') {
+        stream->in_str = true;
+        return false;
+    }
+    return true;
+}
+
+int hap_wp_stream_feed(hap_wp_stream_t *stream, const char *data, int len)
+{
+    int i;
+    for (i = 0; i < len; i++) {
+        char ch = data[i];
+        if (stream->done) {
+            if (!hap_wp_is_ws(ch)) {
+                return HAP_FAIL;
+            }
+            continue;
+        }
+        if (stream->depth == 0) {
+            if (ch == '{') {
+                stream->depth = 1;
+                stream->member_len = 0;
+            } else if (!hap_wp_is_ws(ch)) {
+                return HAP_FAIL;
+            }
+            continue;
+        }
+        bool structural = hap_wp_stream_is_structural(stream, ch);
+        if (stream->in_chars) {
+            if (stream->depth == 2) {
+                /* Between the objects of the "characteristics" array */
+                if (structural && (ch == '{')) {
+                    stream->obj_len = 0;
+                    stream->depth++;
+                } else if (structural && (ch == ']')) {
+                    stream->in_chars = false;
+                    stream->depth--;
+                    continue;
+                } else if (structural && ((ch == ',') || hap_wp_is_ws(ch))) {
+                    continue;
+                } else {
+                    return HAP_FAIL;
+                }
+            } else if (structural) {
+                if ((ch == '{') || (ch == '[')) {
+                    stream->depth++;
+                } else if ((ch == '}') || (ch == ']')) {
+                    stream->depth--;
+                }
+            }
+            if (hap_wp_stream_obj_append(stream, ch) != HAP_SUCCESS) {
+                return HAP_FAIL;
+            }
+            if (stream->depth == 2) {
+                if (hap_wp_stream_obj_end(stream) != HAP_SUCCESS) {
+                    return HAP_FAIL;
+                }
+            }
+            continue;
+        }
+        if (stream->depth > 1) {
+            /* Skipping the nested value of some other member */
+            if (structural) {
+                if ((ch == '{') || (ch == '[')) {
+                    stream->depth++;
+                } else if ((ch == '}') || (ch == ']')) {
+                    stream->depth--;
+                }
+            }
+            continue;
+        }
+        /* A top level member */
+        if (structural) {
+            if (ch == ',') {
+                if (hap_wp_stream_member_end(stream) != HAP_SUCCESS) {
+                    return HAP_FAIL;
+                }
+                continue;
+            } else if (ch == '}') {
+                if (hap_wp_stream_member_end(stream) != HAP_SUCCESS) {
+                    return HAP_FAIL;
+                }
+                stream->depth = 0;
+                stream->done = true;
+                continue;
+            } else if ((ch == '{') || (ch == '[')) {
+                if ((ch == '[') && hap_wp_stream_is_chars_member(stream)) {
+                    stream->in_chars = true;
+                }
+                stream->depth++;
+                stream->member_len = -1;
+                continue;
+            }
+        }
+        hap_wp_stream_member_append(stream, ch);
+    }
+    return HAP_SUCCESS;
+}
+
+int hap_wp_stream_end(hap_wp_stream_t *stream)
+{
+    if (stream->obj_buf) {
+        hap_platform_memory_free(stream->obj_buf);
+        stream->obj_buf = NULL;
+    }
+    return stream->done ? HAP_SUCCESS : HAP_FAIL;
+}
+
+int hap_wp_val_get_bool(const hap_wp_val_t *val, bool *b)
+{
+    if (val->type == HAP_WP_VAL_TRUE) {
+        *b = true;
+    } else if (val->type == HAP_WP_VAL_FALSE) {
+        *b = false;
+    } else {
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
+}
+
+int hap_wp_val_get_int(const hap_wp_val_t *val, int *i)
+{
+    int32_t tmp;
+    if ((val->type != HAP_WP_VAL_NUMBER) || (str_to_int(val->str, val->len, &tmp) != 0)) {
+        return HAP_FAIL;
+    }
+    *i = tmp;
+    return HAP_SUCCESS;
+}
+
+int hap_wp_val_get_int64(const hap_wp_val_t *val, int64_t *i64)
+{
+    if ((val->type != HAP_WP_VAL_NUMBER) || (str_to_int64(val->str, val->len, i64) != 0)) {
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
+}
+
+int hap_wp_val_get_float(const hap_wp_val_t *val, float *f)
+{
+    if ((val->type != HAP_WP_VAL_NUMBER) || (str_to_float(val->str, val->len, f) != 0)) {
+        return HAP_FAIL;
+    }
+    return HAP_SUCCESS;
+}
+
+int hap_wp_val_get_string(const hap_wp_val_t *val, char **s)
+{
+    if (val->type != HAP_WP_VAL_STRING) {
+        return HAP_FAIL;
+    }
+    *s = val->str;
+    return HAP_SUCCESS;
+}
+
+int hap_wp_val_get_data(hap_wp_val_t *val, uint8_t **buf, uint32_t *buflen)
+{
+    int out_len = 0;
+    if (val->type != HAP_WP_VAL_STRING) {
+        return HAP_FAIL;
+    }
+    /* Decoded data is always shorter than the base64 string, so this can be done in place */
+    if (esp_mfi_base64_decode(val->str, val->len, val->str, val->len + 1, &out_len) != 0) {
+        return HAP_FAIL;
+    }
+    *buf = (uint8_t *)val->str;
+    *buflen = out_len;
+    return HAP_SUCCESS;
+}
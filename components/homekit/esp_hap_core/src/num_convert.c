@@ -0,0 +1,294 @@
+// Copyright 2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <num_convert.h>
+
+/* Maximum number of decimal places used while formatting floats. 9 significant
+ * digits are always enough to represent a float exactly.
+ */
+#define FLOAT_MAX_DECIMALS  9
+
+static const uint32_t pow10_u32[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* Digits are generated from the end of a temporary buffer, in reverse */
+int uint_to_str(char *buf, uint32_t val)
+{
+    char tmp[10];
+    int i = sizeof(tmp);
+    do {
+        tmp[--i] = '0' + (val % 10);
+        val /= 10;
+    } while (val);
+    int len = sizeof(tmp) - i;
+    memcpy(buf, &tmp[i], len);
+    buf[len] = '\0';
+    return len;
+}
+
+int int_to_str(char *buf, int32_t val)
+{
+    if (val < 0) {
+        buf[0] = '-';
+        /* Negating as unsigned, so that INT32_MIN is also handled */
+        return uint_to_str(buf + 1, 0U - (uint32_t)val) + 1;
+    }
+    return uint_to_str(buf, val);
+}
+
+static int u64_to_str(char *buf, uint64_t val)
+{
+    if (val <= UINT32_MAX) {
+        return uint_to_str(buf, val);
+    }
+    char tmp[20];
+    int i = sizeof(tmp);
+    do {
+        tmp[--i] = '0' + (val % 10);
+        val /= 10;
+    } while (val);
+    int len = sizeof(tmp) - i;
+    memcpy(buf, &tmp[i], len);
+    buf[len] = '\0';
+    return len;
+}
+
+/* Number of decimal places in a step value like 0.1, 0.5 or 0.01.
+ * A relative tolerance is used since the step is itself an approximation,
+ * (0.1f is actually 0.100000001490116...)
+ */
+static int float_step_decimals(float step)
+{
+    double s = fabs((double)step);
+    int d;
+    for (d = 0; d < FLOAT_MAX_DECIMALS; d++) {
+        double scaled = s * pow10_u32[d];
+        if (fabs(scaled - floor(scaled + 0.5)) < scaled * 1e-5) {
+            break;
+        }
+    }
+    return d;
+}
+
+static uint64_t float_scale(double abs_val, int decimals)
+{
+    return (uint64_t)(abs_val * pow10_u32[decimals] + 0.5);
+}
+
+int float_to_str(char *buf, float val, float step)
+{
+    float abs_val = fabsf(val);
+    int d;
+    if (isnan(val) || isinf(val)) {
+        /* Not representable in JSON */
+        strcpy(buf, "0");
+        return 1;
+    }
+    if (step != 0) {
+        d = float_step_decimals(step);
+    } else {
+        /* Find the least number of decimal places that give back the same float */
+        for (d = 0; d <= FLOAT_MAX_DECIMALS; d++) {
+            if ((double)abs_val * pow10_u32[d] >= 1e18) {
+                break;
+            }
+            if ((float)((double)float_scale(abs_val, d) / pow10_u32[d]) == abs_val) {
+                break;
+            }
+        }
+    }
+    /* Very large values, or very small values needing more decimal places */
+    if ((d > FLOAT_MAX_DECIMALS) || ((double)abs_val * pow10_u32[d] >= 1e18)) {
+        return snprintf(buf, NUM_STR_MAX_LEN, "%.9g", (double)val);
+    }
+    uint64_t scaled = float_scale(abs_val, d);
+    char *p = buf;
+    if ((val < 0) && scaled) {
+        *p++ = '-';
+    }
+    p += u64_to_str(p, scaled / pow10_u32[d]);
+    uint32_t frac = scaled % pow10_u32[d];
+    if (frac) {
+        /* Strip the trailing zeros */
+        while ((frac % 10) == 0) {
+            frac /= 10;
+            d--;
+        }
+        *p++ = '.';
+        char tmp[FLOAT_MAX_DECIMALS + 1];
+        int len = uint_to_str(tmp, frac);
+        /* Leading zeros of the fractional part */
+        memset(p, '0', d - len);
+        p += d - len;
+        memcpy(p, tmp, len);
+        p += len;
+    }
+    *p = '\0';
+    return p - buf;
+}
+
+static bool is_digit(char c)
+{
+    return (c >= '0' && c <= '9');
+}
+
+int str_to_int(const char *str, int len, int32_t *val)
+{
+    uint32_t acc = 0;
+    bool neg = false;
+    int i = 0;
+    if ((len > 0) && (str[0] == '-')) {
+        neg = true;
+        i++;
+    }
+    if (i >= len) {
+        return -1;
+    }
+    for (; i < len; i++) {
+        if (!is_digit(str[i])) {
+            return -1;
+        }
+        uint32_t digit = str[i] - '0';
+        if (acc > (UINT32_MAX - digit) / 10) {
+            return -1;
+        }
+        acc = acc * 10 + digit;
+    }
+    if (neg) {
+        if (acc > (uint32_t)INT32_MAX + 1) {
+            return -1;
+        }
+        *val = (int32_t)(0U - acc);
+    } else {
+        *val = (int32_t)acc;
+    }
+    return 0;
+}
+
+int str_to_int64(const char *str, int len, int64_t *val)
+{
+    uint64_t acc = 0;
+    bool neg = false;
+    int i = 0;
+    if ((len > 0) && (str[0] == '-')) {
+        neg = true;
+        i++;
+    }
+    if (i >= len) {
+        return -1;
+    }
+    for (; i < len; i++) {
+        if (!is_digit(str[i])) {
+            return -1;
+        }
+        uint64_t digit = str[i] - '0';
+        if (acc > ((uint64_t)INT64_MAX + 1 - digit) / 10) {
+            return -1;
+        }
+        acc = acc * 10 + digit;
+    }
+    if (neg) {
+        *val = (int64_t)(0ULL - acc);
+    } else {
+        if (acc > INT64_MAX) {
+            return -1;
+        }
+        *val = (int64_t)acc;
+    }
+    return 0;
+}
+
+/* Powers of 10 which are exactly representable as doubles */
+static const double pow10_double[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#define POW10_DOUBLE_MAX    22
+
+int str_to_float(const char *str, int len, float *val)
+{
+    uint64_t mant = 0;
+    int exp10 = 0;
+    bool neg = false;
+    bool digits = false;
+    int i = 0;
+    if ((i < len) && (str[i] == '-')) {
+        neg = true;
+        i++;
+    }
+    /* Digits beyond what a uint64 can hold only affect the exponent. The precision
+     * is far more than what a float needs anyway.
+     */
+    for (; (i < len) && is_digit(str[i]); i++) {
+        if (mant < 100000000000000000ULL) {
+            mant = mant * 10 + (str[i] - '0');
+        } else {
+            exp10++;
+        }
+        digits = true;
+    }
+    if ((i < len) && (str[i] == '.')) {
+        for (i++; (i < len) && is_digit(str[i]); i++) {
+            if (mant < 100000000000000000ULL) {
+                mant = mant * 10 + (str[i] - '0');
+                exp10--;
+            }
+            digits = true;
+        }
+    }
+    if (!digits) {
+        return -1;
+    }
+    if ((i < len) && ((str[i] == 'e') || (str[i] == 'E'))) {
+        bool exp_neg = false;
+        int exp = 0;
+        i++;
+        if ((i < len) && ((str[i] == '-') || (str[i] == '+'))) {
+            exp_neg = (str[i] == '-');
+            i++;
+        }
+        if ((i >= len) || !is_digit(str[i])) {
+            return -1;
+        }
+        for (; (i < len) && is_digit(str[i]); i++) {
+            if (exp < 1000) {
+                exp = exp * 10 + (str[i] - '0');
+            }
+        }
+        exp10 += exp_neg ? -exp : exp;
+    }
+    if (i != len) {
+        return -1;
+    }
+    double result = (double)mant;
+    if (mant) {
+        while (exp10 > 0) {
+            int e = exp10 > POW10_DOUBLE_MAX ? POW10_DOUBLE_MAX : exp10;
+            result *= pow10_double[e];
+            exp10 -= e;
+        }
+        while (exp10 < 0) {
+            int e = -exp10 > POW10_DOUBLE_MAX ? POW10_DOUBLE_MAX : -exp10;
+            result /= pow10_double[e];
+            exp10 += e;
+        }
+    }
+    *val = (float)(neg ? -result : result);
+    return 0;
+}
@@ -24,5 +24,6 @@
 #ifndef _HAP_BCT_PRIV_H_
 #define _HAP_BCT_PRIV_H_
 void hap_handle_bct_change_name();
-void hap_handle_hot_plug();
+void hap_handle_hot_plug_begin();
+void hap_handle_hot_plug_end();
 #endif /* _HAP_BCT_PRIV_H_ */
@@ -35,52 +35,64 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-#define HAP_CHAR_MIN_FLAG		(1 << 0)
-#define HAP_CHAR_MAX_FLAG		(1 << 1)
-#define HAP_CHAR_STEP_FLAG		(1 << 2)
-#define HAP_CHAR_MAXLEN_FLAG		(1 << 3)
-#define HAP_CHAR_MAXDATALEN_FLAG	(1 << 4)
-
 /**
  * @brief characteristics object information
+ *
+ * Fields used by read, write and notify are grouped at the start, ordered so
+ * that the structure has no padding.
  */
 typedef struct  {
     uint32_t iid;        /* Characteristic instance ID */
-    const char *type_uuid;       /* Apple's characteristic UUID */
-    uint16_t permission; /* Characteristic permission */
-    hap_char_format_t      format;   /* data type of the value */
-    hap_val_t       val;
-    bool ev;         /* check if characteristics supports event */
-    char *description;      /* characteristics's description */
-    char *unit;
-
-    /* Characteristics's father subsystem */
-    hap_serv_t                *parent;
-
-    uint8_t constraint_flags;
-
-    hap_val_t       max;       /* maximum value, maxlen, max data len*/
-    hap_val_t       min;       /* minimum value */
-    hap_val_t       step;      /* step value */
-
-    hap_char_t *next_char;
     /* Bitmap to indicate which controllers have enabled notifications
      */
-	uint16_t ev_ctrls;
-
+    uint16_t ev_ctrls;
     /* Bitmap indicating the last controller that modified the value.
      * No notification should be sent to the owner
      */
     uint16_t owner_ctrl;
-
-    /* Pointer to a valid values range. It will be a 2 byte array, if set from application */
-    uint8_t *valid_vals_range;
-    /* Since a list of valid values can have any length, using a pointer here,
-     * which will be allocated if valid values are set for a characteristic
+    uint16_t permission; /* Characteristic permission */
+    uint8_t format;      /* data type of the value (hap_char_format_t) */
+    uint8_t constraint_flags;
+    /* The next two flags are written from different tasks (notif_pending also
+     * from ISRs), so they must not share a byte with other flags.
      */
-    uint8_t *valid_vals;
-    size_t valid_vals_cnt;
+    /* Set if hap_char_update_val() was called from a read routine */
     bool update_called;
+    /* Set if an event notification is pending for the current value, i.e. if the
+     * characteristic is on the pending notification list
+     */
+    bool notif_pending;
+    /* Set if meta was allocated for this characteristic, rather than pointing
+     * into a constant descriptor. Written only by the configuration APIs, in
+     * its own byte so that flag writes from other tasks cannot flip it.
+     */
+    bool meta_owned;
+    /* Set if meta->valid_vals was allocated for this characteristic */
+    bool valid_vals_owned;
+    hap_val_t       val;
+
+    hap_char_t *next_char;
+    /* Next characteristic on the pending notification list */
+    hap_char_t *next_pending;
+    /* Characteristics's father subsystem */
+    hap_serv_t                *parent;
+    const char *type_uuid;       /* Apple's characteristic UUID */
+    /* Constraints and metadata. NULL if none were set */
+    const hap_char_meta_t *meta;
+    hap_type_id_t type_id;      /* Interned type_uuid */
+
+    /* Minimum interval (in msec) between two event notifications */
+    uint32_t min_notif_interval;
+    /* Time (in msec) at which the last event notification was sent */
+    uint32_t last_notif_time;
+#ifdef CONFIG_HAP_ACC_DB_CACHE_ENABLE
+    /* Pre-serialized static part of the characteristic object for /accessories
+     * (type, perms, format, constraints, etc.), valid only if db_json_gen matches
+     * the current generation of the accessory database cache.
+     */
+    char *db_json;
+    uint32_t db_json_gen;
+#endif /* CONFIG_HAP_ACC_DB_CACHE_ENABLE */
 } __hap_char_t;
 
 void hap_char_manage_notification(hap_char_t *hc, int index, bool ev);
@@ -88,9 +100,13 @@ bool hap_char_is_ctrl_subscribed(hap_char_t *hc, int index);
 void hap_char_set_owner_ctrl(hap_char_t *hc, int index);
 bool hap_char_is_ctrl_owner(hap_char_t *hc, int index);
 void hap_disable_all_char_notif(int index);
+void hap_char_db_cache_invalidate(__hap_char_t *_hc);
 int hap_char_check_val_constraints(__hap_char_t *_hc, hap_val_t *val);
 int hap_event_queue_init();
-hap_char_t * hap_get_pending_notif_char();
+int hap_get_pending_notif_chars(hap_char_t **char_arr, int max_cnt);
+void hap_drop_pending_notif_chars();
+void hap_notif_stats_add(uint32_t sent, uint32_t dropped);
+void hap_handle_notif_trigger();
 #ifdef __cplusplus
 }
 #endif
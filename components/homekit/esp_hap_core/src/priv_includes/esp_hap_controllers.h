@@ -26,6 +26,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <esp_hap_ed25519.h>
 
 #define HAP_MAX_CONTROLLERS 16
 #define HAP_CTRL_ID_LEN		64
@@ -47,6 +49,8 @@ typedef struct {
 	bool valid;
     /* Index is used just for better managing the keystore data */
     uint8_t index;
+    /* info.ltpk decoded on first use by hap_controller_verify_sign() */
+    hap_ed25519_pk_t *ltpk_cache;
 } hap_ctrl_data_t;
 
 int hap_controllers_init();
@@ -54,7 +58,11 @@ bool is_accessory_paired();
 bool is_admin_paired();
 hap_ctrl_data_t *hap_controller_get_empty_loc();
 int hap_controller_save(hap_ctrl_data_t *ctrl_data);
+int hap_controller_set_perms(hap_ctrl_data_t *ctrl_data, uint8_t perms);
 void hap_controller_remove(hap_ctrl_data_t *ctrl_data);
+void hap_controller_remove_all();
+int hap_controller_verify_sign(hap_ctrl_data_t *ctrl_data, const uint8_t *sign,
+        const uint8_t *data, size_t data_len);
 hap_ctrl_data_t *hap_get_controller(char *ctrl_id);
 void hap_erase_controller_info();
 
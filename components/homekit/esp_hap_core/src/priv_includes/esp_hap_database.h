@@ -43,7 +43,7 @@
 #define HAP_ACC_ID_LEN		18 /* AA:BB:CC:XX:YY:ZZ\0 */
 #define ED_KEY_LEN		32
 #define HAP_SW_TOKEN_MAX_LEN        1200
-
+#define HAP_LOOP_QUEUE_SIZE         10
 
 typedef struct {
     hap_acc_cfg_t primary_acc;
@@ -82,6 +82,8 @@ typedef struct {
     bool disconnected_event_sent;
     hap_mfi_auth_type_t auth_type;
     TimerHandle_t pairing_mode_timer;
+    TimerHandle_t notif_timer;
+    hap_notif_stats_t notif_stats;
 } hap_priv_t;
 
 extern hap_priv_t hap_priv;
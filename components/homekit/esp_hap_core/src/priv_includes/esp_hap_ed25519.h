@@ -0,0 +1,48 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef _HAP_ED25519_H_
+#define _HAP_ED25519_H_
+#include <stdint.h>
+#include <stddef.h>
+
+/* An Ed25519 public key, decompressed and validated once, so that repeated
+ * signature verifications with the same key can skip that step.
+ */
+typedef struct hap_ed25519_pk hap_ed25519_pk_t;
+
+/* Returns NULL if the key is invalid, or if decoded keys are not supported
+ * by this build (CONFIG_HAP_CTRL_PK_CACHE_ENABLE). The key should then be used
+ * directly with hap_ed25519_verify().
+ */
+hap_ed25519_pk_t *hap_ed25519_pk_decode(const uint8_t *pk);
+void hap_ed25519_pk_free(hap_ed25519_pk_t *dpk);
+
+/* Verifies the detached signature sig over m, using the decoded key dpk if
+ * available, else the raw key pk.
+ * Returns 0 if the signature is valid, like crypto_sign_ed25519_verify_detached().
+ */
+int hap_ed25519_verify(const uint8_t *sig, const uint8_t *m, size_t mlen,
+        const uint8_t *pk, const hap_ed25519_pk_t *dpk);
+#endif /* _HAP_ED25519_H_ */
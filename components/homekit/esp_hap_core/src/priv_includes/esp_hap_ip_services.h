@@ -25,6 +25,10 @@
 #define _HAP_IP_SERVICES_H_
 #include <stdbool.h>
 #include <esp_http_server.h>
+
+/* Time for the mDNS goodbye packets to go out after hap_mdns_deannounce() */
+#define HAP_MDNS_DEANNOUNCE_WAIT_MS 2000
+
 int hap_http_session_not_authorized(httpd_req_t *req);
 int hap_httpd_get_data(httpd_req_t *req, char *buffer, int len);
 int hap_httpd_start();
@@ -32,4 +36,5 @@ int hap_ip_services_start();
 int hap_mdns_announce(bool first);
 int hap_mdns_deannounce();
 void hap_http_send_notif();
+void hap_acc_db_cache_invalidate();
 #endif /* _HAP_IP_SERVICES_H_ */
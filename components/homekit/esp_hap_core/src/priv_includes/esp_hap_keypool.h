@@ -0,0 +1,45 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef _HAP_KEYPOOL_H_
+#define _HAP_KEYPOOL_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Keys generated ahead of time by a low priority task, so that Pair Setup
+ * and Pair Verify do not have to generate them while a controller waits for M2.
+ */
+int hap_keypool_init(void);
+/* Wakes up the pool task to top up the pools. Safe to call even if the
+ * pools are disabled.
+ */
+void hap_keypool_refill(void);
+/* Protects the pools and the related caches. No-op until hap_keypool_init() */
+void hap_keypool_lock(void);
+void hap_keypool_unlock(void);
+/* Moves a pre-generated Curve25519 key pair into sk and pk, and wipes it from the pool.
+ * Returns false on a pool miss, in which case the caller should generate its own.
+ */
+bool hap_curve_keypool_take(uint8_t *sk, uint8_t *pk);
+#endif /* _HAP_KEYPOOL_H_ */
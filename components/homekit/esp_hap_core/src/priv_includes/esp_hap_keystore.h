@@ -27,6 +27,8 @@
 int hap_keystore_init();
 int hap_keystore_get(const char *name_space, const char *key, uint8_t *val, size_t *val_size);
 int hap_keystore_set(const char *name_space, const char *key, const uint8_t *val, const size_t val_len);
+int hap_keystore_set_deferred(const char *name_space, const char *key, const uint8_t *val, const size_t val_len);
+void hap_keystore_flush();
 int hap_keystore_delete(const char *name_space, const char *key);
 int hap_keystore_delete_namespace(const char *name_space);
 int hap_factory_keystore_set(const char *name_space, const char *key, const uint8_t *val, const size_t val_len);
@@ -25,7 +25,19 @@
 #define _HAP_NETWORK_IO_H_
 #include <stdint.h>
 #include <hap_platform_httpd.h>
+typedef struct {
+    const void *buf;
+    int len;
+} hap_iovec_t;
+
 int hap_httpd_send(httpd_handle_t hd, int sockfd, const char *buf, unsigned buf_len, int flags);
 int hap_httpd_recv(httpd_handle_t hd, int sockfd, char *buf, unsigned buf_len, int flags);
+/* Send multiple buffers, packing them into as few encrypted frames as possible */
+int hap_httpd_sendv(httpd_handle_t hd, int sockfd, const hap_iovec_t *iov, int iovcnt, int flags);
+/* Buffer all data sent on the socket using hap_httpd_send() till hap_httpd_uncork()
+ * is called, so that small writes (like HTTP headers and chunk sizes) share frames.
+ */
+void hap_httpd_cork(int sockfd);
+int hap_httpd_uncork(int sockfd);
 
 #endif /* _HAP_NETWORK_IO_H_ */
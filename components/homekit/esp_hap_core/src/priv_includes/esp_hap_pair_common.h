@@ -89,6 +89,17 @@ typedef struct {
 	int curlen;
 } hap_tlv_data_t;
 
+#define HAP_MAX_NW_FRAME_SIZE	1024 /* As per HAP Specifications */
+
+/* Receive side state of an encrypted connection. A complete frame is read and
+ * decrypted at a time, but the plaintext may be consumed over multiple reads.
+ */
+typedef struct {
+	uint16_t pkt_size;
+	uint16_t bytes_read;
+	uint8_t data[HAP_MAX_NW_FRAME_SIZE + POLY_AUTHTAG_LEN];
+} hap_decrypt_frame_t;
+
 typedef struct {
 	uint8_t state;
 	uint8_t encrypt_key[ENCRYPT_KEY_LEN];
@@ -104,6 +115,14 @@ typedef struct {
 	 * Need to make this generic later.
 	 */
 	int conn_identifier;
+	/* Unique for every session added, unlike the session pointer and the socket,
+	 * which get reused. Used to check that a session is still the same one later.
+	 */
+	uint32_t session_id;
+	/* Kept per session so that partially consumed frames of different
+	 * connections do not overwrite each other.
+	 */
+	hap_decrypt_frame_t decrypt_frame;
 } hap_secure_session_t;
 
 void hap_tlv_data_init(hap_tlv_data_t *tlv_data, uint8_t *buf, int buf_size);
@@ -58,4 +58,5 @@ int hap_pair_setup_process(void **ctx, uint8_t *buf, int inlen, int bufsize, int
 void hap_pair_setup_ctx_clean(void *sess_ctx);
 int hap_pair_setup_manage_mfi_auth(pair_setup_ctx_t *ps_ctx, hap_tlv_data_t *tlv_data, hap_tlv_error_t *tlv_error);
 void hap_start_pairing_mode_timer(void);
+void hap_srp_pool_update(void);
 #endif /* _HAP_PAIR_SETUP_H_ */
@@ -47,6 +47,7 @@ typedef struct {
     char                *type_uuid;      /* String that defines the type of the service. */
 
     uint32_t             iid;        /* service instance ID */
+    hap_type_id_t        type_id;    /* Interned type_uuid */
 
     bool                hidden;     /* If set it to be True, the service is not visible to user. */
     bool                primary;    /* If set it to be True, this is the primary service of the accessory. */
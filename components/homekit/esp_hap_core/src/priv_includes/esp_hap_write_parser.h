@@ -0,0 +1,150 @@
+/*
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2020 <ESPRESSIF SYSTEMS (SHANGHAI) PTE LTD>
+ *
+ * Permission is hereby granted for use on ESPRESSIF SYSTEMS products only, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#ifndef _HAP_WRITE_PARSER_H_
+#define _HAP_WRITE_PARSER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Type of a value token found in a HAP write request */
+typedef enum {
+    HAP_WP_VAL_ABSENT = 0,  /* Key not present in the object */
+    HAP_WP_VAL_NULL,
+    HAP_WP_VAL_TRUE,
+    HAP_WP_VAL_FALSE,
+    HAP_WP_VAL_NUMBER,
+    HAP_WP_VAL_STRING,
+    HAP_WP_VAL_OTHER,       /* Nested object or array */
+} hap_wp_val_type_t;
+
+/** A value token, pointing into the request buffer.
+ *
+ * Strings are unescaped in place and NULL terminated. Numbers are not NULL terminated.
+ */
+typedef struct {
+    hap_wp_val_type_t type;
+    char *str;
+    int len;
+} hap_wp_val_t;
+
+/** The keys of a single {"aid":..,"iid":..,"value":..} object in a write request */
+typedef struct {
+    hap_wp_val_t aid;
+    hap_wp_val_t iid;
+    hap_wp_val_t ev;
+    hap_wp_val_t value;
+    hap_wp_val_t auth_data;
+    hap_wp_val_t remote;
+    hap_wp_val_t r;
+} hap_wp_obj_t;
+
+/** Callback invoked for every object in the "characteristics" array, in order.
+ * Returning anything other than HAP_SUCCESS aborts the parsing.
+ */
+typedef int (*hap_wp_obj_cb_t)(hap_wp_obj_t *obj, void *priv);
+
+/** Parse a HAP write request {"characteristics":[...],"pid":..} in a single pass.
+ *
+ * The buffer is modified in place, and the value pointers handed over to obj_cb
+ * remain valid till the buffer is.
+ *
+ * @param[in] buf Request body
+ * @param[in] len Length of the request body
+ * @param[in] obj_cb Callback for each characteristic object
+ * @param[in] priv Private data passed to obj_cb
+ * @param[out] pid Value of the "pid" key, if found
+ * @param[out] pid_found Set to true if the "pid" key was found
+ *
+ * @return HAP_SUCCESS on success
+ * @return HAP_FAIL if the request is not valid JSON or obj_cb returned a failure
+ */
+int hap_wp_parse(char *buf, int len, hap_wp_obj_cb_t obj_cb, void *priv,
+        int64_t *pid, bool *pid_found);
+
+/** Incremental parser for write requests which are too large to be buffered completely.
+ *
+ * Only the top level structure is tracked byte by byte. Each object of the "characteristics"
+ * array is collected in obj_buf, and is parsed and handed over to obj_cb as soon as it closes,
+ * so the memory required is bounded by the largest object rather than the whole request.
+ * The value pointers handed over to obj_cb are valid only till the callback returns.
+ */
+typedef struct {
+    hap_wp_obj_cb_t obj_cb;
+    void *priv;
+    int depth;          /* Nesting depth, with the top level object at 1 */
+    bool in_str;
+    bool esc;
+    bool in_chars;      /* Inside the "characteristics" array */
+    bool done;          /* Top level object has been closed */
+    /* Current top level member (like "pid":123). member_len is -1 if it is being skipped */
+    char member[48];
+    int member_len;
+    char *obj_buf;
+    int obj_len;
+    int obj_size;
+    int obj_max;
+    int64_t pid;
+    bool pid_found;
+} hap_wp_stream_t;
+
+/** Initialise an incremental write request parser
+ *
+ * @param[in] stream Parser context
+ * @param[in] obj_max Maximum size of a single characteristic object
+ * @param[in] obj_cb Callback for each characteristic object
+ * @param[in] priv Private data passed to obj_cb
+ */
+void hap_wp_stream_init(hap_wp_stream_t *stream, int obj_max, hap_wp_obj_cb_t obj_cb, void *priv);
+
+/** Feed the next chunk of the request body to the parser
+ *
+ * @return HAP_SUCCESS on success
+ * @return HAP_FAIL if the data is not valid, an object could not be buffered, or obj_cb failed
+ */
+int hap_wp_stream_feed(hap_wp_stream_t *stream, const char *data, int len);
+
+/** Check that the complete request has been received and release the resources
+ *
+ * @return HAP_SUCCESS if the top level object was complete
+ * @return HAP_FAIL otherwise
+ */
+int hap_wp_stream_end(hap_wp_stream_t *stream);
+
+int hap_wp_val_get_bool(const hap_wp_val_t *val, bool *b);
+int hap_wp_val_get_int(const hap_wp_val_t *val, int *i);
+int hap_wp_val_get_int64(const hap_wp_val_t *val, int64_t *i64);
+int hap_wp_val_get_float(const hap_wp_val_t *val, float *f);
+int hap_wp_val_get_string(const hap_wp_val_t *val, char **s);
+/* Base64 decode a string value in place */
+int hap_wp_val_get_data(hap_wp_val_t *val, uint8_t **buf, uint32_t *buflen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAP_WRITE_PARSER_H_ */
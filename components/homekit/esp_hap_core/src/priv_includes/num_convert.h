@@ -0,0 +1,104 @@
+// Copyright 2020 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/**
+ * \file num_convert.h
+ * \brief Conversion between numbers and their JSON text representation
+ *
+ * This module offers allocation free APIs to format and parse the integers and
+ * floats used as HomeKit characteristic values, without going through the
+ * printf/scanf family of functions.
+ */
+#ifndef _NUM_CONVERT_H
+#define _NUM_CONVERT_H
+
+#include <stdint.h>
+
+/** Size of a buffer large enough for any number formatted by this module,
+ * including the NULL termination
+ */
+#define NUM_STR_MAX_LEN     32
+
+/** Signed Integer to String Conversion
+ *
+ * \param[out] buf Buffer of at least \ref NUM_STR_MAX_LEN bytes
+ * \param[in] val The integer to convert
+ *
+ * \return Length of the NULL terminated string written to buf
+ */
+int int_to_str(char *buf, int32_t val);
+
+/** Unsigned Integer to String Conversion
+ *
+ * \param[out] buf Buffer of at least \ref NUM_STR_MAX_LEN bytes
+ * \param[in] val The integer to convert
+ *
+ * \return Length of the NULL terminated string written to buf
+ */
+int uint_to_str(char *buf, uint32_t val);
+
+/** Float to String Conversion
+ *
+ * If step is non zero, the value is rounded to the number of decimal places
+ * in step (eg. 1 for 0.1 or 0.5). Else, the shortest representation which
+ * converts back to the same float is used.
+ * Trailing zeros are not included, so 21.5 is "21.5" and 20.0 is "20".
+ *
+ * \param[out] buf Buffer of at least \ref NUM_STR_MAX_LEN bytes
+ * \param[in] val The float to convert
+ * \param[in] step Step value of the characteristic, or 0 if none
+ *
+ * \return Length of the NULL terminated string written to buf
+ */
+int float_to_str(char *buf, float val, float step);
+
+/** String to Signed Integer Conversion
+ *
+ * Accepts an optional minus sign followed by decimal digits, which must make up
+ * the complete string. Values up to UINT32_MAX are accepted, so that uint32
+ * characteristics can be written.
+ *
+ * \param[in] str String to convert. Need not be NULL terminated
+ * \param[in] len Length of the string
+ * \param[out] val The converted integer
+ *
+ * \return 0 on success
+ * \return -1 if the string is not a valid integer or is out of range
+ */
+int str_to_int(const char *str, int len, int32_t *val);
+
+/** String to 64 bit Signed Integer Conversion
+ *
+ * \param[in] str String to convert. Need not be NULL terminated
+ * \param[in] len Length of the string
+ * \param[out] val The converted integer
+ *
+ * \return 0 on success
+ * \return -1 if the string is not a valid integer or is out of range
+ */
+int str_to_int64(const char *str, int len, int64_t *val);
+
+/** String to Float Conversion
+ *
+ * Accepts a JSON number, including fraction and exponent parts.
+ *
+ * \param[in] str String to convert. Need not be NULL terminated
+ * \param[in] len Length of the string
+ * \param[out] val The converted float
+ *
+ * \return 0 on success
+ * \return -1 if the string is not a valid number
+ */
+int str_to_float(const char *str, int len, float *val);
+
+#endif /* _NUM_CONVERT_H */
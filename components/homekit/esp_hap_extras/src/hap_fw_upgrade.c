@@ -39,6 +39,7 @@ static const char *TAG = "HAP FW Upgrade";
 
 static hap_fw_upgrade_status_t fw_upgrade_status = FW_UPG_STATUS_IDLE;
 static hap_char_t *fw_upgrade_status_char;
+static hap_type_id_t fw_upgrade_url_type_id;
 
 static void remove_escape_char(char *url)
 {
@@ -103,7 +104,7 @@ static int hap_fw_upgrade_write(hap_write_data_t write_data[], int count,
     hap_write_data_t *write;
     for (i = 0; i < count; i++) {
         write = &write_data[i];
-        if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_CUSTOM_UUID_FW_UPG_URL)) {
+        if (hap_char_is_type(write->hc, fw_upgrade_url_type_id)) {
             /* If the Upgrade Status is not idle, it means that a FW Upgrade attempt
              * is already in progress. Report appropriate status in such a case and do
              * not proceed
@@ -150,6 +151,7 @@ hap_serv_t * hap_serv_fw_upgrade_create(hap_fw_upgrade_config_t *ota_config)
         return NULL;
     }
     hap_char_add_description(hc, "FW Upgrade URL");
+    fw_upgrade_url_type_id = hap_char_get_type_id(hc);
     hap_char_add_description(fw_upgrade_status_char, "FW Upgrade Status");
     hap_serv_set_write_cb(hs, hap_fw_upgrade_write);
     esp_http_client_config_t *client_config = calloc(1, sizeof(esp_http_client_config_t));
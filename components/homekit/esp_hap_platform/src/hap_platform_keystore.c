@@ -24,10 +24,138 @@
 #include <esp_log.h>
 #include <nvs_flash.h>
 #include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 
 static const char *TAG = "hap_platform_keystore";
 
+#define HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE CONFIG_HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE
+
+#if HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE > 0
+/* NVS handles are kept open per (partition, namespace), since opening one
+ * means searching the namespace entries and HomeKit accesses the same few
+ * namespaces all the time. The least recently used handle is closed when
+ * the cache is full.
+ */
+typedef struct {
+    char part_name[17];
+    char name_space[16];
+    nvs_handle handle;
+    bool read_write;
+    uint32_t last_used;
+} hap_platform_keystore_handle_t;
+
+static hap_platform_keystore_handle_t handle_cache[HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE];
+static uint32_t handle_cache_use_cnt;
+static SemaphoreHandle_t handle_cache_lock;
+
+static void hap_platform_keystore_lock()
+{
+    if (handle_cache_lock) {
+        xSemaphoreTake(handle_cache_lock, portMAX_DELAY);
+    }
+}
+
+static void hap_platform_keystore_unlock()
+{
+    if (handle_cache_lock) {
+        xSemaphoreGive(handle_cache_lock);
+    }
+}
+
+/* Must be called with the lock held. The handle must not be closed by the caller
+ * and is valid only till the lock is released.
+ */
+static esp_err_t hap_platform_keystore_open(const char *part_name, const char *name_space,
+        bool read_write, nvs_handle *handle)
+{
+    hap_platform_keystore_handle_t *entry = NULL;
+    int i;
+    for (i = 0; i < HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE; i++) {
+        if (handle_cache[i].part_name[0] && !strcmp(handle_cache[i].part_name, part_name)
+                && !strcmp(handle_cache[i].name_space, name_space)) {
+            entry = &handle_cache[i];
+            break;
+        }
+    }
+    if (entry && (entry->read_write || !read_write)) {
+        entry->last_used = ++handle_cache_use_cnt;
+        *handle = entry->handle;
+        return ESP_OK;
+    }
+    if (!entry) {
+        /* Use a free slot, or the least recently used one */
+        entry = &handle_cache[0];
+        for (i = 0; i < HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE; i++) {
+            if (!handle_cache[i].part_name[0]) {
+                entry = &handle_cache[i];
+                break;
+            }
+            if (handle_cache[i].last_used < entry->last_used) {
+                entry = &handle_cache[i];
+            }
+        }
+    }
+    if (entry->part_name[0]) {
+        nvs_close(entry->handle);
+        memset(entry, 0, sizeof(hap_platform_keystore_handle_t));
+    }
+    esp_err_t err = nvs_open_from_partition(part_name, name_space,
+            read_write ? NVS_READWRITE : NVS_READONLY, handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (strlen(part_name) < sizeof(entry->part_name) && strlen(name_space) < sizeof(entry->name_space)) {
+        strcpy(entry->part_name, part_name);
+        strcpy(entry->name_space, name_space);
+        entry->handle = *handle;
+        entry->read_write = read_write;
+        entry->last_used = ++handle_cache_use_cnt;
+    }
+    return ESP_OK;
+}
+
+static void hap_platform_keystore_close(nvs_handle handle)
+{
+    int i;
+    for (i = 0; i < HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE; i++) {
+        if (handle_cache[i].part_name[0] && handle_cache[i].handle == handle) {
+            return;
+        }
+    }
+    nvs_close(handle);
+}
+
+static void hap_platform_keystore_close_partition(const char *part_name)
+{
+    int i;
+    for (i = 0; i < HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE; i++) {
+        if (handle_cache[i].part_name[0] && !strcmp(handle_cache[i].part_name, part_name)) {
+            nvs_close(handle_cache[i].handle);
+            memset(&handle_cache[i], 0, sizeof(hap_platform_keystore_handle_t));
+        }
+    }
+}
+#else
+static void hap_platform_keystore_lock() {}
+static void hap_platform_keystore_unlock() {}
+
+static esp_err_t hap_platform_keystore_open(const char *part_name, const char *name_space,
+        bool read_write, nvs_handle *handle)
+{
+    return nvs_open_from_partition(part_name, name_space,
+            read_write ? NVS_READWRITE : NVS_READONLY, handle);
+}
+
+static void hap_platform_keystore_close(nvs_handle handle)
+{
+    nvs_close(handle);
+}
+
+static void hap_platform_keystore_close_partition(const char *part_name) {}
+#endif /* HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE > 0 */
+
 char * hap_platform_keystore_get_nvs_partition_name()
 {
     return CONFIG_HAP_PLATFORM_DEF_NVS_RUNTIME_PARTITION;
@@ -42,6 +170,11 @@ char * hap_platform_keystore_get_factory_nvs_partition_name()
 int hap_platform_keystore_init_partition(const char *part_name, bool read_only)
 {
     esp_err_t err;
+#if HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE > 0
+    if (!handle_cache_lock) {
+        handle_cache_lock = xSemaphoreCreateMutex();
+    }
+#endif
     nvs_sec_cfg_t *cfg = NULL;
     nvs_sec_cfg_t sec_cfg;
     esp_partition_iterator_t iterator = esp_partition_find(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS_KEYS, NULL);
@@ -79,6 +212,11 @@ int hap_platform_keystore_init_partition(const char *part_name, bool read_only)
 int hap_platform_keystore_init_partition(const char *part_name, bool read_only)
 {
     esp_err_t err;
+#if HAP_PLATFORM_KEYSTORE_HANDLE_CACHE_SIZE > 0
+    if (!handle_cache_lock) {
+        handle_cache_lock = xSemaphoreCreateMutex();
+    }
+#endif
     if (read_only) {
         err = nvs_flash_init_partition(part_name);
     } else {
@@ -98,13 +236,13 @@ int hap_platform_keystore_init_partition(const char *part_name, bool read_only)
 int hap_platform_keystore_get(const char *part_name, const char *name_space, const char *key, uint8_t *val, size_t *val_size)
 {
     nvs_handle handle;
-    esp_err_t err = nvs_open_from_partition(part_name, name_space, NVS_READONLY, &handle);
-    if (err != ESP_OK) {
-        return -1;
-    } else {
+    hap_platform_keystore_lock();
+    esp_err_t err = hap_platform_keystore_open(part_name, name_space, false, &handle);
+    if (err == ESP_OK) {
         err = nvs_get_blob(handle, key, val, val_size);
-        nvs_close(handle);
+        hap_platform_keystore_close(handle);
     }
+    hap_platform_keystore_unlock();
     if (err == ESP_OK) {
         return 0;
     }
@@ -115,7 +253,8 @@ int hap_platform_keystore_set(const char *part_name, const char *name_space, con
 
 {
     nvs_handle handle;
-    esp_err_t err = nvs_open_from_partition(part_name, name_space, NVS_READWRITE, &handle);
+    hap_platform_keystore_lock();
+    esp_err_t err = hap_platform_keystore_open(part_name, name_space, true, &handle);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error (%d) opening NVS handle!", err);
     } else {
@@ -125,8 +264,9 @@ int hap_platform_keystore_set(const char *part_name, const char *name_space, con
         } else {
             nvs_commit(handle);
         }
-        nvs_close(handle);
+        hap_platform_keystore_close(handle);
     }
+    hap_platform_keystore_unlock();
     if (err == ESP_OK) {
         return 0;
     }
@@ -136,7 +276,8 @@ int hap_platform_keystore_set(const char *part_name, const char *name_space, con
 int hap_platform_keystore_delete(const char *part_name, const char *name_space, const char *key)
 {
     nvs_handle handle;
-    esp_err_t err = nvs_open_from_partition(part_name, name_space, NVS_READWRITE, &handle);
+    hap_platform_keystore_lock();
+    esp_err_t err = hap_platform_keystore_open(part_name, name_space, true, &handle);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error (%d) opening NVS handle!", err);
     } else {
@@ -146,8 +287,9 @@ int hap_platform_keystore_delete(const char *part_name, const char *name_space,
         } else {
             nvs_commit(handle);
         }
-        nvs_close(handle);
+        hap_platform_keystore_close(handle);
     }
+    hap_platform_keystore_unlock();
     if (err == ESP_OK) {
         return 0;
     }
@@ -157,7 +299,8 @@ int hap_platform_keystore_delete(const char *part_name, const char *name_space,
 int hap_platform_keystore_delete_namespace(const char *part_name, const char *name_space)
 {
     nvs_handle handle;
-    esp_err_t err = nvs_open_from_partition(part_name, name_space, NVS_READWRITE, &handle);
+    hap_platform_keystore_lock();
+    esp_err_t err = hap_platform_keystore_open(part_name, name_space, true, &handle);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error (%d) opening NVS handle!", err);
     } else {
@@ -167,8 +310,9 @@ int hap_platform_keystore_delete_namespace(const char *part_name, const char *na
         } else {
             nvs_commit(handle);
         }
-        nvs_close(handle);
+        hap_platform_keystore_close(handle);
     }
+    hap_platform_keystore_unlock();
     if (err == ESP_OK) {
         return 0;
     }
@@ -177,7 +321,10 @@ int hap_platform_keystore_delete_namespace(const char *part_name, const char *na
 
 int hap_platfrom_keystore_erase_partition(const char *part_name)
 {
+    hap_platform_keystore_lock();
+    hap_platform_keystore_close_partition(part_name);
     esp_err_t err = nvs_flash_erase_partition(part_name);
+    hap_platform_keystore_unlock();
     if (err == ESP_OK) {
         return 0;
     }
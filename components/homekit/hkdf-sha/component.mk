@@ -1,3 +1,3 @@
 # Empty
-COMPONENT_SRCDIRS := ./upstream
+COMPONENT_SRCDIRS := ./upstream ./port
 COMPONENT_ADD_INCLUDEDIRS := ./include
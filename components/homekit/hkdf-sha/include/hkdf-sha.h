@@ -71,6 +71,13 @@
  */
 
 #include <stdint.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+#ifdef CONFIG_HKDF_SHA512_USE_MBEDTLS
+#define SHA512_USE_MBEDTLS
+#include <mbedtls/sha512.h>
+#endif
 /*
  * If you do not have the ISO standard stdint.h header file, then you
  * must typedef the following:
@@ -163,6 +170,18 @@ typedef struct SHA256Context {
  *  This structure will hold context information for the SHA-512
  *  hashing operation.
  */
+#ifdef SHA512_USE_MBEDTLS
+/*
+ *  SHA-384/512 are provided by mbedtls (see port/sha384-512-mbedtls.c),
+ *  so that the hardware accelerator gets used where available.
+ */
+typedef struct SHA512Context {
+    mbedtls_sha512_context mbedtls_ctx;
+    uint8_t Message_Digest[SHA512HashSize]; /* Computed digest */
+    int Computed;                   /* Is the hash computed?*/
+    int Corrupted;                  /* Cumulative corruption code */
+} SHA512Context;
+#else /* !SHA512_USE_MBEDTLS */
 typedef struct SHA512Context {
 #ifdef USE_32BIT_ONLY
     uint32_t Intermediate_Hash[SHA512HashSize/4]; /* Message Digest  */
@@ -179,6 +198,7 @@ typedef struct SHA512Context {
     int Computed;                   /* Is the hash computed?*/
     int Corrupted;                  /* Cumulative corruption code */
 } SHA512Context;
+#endif /* !SHA512_USE_MBEDTLS */
 
 /*
  *  This structure will hold context information for the SHA-224
@@ -0,0 +1,125 @@
+/********************* sha384-512-mbedtls.c ********************/
+/* See hkdf-sha.h for terms of use and redistribution.         */
+
+/*
+ * Description:
+ *   SHA-384 and SHA-512 of the RFC 6234 API, implemented using
+ *   mbedtls, so that HKDF, HMAC and SRP use the same (possibly
+ *   hardware accelerated) SHA-512 as the rest of the system.
+ *
+ *   Only whole octets are supported. SHA384/512FinalBits() with
+ *   a non-zero bit count returns shaBadParam.
+ */
+
+#include "hkdf-sha.h"
+
+#ifdef SHA512_USE_MBEDTLS
+
+#ifdef CONFIG_IDF_TARGET_ESP8266
+#define mbedtls_sha512_starts mbedtls_sha512_starts_ret
+#define mbedtls_sha512_update mbedtls_sha512_update_ret
+#define mbedtls_sha512_finish mbedtls_sha512_finish_ret
+#endif
+
+static int SHA384_512Reset(SHA512Context *context, int is384)
+{
+  if (!context) return shaNull;
+
+  mbedtls_sha512_init(&context->mbedtls_ctx);
+  mbedtls_sha512_starts(&context->mbedtls_ctx, is384);
+  context->Computed = 0;
+  context->Corrupted = shaSuccess;
+  return shaSuccess;
+}
+
+static int SHA384_512Input(SHA512Context *context,
+    const uint8_t *message_array, unsigned int length)
+{
+  if (!context) return shaNull;
+  if (!length) return shaSuccess;
+  if (!message_array) return shaNull;
+  if (context->Computed) return context->Corrupted = shaStateError;
+  if (context->Corrupted) return context->Corrupted;
+
+  mbedtls_sha512_update(&context->mbedtls_ctx, message_array, length);
+  return shaSuccess;
+}
+
+static int SHA384_512FinalBits(SHA512Context *context,
+    uint8_t message_bits, unsigned int length)
+{
+  if (!context) return shaNull;
+  if (!length) return shaSuccess;
+  if (context->Corrupted) return context->Corrupted;
+  if (context->Computed) return context->Corrupted = shaStateError;
+  return context->Corrupted = shaBadParam;
+}
+
+static int SHA384_512Result(SHA512Context *context,
+    uint8_t *Message_Digest, int HashSize)
+{
+  int i;
+
+  if (!context) return shaNull;
+  if (!Message_Digest) return shaNull;
+  if (context->Corrupted) return context->Corrupted;
+
+  if (!context->Computed) {
+    mbedtls_sha512_finish(&context->mbedtls_ctx, context->Message_Digest);
+    /* Also releases the hardware, if it was used */
+    mbedtls_sha512_free(&context->mbedtls_ctx);
+    context->Computed = 1;
+  }
+
+  for (i = 0; i < HashSize; ++i)
+    Message_Digest[i] = context->Message_Digest[i];
+  return shaSuccess;
+}
+
+int SHA384Reset(SHA384Context *context)
+{
+  return SHA384_512Reset(context, 1);
+}
+
+int SHA384Input(SHA384Context *context,
+    const uint8_t *message_array, unsigned int length)
+{
+  return SHA384_512Input(context, message_array, length);
+}
+
+int SHA384FinalBits(SHA384Context *context,
+    uint8_t message_bits, unsigned int length)
+{
+  return SHA384_512FinalBits(context, message_bits, length);
+}
+
+int SHA384Result(SHA384Context *context,
+    uint8_t Message_Digest[SHA384HashSize])
+{
+  return SHA384_512Result(context, Message_Digest, SHA384HashSize);
+}
+
+int SHA512Reset(SHA512Context *context)
+{
+  return SHA384_512Reset(context, 0);
+}
+
+int SHA512Input(SHA512Context *context,
+    const uint8_t *message_array, unsigned int length)
+{
+  return SHA384_512Input(context, message_array, length);
+}
+
+int SHA512FinalBits(SHA512Context *context,
+    uint8_t message_bits, unsigned int length)
+{
+  return SHA384_512FinalBits(context, message_bits, length);
+}
+
+int SHA512Result(SHA512Context *context,
+    uint8_t Message_Digest[SHA512HashSize])
+{
+  return SHA384_512Result(context, Message_Digest, SHA512HashSize);
+}
+
+#endif /* SHA512_USE_MBEDTLS */
@@ -45,6 +45,9 @@
 
 #include "sha.h"
 
+/* Provided by port/sha384-512-mbedtls.c instead */
+#ifndef SHA512_USE_MBEDTLS
+
 #ifdef USE_32BIT_ONLY
 /*
  * Define 64-bit arithmetic in terms of 32-bit arithmetic.
@@ -1030,3 +1033,4 @@ static int SHA384_512ResultN(SHA512Context *context,
   return shaSuccess;
 }
 
+#endif /* !SHA512_USE_MBEDTLS */
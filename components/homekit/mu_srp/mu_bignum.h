@@ -49,6 +49,26 @@ static inline unsigned int mu_bn_sizeof(mu_bn_t *bn)
      return BN_num_bytes(bn);
 }
 
+static inline int mu_bn_set_from_bin(mu_bn_t *bn, const char *str, int str_len)
+{
+     return BN_bin2bn((unsigned char *)str, str_len, bn) ? 0 : -1;
+}
+
+static inline int mu_bn_copy(mu_bn_t *dst, mu_bn_t *src)
+{
+     return BN_copy(dst, src) ? 0 : -1;
+}
+
+static inline int mu_bn_num_bits(mu_bn_t *bn)
+{
+     return BN_num_bits(bn);
+}
+
+static inline int mu_bn_get_bit(mu_bn_t *bn, int pos)
+{
+     return BN_is_bit_set(bn, pos);
+}
+
 
 static inline char *mu_bn_to_bin(mu_bn_t *bn, int *len)
 {
@@ -151,6 +171,26 @@ static inline unsigned int mu_bn_sizeof(mu_bn_t *bn)
     return mbedtls_mpi_size(bn);
 }
 
+static inline int mu_bn_set_from_bin(mu_bn_t *bn, const char *str, int str_len)
+{
+    return mbedtls_mpi_read_binary(bn, (unsigned char *)str, str_len) == 0 ? 0 : -1;
+}
+
+static inline int mu_bn_copy(mu_bn_t *dst, mu_bn_t *src)
+{
+    return mbedtls_mpi_copy(dst, src) == 0 ? 0 : -1;
+}
+
+static inline int mu_bn_num_bits(mu_bn_t *bn)
+{
+    return mbedtls_mpi_bitlen(bn);
+}
+
+static inline int mu_bn_get_bit(mu_bn_t *bn, int pos)
+{
+    return mbedtls_mpi_get_bit(bn, pos);
+}
+
 
 static inline char *mu_bn_to_bin(mu_bn_t *bn, int *len)
 {
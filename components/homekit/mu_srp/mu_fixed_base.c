@@ -0,0 +1,587 @@
+#include <string.h>
+#include <stdlib.h>
+#include "mu_bignum.h"
+#include "mu_fixed_base.h"
+
+/* Lim-Lee comb with MU_FB_ROWS rows of MU_FB_COLS bits.
+ *
+ * T[k] is the product of g^(2^(j * MU_FB_COLS)) for every bit j set in k.
+ * Taking bit i of each row of the exponent as the index k_i,
+ * g^e = T[k_0] * (T[k_1] * (... * T[k_63]^2 ...)^2)^2
+ */
+#define MU_FB_ROWS      4
+#define MU_FB_COLS      64
+#define MU_FB_ENTRIES   (1 << MU_FB_ROWS)
+#define MU_FB_MAX_BITS  (MU_FB_ROWS * MU_FB_COLS)
+#define MU_FB_LEN       384
+
+#ifndef CONFIG_IDF_TARGET_ESP8266
+#define MU_FB_CONST_TABLE
+#endif
+
+#ifdef MU_FB_CONST_TABLE
+/* T[1] to T[15] for g = 5 and N_3072. T[0] is 1 */
+static const char mu_fb_table_3072[MU_FB_ENTRIES - 1][MU_FB_LEN] = {
+	/* T[1] */
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05
+	},
+	/* T[2] */
+	{
+		0xB4, 0x6E, 0xC0, 0x8B, 0x9B, 0xF1, 0xF3, 0x7E, 0xA4, 0xD0, 0xF9, 0xC3, 0x89, 0xF1, 0x75,
+		0xFF, 0xA8, 0x37, 0x7E, 0x5C, 0x60, 0x05, 0xFA, 0x22, 0xB2, 0xFF, 0xAC, 0xC7, 0xC6, 0xC0,
+		0x41, 0xAE, 0x5F, 0x7D, 0xC7, 0x59, 0xC4, 0x50, 0xC7, 0x37, 0x5E, 0x28, 0xF8, 0x11, 0xFE,
+		0x5C, 0x3A, 0x7D, 0x04, 0x09, 0x2F, 0x62, 0x1F, 0xEB, 0x8A, 0x2A, 0xA6, 0x67, 0x96, 0x2F,
+		0x27, 0x8A, 0x7E, 0xF2, 0xD1, 0xA7, 0xD7, 0x1A, 0x85, 0x26, 0xD0, 0x16, 0xCB, 0x5B, 0xC0,
+		0xBD, 0x42, 0x31, 0x54, 0x86, 0xE2, 0xBF, 0x79, 0x1B, 0xDD, 0x3E, 0x9E, 0x5E, 0x34, 0x15,
+		0x33, 0xCD, 0x9E, 0xC7, 0xC9, 0x02, 0x02, 0xE0, 0xEE, 0x92, 0xF8, 0x6A, 0x74, 0x29, 0x22,
+		0x7E, 0xED, 0xB4, 0x3F, 0xDC, 0xAD, 0xA0, 0x91, 0xA7, 0xD7, 0x63, 0xC9, 0xA9, 0xC3, 0x9F,
+		0x7E, 0x82, 0x1B, 0x2A, 0xFB, 0xF7, 0x3E, 0x9C, 0xDA, 0x2D, 0x97, 0x85, 0xEF, 0x9E, 0x3F,
+		0x18, 0xA1, 0x35, 0xD0, 0xE7, 0x81, 0x86, 0x50, 0xCA, 0xD5, 0x58, 0xE2, 0x39, 0x37, 0x94,
+		0x74, 0x62, 0xCD, 0x90, 0x18, 0x20, 0x6B, 0xC9, 0x1A, 0x3B, 0xCF, 0x95, 0x55, 0xBA, 0xF2,
+		0xE7, 0x8C, 0x09, 0x70, 0xFF, 0x40, 0xF0, 0x47, 0x1B, 0x30, 0x1F, 0xE2, 0x9B, 0x2D, 0xC7,
+		0x3D, 0xD6, 0xC9, 0xCF, 0x55, 0x39, 0x94, 0xE1, 0xFE, 0x8D, 0x5C, 0xCE, 0xAC, 0xB8, 0x54,
+		0xCF, 0x1F, 0x71, 0xA0, 0x8B, 0xD0, 0xB8, 0x32, 0x5B, 0xFF, 0x5A, 0x4A, 0xD7, 0xCA, 0x50,
+		0x36, 0xA5, 0x92, 0xDB, 0x68, 0x65, 0xE4, 0xE6, 0x41, 0xEE, 0x2E, 0xC8, 0x26, 0xF4, 0x99,
+		0x00, 0x12, 0x9F, 0x83, 0x71, 0x7C, 0xBF, 0x9A, 0x49, 0x09, 0x82, 0x1D, 0x85, 0x26, 0xFD,
+		0x4C, 0x50, 0xDF, 0xFD, 0x5E, 0xA6, 0x80, 0xBE, 0x54, 0x5A, 0x3E, 0x18, 0xA9, 0x4A, 0x5A,
+		0x1B, 0x9C, 0xBE, 0x67, 0x17, 0x4B, 0xC6, 0x25, 0x8A, 0x8A, 0xA2, 0x8B, 0x43, 0x2D, 0x93,
+		0x47, 0x58, 0x7E, 0xF5, 0x67, 0xBF, 0x13, 0xD2, 0x04, 0x9E, 0x89, 0xE5, 0x5E, 0x2B, 0x7C,
+		0x58, 0x50, 0x2D, 0x93, 0x7A, 0x8F, 0x82, 0xDE, 0x66, 0xDB, 0xB3, 0x2A, 0xF9, 0xFF, 0xC4,
+		0x50, 0x81, 0xC0, 0x2B, 0x2A, 0x41, 0x44, 0x33, 0x2D, 0x10, 0x3F, 0x44, 0x2C, 0x43, 0x82,
+		0xD5, 0x44, 0xD2, 0xB7, 0xE1, 0x7B, 0x21, 0x33, 0x22, 0x6F, 0x2F, 0x86, 0x18, 0xE5, 0x43,
+		0xE6, 0x6B, 0xD9, 0xE6, 0xE9, 0x18, 0x7B, 0xAC, 0x7C, 0x8E, 0x92, 0x4E, 0xB1, 0x3B, 0xAC,
+		0x88, 0x29, 0xA1, 0xD3, 0x02, 0x20, 0x60, 0xAB, 0xF1, 0x11, 0xDB, 0x0C, 0x65, 0xDD, 0x53,
+		0xCC, 0xA8, 0xD8, 0x54, 0x22, 0xE4, 0x86, 0x56, 0x20, 0x76, 0xD0, 0x98, 0x78, 0xB5, 0x92,
+		0xFB, 0x74, 0x83, 0x70, 0x49, 0x03, 0x42, 0x37, 0x2F
+	},
+	/* T[3] */
+	{
+		0x86, 0x29, 0xC2, 0xBA, 0x0B, 0xB9, 0xC1, 0x79, 0xDC, 0xE5, 0x50, 0xEB, 0x4D, 0x7D, 0x07,
+		0x5F, 0xFA, 0xC2, 0x50, 0x2B, 0x5D, 0x89, 0x8C, 0x3A, 0x03, 0xF7, 0x75, 0xCD, 0x42, 0x89,
+		0xE3, 0x0B, 0xD7, 0x51, 0xA8, 0xCE, 0x24, 0x59, 0x12, 0xAD, 0xE2, 0xEE, 0xBE, 0xED, 0x4D,
+		0x31, 0x15, 0xD7, 0x45, 0x6E, 0x9F, 0xCF, 0x37, 0xEA, 0xE9, 0x83, 0xAF, 0x84, 0xCF, 0xA1,
+		0xEE, 0x97, 0x3E, 0x18, 0x28, 0xA3, 0x93, 0x3C, 0x51, 0xCC, 0xC9, 0xA0, 0x4B, 0x39, 0xA3,
+		0x4F, 0x23, 0xDB, 0x2A, 0x4D, 0x90, 0xD8, 0x94, 0xCE, 0x5F, 0x91, 0x4F, 0x95, 0xE0, 0x6B,
+		0xEC, 0xDF, 0x3D, 0xD2, 0xC5, 0x40, 0x43, 0xBB, 0x64, 0xEC, 0xCA, 0x77, 0x65, 0xDC, 0xA0,
+		0x9D, 0x38, 0x50, 0xCA, 0x6E, 0x04, 0x6F, 0xFC, 0xCE, 0x01, 0xFD, 0x29, 0xA3, 0xC0, 0x64,
+		0x32, 0x89, 0x11, 0xAD, 0x07, 0xA8, 0xFB, 0xFF, 0x78, 0x55, 0x1C, 0xFB, 0x59, 0x15, 0xC0,
+		0xAB, 0xEA, 0xCA, 0x55, 0x8A, 0x90, 0x31, 0x25, 0xD7, 0xA0, 0x8C, 0x53, 0xB2, 0x7F, 0xFB,
+		0x3D, 0x2B, 0xAE, 0xA7, 0x9E, 0x9F, 0xB9, 0x5D, 0x8A, 0xF8, 0x31, 0x6B, 0x31, 0x90, 0x6C,
+		0xC1, 0xF8, 0xE6, 0xFF, 0xD7, 0xA4, 0xC6, 0x83, 0x52, 0x28, 0x90, 0x98, 0xAA, 0xA0, 0xC9,
+		0xD6, 0xE9, 0x8C, 0x98, 0x12, 0x6E, 0xCD, 0x97, 0x6E, 0x1E, 0x65, 0x55, 0xB4, 0xBE, 0x42,
+		0x87, 0x55, 0x0C, 0x90, 0xB0, 0x42, 0x22, 0x70, 0xE3, 0x38, 0xAC, 0x8E, 0x87, 0xD2, 0x40,
+		0xF7, 0x6A, 0x90, 0x64, 0x11, 0x9F, 0xDD, 0xFB, 0xE5, 0xC3, 0x29, 0xE0, 0x7D, 0x7E, 0x50,
+		0x40, 0x80, 0xA6, 0xD1, 0x77, 0x2F, 0x0E, 0xC1, 0xF6, 0xBD, 0x40, 0xC8, 0xAB, 0xB3, 0xC2,
+		0x3D, 0x3C, 0xB4, 0xE3, 0x39, 0x40, 0x37, 0x2E, 0x9E, 0x29, 0xF1, 0x54, 0x41, 0x82, 0x53,
+		0xEF, 0x16, 0xB8, 0x9E, 0x70, 0xDD, 0x88, 0x8C, 0x85, 0xEE, 0x3A, 0x29, 0x42, 0xD9, 0x4C,
+		0x97, 0x9A, 0xDA, 0x0B, 0xB2, 0xB5, 0x4C, 0x07, 0xF1, 0x9F, 0x96, 0xB5, 0xA8, 0x48, 0x79,
+		0x13, 0xE2, 0x8C, 0xDD, 0x83, 0xC1, 0xE7, 0xC6, 0xE6, 0xAE, 0xFA, 0x7B, 0x3C, 0x40, 0x34,
+		0xB4, 0x18, 0x9B, 0xFE, 0x66, 0x9A, 0xDE, 0x8D, 0x90, 0xD8, 0x71, 0x11, 0x09, 0xC1, 0xA0,
+		0x15, 0xCB, 0x7F, 0x7E, 0x38, 0xDE, 0x43, 0xF8, 0x52, 0x6F, 0x94, 0x5F, 0x4F, 0x83, 0xF5,
+		0xFE, 0xD2, 0xFB, 0x11, 0x2D, 0x54, 0x36, 0xBB, 0x28, 0xC2, 0x6C, 0x65, 0x5D, 0xE4, 0xF9,
+		0x8C, 0x35, 0xE6, 0xEE, 0x7E, 0xCD, 0x3D, 0x41, 0x0E, 0x6A, 0x65, 0xDF, 0x4C, 0x51, 0x0F,
+		0x33, 0xBA, 0x25, 0xAE, 0x0B, 0x7F, 0x6E, 0x03, 0xBF, 0xC9, 0x9F, 0x98, 0x5F, 0xDB, 0x66,
+		0x88, 0x46, 0x91, 0x31, 0x6D, 0x10, 0x4B, 0x13, 0xEE
+	},
+	/* T[4] */
+	{
+		0x09, 0x00, 0xE4, 0xFE, 0xBF, 0x9F, 0xDC, 0xB2, 0x64, 0xD4, 0xD1, 0x28, 0xEE, 0xE2, 0xF7,
+		0xB6, 0xA9, 0x9E, 0x3F, 0xF2, 0x28, 0x79, 0xC7, 0x1E, 0xB4, 0x9A, 0xF8, 0x75, 0x82, 0x8B,
+		0xE9, 0xB2, 0x0A, 0x19, 0x42, 0x1F, 0x41, 0xBA, 0x10, 0x07, 0x6E, 0x86, 0x7E, 0xF3, 0x24,
+		0xCA, 0x75, 0x74, 0x46, 0xC6, 0x41, 0x43, 0xAA, 0x12, 0x40, 0xC4, 0x7E, 0xD8, 0x7D, 0xC5,
+		0x08, 0x5C, 0x2A, 0xD7, 0x6F, 0x4A, 0xC8, 0x4E, 0x66, 0x11, 0x01, 0x26, 0x11, 0xC1, 0x49,
+		0xBC, 0x2B, 0xD4, 0x0E, 0x1E, 0x2F, 0x16, 0xC8, 0x1A, 0x62, 0x6A, 0x93, 0xE2, 0x68, 0x9E,
+		0xDB, 0x72, 0x14, 0xB7, 0xAA, 0xB7, 0x79, 0x0E, 0x6C, 0xC3, 0x74, 0xCE, 0xED, 0x4A, 0xC7,
+		0xB0, 0x65, 0x83, 0x62, 0x57, 0x5C, 0x25, 0xB0, 0x69, 0x8D, 0xA8, 0xB5, 0x8D, 0x05, 0x14,
+		0xD8, 0x4C, 0x61, 0x33, 0x85, 0x49, 0xFB, 0xDD, 0x3A, 0xB4, 0xBC, 0x39, 0xDE, 0xBA, 0xE3,
+		0x73, 0xD8, 0xA9, 0xCD, 0xC5, 0x70, 0xB3, 0xA8, 0xCD, 0x47, 0x27, 0xD5, 0xDE, 0x4C, 0xED,
+		0x64, 0xF5, 0xE9, 0xD4, 0x1B, 0x8B, 0xAE, 0x8E, 0x51, 0xBA, 0x57, 0xFB, 0x6F, 0xAB, 0x67,
+		0xDD, 0x9A, 0x68, 0x95, 0x1C, 0xB1, 0x8D, 0x22, 0xB0, 0xBE, 0x7D, 0x71, 0x97, 0x56, 0xE4,
+		0x83, 0xC2, 0xD0, 0xF1, 0xBE, 0x74, 0x80, 0x90, 0xC6, 0x2F, 0x7D, 0xA5, 0xB4, 0xEC, 0x66,
+		0x21, 0x1C, 0x21, 0x8F, 0x43, 0xDA, 0xD4, 0x0C, 0xD9, 0x8F, 0x7D, 0x99, 0x9F, 0x16, 0xAB,
+		0xCC, 0x0C, 0x14, 0x78, 0xA1, 0x58, 0xBE, 0xF3, 0xFE, 0x21, 0xF7, 0x28, 0x3D, 0xE2, 0x84,
+		0x19, 0x20, 0xF8, 0x1F, 0xC8, 0x92, 0x1D, 0x1F, 0x1A, 0x9D, 0xBF, 0xCD, 0xAB, 0x6F, 0x00,
+		0xCF, 0xA7, 0x69, 0x85, 0xEE, 0x6D, 0xE2, 0x6B, 0x63, 0x1F, 0xBA, 0x7D, 0x96, 0x36, 0xE7,
+		0xF5, 0x7D, 0x4F, 0xAB, 0x72, 0xAE, 0x5C, 0x9A, 0xB3, 0x8F, 0x14, 0x7A, 0x22, 0x98, 0xEC,
+		0xD3, 0x03, 0x30, 0x87, 0x31, 0x1F, 0x8E, 0xCA, 0x42, 0x1C, 0x13, 0xEA, 0xAB, 0x79, 0x07,
+		0xB2, 0x17, 0xE1, 0xC2, 0xE2, 0x84, 0xBC, 0xA9, 0x5E, 0xB0, 0xB2, 0xF5, 0x3A, 0xA6, 0x88,
+		0xC3, 0xD3, 0xAD, 0x39, 0xDE, 0x5D, 0x7E, 0xCF, 0x5A, 0x71, 0xE4, 0xE3, 0xAE, 0x4B, 0xBE,
+		0xBA, 0x97, 0xE1, 0xB9, 0xE0, 0x4D, 0xEF, 0xA5, 0x2E, 0x62, 0xA7, 0x9D, 0x41, 0xE5, 0xFB,
+		0xC5, 0xF8, 0xB2, 0x18, 0xA6, 0x12, 0x42, 0xEB, 0xD5, 0xCC, 0x7F, 0xA2, 0x48, 0x29, 0x52,
+		0x06, 0x41, 0x0F, 0x2B, 0x90, 0xCB, 0x7F, 0x78, 0xC6, 0x2D, 0x11, 0x1B, 0x0D, 0x70, 0x10,
+		0x28, 0xDB, 0x44, 0x8E, 0xDC, 0xCF, 0x83, 0xC5, 0x11, 0x3A, 0xDF, 0x43, 0x93, 0x57, 0xE3,
+		0x52, 0xF3, 0xBC, 0x81, 0xBC, 0x4F, 0xD5, 0x6E, 0x01
+	},
+	/* T[5] */
+	{
+		0x2D, 0x04, 0x78, 0xF9, 0xBE, 0x1F, 0x4F, 0x7B, 0xF8, 0x28, 0x15, 0xCC, 0xAA, 0x6E, 0xD6,
+		0x91, 0x50, 0x17, 0x3F, 0xBA, 0xCA, 0x60, 0xE3, 0x99, 0x87, 0x06, 0xDA, 0x4B, 0x8C, 0xBB,
+		0x90, 0x7A, 0x32, 0x7E, 0x4A, 0x9C, 0x48, 0xA2, 0x50, 0x25, 0x28, 0xA0, 0x7A, 0xBF, 0xB7,
+		0xF4, 0x4B, 0x45, 0x61, 0xDF, 0x46, 0x52, 0x52, 0x5B, 0x43, 0xD6, 0x7A, 0x3A, 0x74, 0xD9,
+		0x29, 0xCC, 0xD6, 0x35, 0x2C, 0x75, 0xE9, 0x87, 0xFE, 0x55, 0x05, 0xBE, 0x58, 0xC6, 0x70,
+		0xAC, 0xDB, 0x24, 0x46, 0x96, 0xEB, 0x71, 0xE8, 0x83, 0xEC, 0x14, 0xE3, 0x6C, 0x0B, 0x1A,
+		0x49, 0x3A, 0x67, 0x96, 0x55, 0x95, 0x5D, 0x48, 0x1F, 0xD1, 0x48, 0x0A, 0xA2, 0x75, 0xE6,
+		0x71, 0xFB, 0x90, 0xEB, 0xB4, 0xCC, 0xBC, 0x72, 0x0F, 0xC4, 0x4B, 0x8B, 0xC1, 0x19, 0x68,
+		0x39, 0x7D, 0xE6, 0x01, 0x9A, 0x71, 0xEB, 0x52, 0x25, 0x87, 0xAD, 0x21, 0x59, 0xA6, 0x71,
+		0x43, 0x3B, 0x51, 0x04, 0xDB, 0x33, 0x82, 0x4C, 0x02, 0x63, 0xC7, 0x2D, 0x57, 0x80, 0xA2,
+		0xF8, 0xCD, 0x91, 0x24, 0x89, 0xBA, 0x68, 0xC7, 0x98, 0xA3, 0xB7, 0xE9, 0x2E, 0x59, 0x07,
+		0x54, 0x04, 0x0A, 0xE9, 0x8F, 0x77, 0xC1, 0xAD, 0x73, 0xB8, 0x73, 0x37, 0xF4, 0xB2, 0x76,
+		0x92, 0xCE, 0x14, 0xB8, 0xB8, 0x46, 0x82, 0xD3, 0xDE, 0xED, 0x74, 0x3C, 0x88, 0x9D, 0xFE,
+		0xA5, 0x8C, 0xA7, 0xCC, 0x53, 0x46, 0x24, 0x40, 0x3F, 0xCD, 0x74, 0x00, 0x1B, 0x71, 0x5A,
+		0xFC, 0x3C, 0x66, 0x5B, 0x26, 0xBB, 0xBA, 0xC3, 0xF6, 0xA9, 0xD3, 0xC9, 0x35, 0x6C, 0x94,
+		0x7D, 0xA4, 0xD8, 0x9E, 0xEA, 0xDA, 0x91, 0x9B, 0x85, 0x14, 0xBF, 0x04, 0x59, 0x2B, 0x04,
+		0x0E, 0x45, 0x0F, 0x9D, 0xA8, 0x25, 0x6C, 0x18, 0xEF, 0x9E, 0xA4, 0x73, 0xEF, 0x12, 0x87,
+		0xCB, 0x72, 0x8E, 0x59, 0x3D, 0x67, 0xCF, 0x05, 0x81, 0xCB, 0x66, 0x62, 0xAC, 0xFC, 0xA0,
+		0x1F, 0x0F, 0xF2, 0xA3, 0xF5, 0x9D, 0xC9, 0xF3, 0x4A, 0x8C, 0x63, 0x95, 0x59, 0x5D, 0x26,
+		0x7A, 0x77, 0x68, 0xCE, 0x6C, 0x97, 0xAF, 0x4E, 0xD9, 0x73, 0x7E, 0xCA, 0x25, 0x40, 0xAB,
+		0xD3, 0x22, 0x62, 0x21, 0x57, 0xD3, 0x7A, 0x0C, 0xC4, 0x39, 0x78, 0x72, 0x67, 0x7A, 0xB9,
+		0xA4, 0xF7, 0x68, 0xA1, 0x61, 0x85, 0xAE, 0x39, 0xE7, 0xED, 0x46, 0x12, 0x49, 0x7D, 0xEA,
+		0xDD, 0xDB, 0x7A, 0x7B, 0x3E, 0x5B, 0x4E, 0x9B, 0x2C, 0xFE, 0x7E, 0x2B, 0x68, 0xCE, 0x9A,
+		0x1F, 0x45, 0x4B, 0xD9, 0xD3, 0xF9, 0x7D, 0x5B, 0xDE, 0xE1, 0x55, 0x87, 0x43, 0x30, 0x50,
+		0xCC, 0x48, 0x56, 0xCA, 0x50, 0x0D, 0x92, 0xD9, 0x56, 0x26, 0x5C, 0x51, 0xE0, 0xB7, 0x70,
+		0x9E, 0xC2, 0xAE, 0x88, 0xAD, 0x8F, 0x2B, 0x26, 0x05
+	},
+	/* T[6] */
+	{
+		0x0C, 0x3A, 0x6B, 0x56, 0x9F, 0xE0, 0x21, 0xAE, 0x09, 0x27, 0x1E, 0x2B, 0x4F, 0xB1, 0xF9,
+		0xFE, 0xB2, 0x7B, 0xB1, 0x76, 0x16, 0xF8, 0x4B, 0xEF, 0x0E, 0x15, 0x74, 0xA1, 0xF4, 0xF9,
+		0xAE, 0xBA, 0xE9, 0x0F, 0x50, 0x15, 0x41, 0xB5, 0x21, 0xFE, 0x9F, 0x75, 0xD2, 0xF6, 0x87,
+		0xF7, 0x74, 0x29, 0x2C, 0x78, 0xCC, 0x5B, 0x9A, 0x68, 0xCF, 0xFD, 0xA4, 0x8E, 0x7C, 0x0A,
+		0x4D, 0xD4, 0xDE, 0x87, 0x7C, 0xB5, 0x62, 0x2D, 0x18, 0x76, 0xAC, 0x47, 0x0A, 0x2D, 0x38,
+		0x9F, 0xA0, 0x03, 0xF2, 0x91, 0xB7, 0x8C, 0x7E, 0xB2, 0x66, 0x1F, 0x3E, 0xA2, 0x38, 0xE4,
+		0x64, 0x24, 0x99, 0x9F, 0x6C, 0x77, 0xDC, 0x9D, 0x21, 0xE3, 0x6B, 0xAC, 0x11, 0xD8, 0xC1,
+		0x06, 0xDA, 0x5D, 0x57, 0xC8, 0x2E, 0x40, 0x44, 0xEC, 0x60, 0xEB, 0x12, 0x0D, 0xF3, 0x94,
+		0x4B, 0x1A, 0xB4, 0x52, 0x3A, 0x69, 0xEA, 0x44, 0xB6, 0x13, 0xB6, 0xDE, 0x51, 0x01, 0x2D,
+		0x5F, 0x05, 0xB8, 0x86, 0xC1, 0x28, 0x11, 0xF6, 0x23, 0x08, 0x0E, 0xF2, 0x95, 0x55, 0xC6,
+		0x6D, 0x27, 0xC1, 0x62, 0xFF, 0x7C, 0xCA, 0x8B, 0x49, 0x3F, 0xA0, 0xBD, 0x6C, 0x32, 0x51,
+		0xBC, 0xE9, 0xA5, 0xB4, 0xAB, 0xA6, 0x43, 0x77, 0xC5, 0x2A, 0x1D, 0x7D, 0x80, 0xD7, 0xB8,
+		0x4E, 0x5C, 0x63, 0x12, 0x94, 0x4B, 0x60, 0x04, 0x80, 0x07, 0x16, 0xC8, 0x1C, 0x4C, 0xF4,
+		0xA3, 0x31, 0x72, 0xBE, 0x42, 0xB1, 0x4A, 0x26, 0xC6, 0x31, 0xFE, 0x90, 0x10, 0x0F, 0x1E,
+		0xB3, 0xC2, 0x2F, 0xA7, 0x42, 0x06, 0x14, 0x96, 0xAF, 0x35, 0x4D, 0x2E, 0x1B, 0x9E, 0x17,
+		0x8C, 0xAB, 0xC3, 0xDC, 0xA5, 0x41, 0xF2, 0x45, 0x5F, 0x44, 0x38, 0x29, 0xC7, 0x02, 0xCF,
+		0x65, 0x3F, 0xB5, 0x55, 0x84, 0xEC, 0x92, 0xF6, 0x83, 0xD1, 0xFB, 0x8A, 0x26, 0xB7, 0x90,
+		0xB9, 0xE2, 0xC2, 0x32, 0x20, 0x2C, 0x58, 0xFE, 0xEC, 0x12, 0x77, 0xA3, 0x07, 0x08, 0xB6,
+		0x41, 0x67, 0x50, 0x88, 0x5D, 0x94, 0x30, 0x06, 0x98, 0x57, 0x2F, 0xAC, 0xD5, 0x85, 0x2F,
+		0xFF, 0x85, 0xED, 0xA9, 0x42, 0xEA, 0x65, 0x5D, 0xF8, 0x71, 0x21, 0x01, 0x15, 0xDB, 0xFE,
+		0xDF, 0x8B, 0x1C, 0x84, 0x67, 0x16, 0xAF, 0x2B, 0xA2, 0x4A, 0xFC, 0x44, 0x87, 0xDC, 0x56,
+		0x00, 0x47, 0x88, 0x63, 0xFC, 0x0C, 0x6A, 0xFE, 0x04, 0x9A, 0x13, 0x86, 0x15, 0x0C, 0x66,
+		0xFB, 0xA8, 0x8B, 0x54, 0x14, 0x5A, 0x4B, 0xCA, 0x98, 0x50, 0xCE, 0x1A, 0x35, 0x2A, 0x53,
+		0x7D, 0xD4, 0x6F, 0x26, 0x93, 0x95, 0x5D, 0x2A, 0x91, 0x3D, 0xC9, 0xD7, 0xFA, 0x5F, 0x41,
+		0x46, 0x65, 0xC0, 0xC8, 0xAF, 0xD5, 0x80, 0xA6, 0x2F, 0x23, 0x43, 0x84, 0x21, 0x1F, 0xB6,
+		0x68, 0x8F, 0x84, 0x94, 0x4D, 0x7A, 0x64, 0x99, 0xB5
+	},
+	/* T[7] */
+	{
+		0x3D, 0x24, 0x18, 0xB1, 0x1F, 0x60, 0xA8, 0x66, 0x2D, 0xC3, 0x96, 0xD8, 0x8E, 0x79, 0xE1,
+		0xF9, 0x7C, 0x6A, 0x77, 0x4E, 0x72, 0xD9, 0x7B, 0xAB, 0x46, 0x6B, 0x47, 0x29, 0xC8, 0xE0,
+		0x69, 0xA6, 0x8D, 0x4C, 0x90, 0x6A, 0x48, 0x89, 0xA9, 0xF9, 0x1D, 0x4D, 0x1E, 0xD0, 0xA7,
+		0xD5, 0x44, 0xCD, 0xDE, 0x5B, 0xFD, 0xCA, 0x04, 0x0C, 0x0F, 0xF4, 0x36, 0xC8, 0x6C, 0x33,
+		0x85, 0x28, 0x58, 0xA5, 0x6F, 0x8A, 0xEA, 0xE1, 0x7A, 0x51, 0x5D, 0x63, 0x32, 0xE2, 0x1B,
+		0x1E, 0x20, 0x13, 0xBC, 0xD8, 0x95, 0xBE, 0x79, 0x7B, 0xFE, 0x9C, 0x39, 0x2B, 0x1C, 0x75,
+		0xF4, 0xB7, 0x00, 0x1D, 0x1E, 0x57, 0x4F, 0x11, 0xA9, 0x71, 0x1A, 0x5C, 0x59, 0x3B, 0xC5,
+		0x22, 0x43, 0xD2, 0xB6, 0xE8, 0xE7, 0x41, 0x58, 0x9D, 0xE4, 0x97, 0x5A, 0x45, 0xC1, 0xE5,
+		0x77, 0x85, 0x85, 0x9B, 0x24, 0x11, 0x93, 0x57, 0x8E, 0x62, 0x92, 0x57, 0x95, 0x05, 0xE2,
+		0xDB, 0x1C, 0x9A, 0xA1, 0xC5, 0xC8, 0x59, 0xCE, 0xAF, 0x28, 0x4A, 0xBC, 0xEA, 0xAC, 0xE0,
+		0x21, 0xC6, 0xC6, 0xEE, 0xFD, 0x6F, 0xF4, 0xB8, 0x6E, 0x3E, 0x23, 0xB3, 0x1C, 0xFB, 0x98,
+		0xB0, 0x90, 0x3C, 0x87, 0x5A, 0x3F, 0x51, 0x56, 0xD9, 0xD2, 0x93, 0x73, 0x84, 0x36, 0x99,
+		0x87, 0xCD, 0xEF, 0x5C, 0xE5, 0x78, 0xE0, 0x16, 0x80, 0x23, 0x71, 0xE8, 0x8D, 0x80, 0xC7,
+		0x2F, 0xF7, 0x3D, 0xB7, 0x4D, 0x76, 0x72, 0xC1, 0xDE, 0xF9, 0xF8, 0xD0, 0x50, 0x4B, 0x99,
+		0x82, 0xCA, 0xEE, 0x44, 0x4A, 0x1E, 0x66, 0xF1, 0x6C, 0x0A, 0x81, 0xE6, 0x8A, 0x16, 0x75,
+		0xBF, 0x5A, 0xD3, 0x4F, 0x3A, 0x49, 0xBB, 0x5A, 0xDC, 0x55, 0x18, 0xD0, 0xE3, 0x0E, 0x0C,
+		0xFA, 0x3E, 0x8A, 0xAB, 0x98, 0x9E, 0xDE, 0xD0, 0x93, 0x19, 0xE9, 0xB2, 0xC1, 0x95, 0xD3,
+		0xA1, 0x6D, 0xCA, 0xFA, 0xA0, 0xDD, 0xBC, 0xFA, 0x9C, 0x5C, 0x56, 0x2F, 0x23, 0x2B, 0x8F,
+		0x47, 0x04, 0x92, 0xA9, 0xD3, 0xE4, 0xF0, 0x20, 0xF9, 0xB3, 0xEE, 0x60, 0x2B, 0x99, 0xEF,
+		0xFD, 0x9D, 0xA4, 0x4E, 0x4E, 0x93, 0xFA, 0xD5, 0xDA, 0x35, 0xA5, 0x05, 0x6D, 0x4B, 0xFA,
+		0x5D, 0xB7, 0x8E, 0x96, 0x03, 0x71, 0x6B, 0xDA, 0x2B, 0x76, 0xED, 0x56, 0xA7, 0x4D, 0xAE,
+		0x01, 0x65, 0xA9, 0xF3, 0xEC, 0x3E, 0x16, 0xF6, 0x17, 0x02, 0x61, 0x9E, 0x69, 0x3E, 0x02,
+		0xEA, 0x4A, 0xB8, 0xA4, 0x65, 0xC3, 0x7A, 0xF4, 0xF9, 0x94, 0x06, 0x83, 0x09, 0xD3, 0xA1,
+		0x75, 0x26, 0x2B, 0xC0, 0xE1, 0xEA, 0xD1, 0xD4, 0xD6, 0x34, 0xF1, 0x37, 0xE3, 0xDC, 0x46,
+		0x5F, 0xFC, 0xC3, 0xEB, 0x6F, 0x2B, 0x83, 0x3E, 0xEB, 0xB0, 0x51, 0x94, 0xA5, 0x9E, 0x90,
+		0x0A, 0xCD, 0x96, 0xE5, 0x83, 0x63, 0xF7, 0x00, 0x89
+	},
+	/* T[8] */
+	{
+		0x94, 0xAB, 0xDB, 0x8E, 0xF5, 0xAD, 0x56, 0x3C, 0x32, 0xAD, 0x7E, 0x7E, 0x44, 0x06, 0xBA,
+		0x75, 0x8B, 0xB3, 0xE3, 0x5B, 0x34, 0x62, 0x39, 0x0F, 0xDF, 0x67, 0xF1, 0x16, 0x7A, 0xB1,
+		0x87, 0x06, 0xF1, 0x0C, 0xE4, 0xA6, 0xE7, 0x30, 0x39, 0xA3, 0xD0, 0xEC, 0xA0, 0x3D, 0xED,
+		0x04, 0x2B, 0xF3, 0xD2, 0x09, 0xB0, 0xBC, 0x66, 0x41, 0x37, 0xDE, 0x5B, 0x4C, 0x7B, 0x3F,
+		0xAE, 0xE6, 0x0C, 0xE9, 0xC9, 0x95, 0xE2, 0xAD, 0x76, 0x18, 0x65, 0x5F, 0x99, 0x42, 0xD3,
+		0xA1, 0xD0, 0xAA, 0x7C, 0x81, 0xBA, 0xBD, 0x4D, 0x03, 0xFF, 0x99, 0x37, 0x1E, 0xF0, 0x03,
+		0x68, 0xDC, 0xF6, 0xB2, 0xE3, 0x76, 0xA6, 0xA6, 0x7D, 0x4A, 0x38, 0x87, 0x8B, 0xAA, 0x42,
+		0x42, 0xD3, 0x36, 0x2D, 0xBA, 0x8A, 0x20, 0xA9, 0x1C, 0xB8, 0xA2, 0x33, 0xA1, 0x04, 0x98,
+		0x33, 0x07, 0x47, 0xD4, 0xB2, 0x2D, 0xEA, 0xDE, 0x02, 0xAD, 0x79, 0x46, 0x4A, 0x94, 0x0E,
+		0x83, 0xD6, 0x90, 0xA5, 0x62, 0x70, 0x49, 0x7A, 0xE7, 0x5A, 0x72, 0x50, 0x0C, 0xD1, 0x6A,
+		0xAA, 0xF3, 0xBF, 0x35, 0xC7, 0x99, 0x35, 0xE6, 0xC5, 0xB6, 0xE7, 0x90, 0xC5, 0x0C, 0x46,
+		0xB3, 0x64, 0xF4, 0xC5, 0x2E, 0xB0, 0x29, 0x78, 0x9F, 0x86, 0xFF, 0x67, 0x14, 0x92, 0x4F,
+		0xE7, 0x6C, 0x26, 0x39, 0xCD, 0xC6, 0x34, 0x10, 0x45, 0xCD, 0x45, 0xF7, 0xF1, 0x4A, 0x32,
+		0xB2, 0xB6, 0x6E, 0x7A, 0xAA, 0xB6, 0xBC, 0x0F, 0xB8, 0xDE, 0x63, 0x62, 0xF4, 0xF0, 0x7F,
+		0x82, 0xA5, 0xDB, 0x2D, 0x18, 0x2D, 0x16, 0x34, 0x94, 0x03, 0x0E, 0x72, 0x06, 0x01, 0x47,
+		0x0D, 0xC1, 0x1E, 0xC4, 0xFA, 0x14, 0xB5, 0x47, 0x1A, 0x13, 0xCE, 0x75, 0x5E, 0xB9, 0xFA,
+		0xCE, 0x05, 0x0D, 0x15, 0xE8, 0x23, 0x50, 0x50, 0x95, 0xB2, 0xCA, 0x46, 0xAC, 0x0B, 0xDD,
+		0x59, 0x7B, 0xD6, 0xCE, 0xD3, 0x30, 0x14, 0xCA, 0x9A, 0x3C, 0xF4, 0xBB, 0x52, 0xDA, 0xF1,
+		0xA5, 0xBE, 0x11, 0x9A, 0x4B, 0x74, 0xF8, 0x9A, 0xD8, 0x1A, 0x14, 0x55, 0xE2, 0xCD, 0x0C,
+		0xF7, 0x40, 0x2E, 0xA6, 0x76, 0x4C, 0x5E, 0x67, 0x84, 0x8A, 0xB0, 0x51, 0xE3, 0xB1, 0xA8,
+		0x5F, 0xF1, 0x78, 0x5D, 0xF6, 0x5A, 0xF2, 0x76, 0xC6, 0xD5, 0x4C, 0x86, 0x03, 0x31, 0x77,
+		0x3E, 0xEC, 0xCE, 0x8E, 0xC6, 0xDA, 0x32, 0x86, 0xCD, 0x28, 0x8C, 0x7F, 0x39, 0xF8, 0x81,
+		0x41, 0x98, 0x94, 0xD6, 0xD6, 0x1E, 0x9D, 0x57, 0xE1, 0x94, 0xB0, 0x08, 0x60, 0x7C, 0x90,
+		0x43, 0xA9, 0x5B, 0x6B, 0xE0, 0x06, 0x7B, 0x94, 0x19, 0x45, 0x10, 0x50, 0x67, 0xC6, 0xFB,
+		0x38, 0xDF, 0x70, 0x87, 0x50, 0x9C, 0x46, 0x9D, 0x35, 0x98, 0x2E, 0xDD, 0x2A, 0xB0, 0xFF,
+		0x61, 0x18, 0x79, 0xB1, 0xCC, 0xCC, 0xE1, 0xC1, 0x3C
+	},
+	/* T[9] */
+	{
+		0xE7, 0x5B, 0x49, 0xCA, 0xCC, 0x62, 0xAF, 0x2D, 0x6B, 0x43, 0xC3, 0x33, 0x11, 0x50, 0x1F,
+		0xE2, 0x30, 0xF6, 0xAB, 0xB1, 0x04, 0x32, 0xE3, 0xAD, 0x0B, 0x03, 0x19, 0x5F, 0x50, 0xA8,
+		0x0A, 0x3A, 0xB1, 0x28, 0xF9, 0xF6, 0x0D, 0xC9, 0xE9, 0xEE, 0x72, 0x0B, 0x10, 0x42, 0x84,
+		0xAC, 0xD2, 0x07, 0x3B, 0x06, 0x40, 0x46, 0x64, 0xD1, 0x91, 0x21, 0x68, 0x28, 0x53, 0x62,
+		0x85, 0xC0, 0x18, 0x22, 0x50, 0x2B, 0x02, 0x88, 0x73, 0xD6, 0x76, 0x52, 0x35, 0x42, 0xB7,
+		0x3C, 0x4E, 0x97, 0x70, 0xFA, 0xBD, 0x19, 0xFB, 0x40, 0xB1, 0x8E, 0x38, 0xC4, 0x98, 0x12,
+		0x52, 0xE2, 0xE9, 0x71, 0x01, 0x75, 0x64, 0xCF, 0x9A, 0x7C, 0x65, 0x92, 0x7B, 0x07, 0xEE,
+		0x0F, 0xD7, 0xEB, 0xEC, 0x0E, 0x72, 0xD6, 0xBB, 0x3E, 0xCE, 0x87, 0x28, 0x5C, 0x60, 0x7D,
+		0x7B, 0x23, 0x6D, 0xB6, 0x38, 0x1E, 0x18, 0x4A, 0xDB, 0xAE, 0xCD, 0xF3, 0x3C, 0x38, 0xA1,
+		0x5E, 0x5E, 0xA6, 0xBB, 0x9A, 0x37, 0x25, 0xC7, 0xC5, 0xBD, 0x70, 0xD5, 0xF8, 0x5D, 0xCD,
+		0xFB, 0x96, 0x83, 0x46, 0xFF, 0x51, 0xCC, 0x77, 0x37, 0x1B, 0x48, 0x29, 0x87, 0x2E, 0x80,
+		0x53, 0xCB, 0xED, 0x0B, 0xD1, 0x06, 0x32, 0xC5, 0xA4, 0x72, 0xF3, 0x20, 0x7E, 0x03, 0x7D,
+		0xF0, 0xEC, 0x7C, 0x28, 0x9F, 0xBE, 0x47, 0xC5, 0x00, 0x94, 0xC1, 0x5F, 0xEF, 0x36, 0x0F,
+		0x25, 0x60, 0x0B, 0x59, 0x4E, 0x5B, 0x5D, 0x47, 0x56, 0x7F, 0xE1, 0xA9, 0xA9, 0x46, 0xF2,
+		0xD1, 0x5C, 0x69, 0x48, 0xD3, 0x4D, 0xB2, 0xAF, 0x4C, 0x22, 0x1D, 0x89, 0xEF, 0xD5, 0xF0,
+		0x1A, 0x32, 0xA0, 0x03, 0xB7, 0x91, 0xC0, 0x37, 0xDE, 0x16, 0xD7, 0x18, 0xE5, 0x97, 0xC5,
+		0xDB, 0x34, 0x24, 0xB8, 0x73, 0x5B, 0x09, 0x37, 0x92, 0x17, 0xC5, 0x47, 0x53, 0x9A, 0x5E,
+		0x58, 0x1A, 0x87, 0xC6, 0xC8, 0x32, 0x2E, 0x80, 0x39, 0x56, 0xD0, 0x9E, 0x95, 0x95, 0x00,
+		0x5E, 0xA1, 0x42, 0x2E, 0x96, 0x9A, 0x20, 0xFA, 0x1F, 0x86, 0xFE, 0x7F, 0x4E, 0xF5, 0xF3,
+		0x10, 0x77, 0x59, 0xE8, 0x64, 0x20, 0xBE, 0x4F, 0x84, 0x4D, 0xC3, 0x5C, 0x59, 0x4E, 0x89,
+		0x4B, 0x6C, 0x96, 0x9A, 0x31, 0xFF, 0x18, 0x05, 0xAC, 0x84, 0xA1, 0xC6, 0x2D, 0x97, 0x60,
+		0x2C, 0xEC, 0xF4, 0xB9, 0x18, 0x92, 0x10, 0x9D, 0x1B, 0x4D, 0x2D, 0xA7, 0x59, 0x36, 0x47,
+		0xF1, 0xCA, 0xB9, 0x3B, 0xEE, 0x7F, 0x9A, 0xF5, 0x39, 0x38, 0x7B, 0x67, 0x27, 0x95, 0xE3,
+		0x3F, 0x3D, 0x47, 0xA5, 0xAD, 0x92, 0xA5, 0xD2, 0xB9, 0xBA, 0x10, 0xA8, 0x3B, 0x8C, 0x85,
+		0x94, 0xA6, 0x7A, 0xAA, 0xD1, 0x13, 0x3F, 0xF5, 0x74, 0xF3, 0x48, 0x10, 0x82, 0xFF, 0x57,
+		0x4F, 0x7A, 0x60, 0x79, 0x00, 0x00, 0x68, 0xC6, 0x2E
+	},
+	/* T[10] */
+	{
+		0xE6, 0x27, 0x2C, 0xFA, 0x29, 0x11, 0x23, 0x1C, 0x3A, 0xAA, 0x43, 0x2E, 0xC0, 0xC9, 0x9B,
+		0xE1, 0x42, 0xAE, 0xB0, 0xD4, 0x63, 0x04, 0x8E, 0x20, 0x49, 0x28, 0x86, 0x5D, 0xFF, 0x49,
+		0xAB, 0xD4, 0x59, 0x5E, 0xA9, 0x16, 0xC2, 0x32, 0xAC, 0xCC, 0x0B, 0xF5, 0x59, 0x2E, 0x23,
+		0x72, 0x45, 0x60, 0x5A, 0x1D, 0x81, 0xA2, 0xBB, 0x8F, 0xA8, 0x54, 0xBA, 0x5E, 0x59, 0x95,
+		0x0C, 0xBC, 0xCE, 0x6D, 0x47, 0x1A, 0x59, 0x94, 0xEF, 0x62, 0x4C, 0x21, 0x65, 0xB5, 0xE7,
+		0x8A, 0xBA, 0xD6, 0x3B, 0xDC, 0x28, 0xB2, 0x93, 0xD6, 0xDF, 0xF3, 0x42, 0x88, 0x73, 0x7C,
+		0x78, 0x49, 0x1B, 0x7A, 0xC1, 0x6D, 0x03, 0x56, 0x66, 0x6A, 0x34, 0x8F, 0xAB, 0x13, 0x5A,
+		0x25, 0xB0, 0x47, 0x32, 0xA6, 0x67, 0xA1, 0x04, 0xD4, 0x56, 0xDC, 0x26, 0x0F, 0x0C, 0xE0,
+		0x9C, 0x84, 0x01, 0xCB, 0x22, 0x47, 0xB2, 0x68, 0x2E, 0xE6, 0xAB, 0x9C, 0xD3, 0xCF, 0x36,
+		0xC6, 0x4C, 0xEC, 0x63, 0xD4, 0xE4, 0x0B, 0x5C, 0x6D, 0x1A, 0x6F, 0xE8, 0xA8, 0x4D, 0x79,
+		0x1C, 0x0E, 0xA0, 0xDF, 0x07, 0xCB, 0xE6, 0xC0, 0x5F, 0xEE, 0x9C, 0x76, 0xE1, 0x36, 0x76,
+		0x88, 0x9C, 0x91, 0xAD, 0x5B, 0xA2, 0x0D, 0xE5, 0x77, 0x8F, 0x59, 0x4A, 0x43, 0x86, 0x22,
+		0x18, 0xF3, 0x58, 0x30, 0xF2, 0xE2, 0xAB, 0x7E, 0xAE, 0x69, 0xE4, 0xE4, 0xB0, 0x45, 0x78,
+		0xA4, 0x5C, 0xB4, 0x20, 0x68, 0xC6, 0xAA, 0x10, 0x6F, 0x9D, 0xE5, 0xCC, 0x31, 0x9A, 0x64,
+		0x54, 0x05, 0x2A, 0x97, 0x39, 0x38, 0x1D, 0x36, 0xD7, 0xDA, 0xF2, 0x04, 0x32, 0x65, 0x8D,
+		0x5D, 0xBF, 0x80, 0x1D, 0x9E, 0xAE, 0xD9, 0x5A, 0x25, 0xA9, 0xB4, 0x8A, 0x2A, 0x3F, 0x3A,
+		0x36, 0x8F, 0x06, 0xDA, 0x37, 0x6D, 0x99, 0x32, 0x5A, 0xF9, 0x34, 0x66, 0xFE, 0xF9, 0xF4,
+		0xAA, 0x9B, 0xBC, 0xBD, 0x78, 0xA6, 0xD7, 0xE0, 0x2B, 0x5B, 0xD6, 0x42, 0x79, 0xE6, 0x25,
+		0x1F, 0xBE, 0x3A, 0x05, 0x77, 0xD0, 0x29, 0x9C, 0xAC, 0xDE, 0x7B, 0x36, 0xA9, 0x83, 0x55,
+		0x7C, 0x3A, 0x2C, 0xAE, 0x4C, 0x74, 0x89, 0x2F, 0x4D, 0xF3, 0x95, 0x97, 0x04, 0x38, 0x9F,
+		0x76, 0x55, 0xBA, 0xEB, 0xB8, 0xB5, 0xF2, 0xE9, 0xA8, 0x87, 0xE9, 0x18, 0x10, 0x52, 0x9B,
+		0xA9, 0x97, 0x17, 0xB3, 0x77, 0x57, 0x92, 0x7E, 0x24, 0xD1, 0x3B, 0xF4, 0x82, 0xF6, 0x01,
+		0x0D, 0x4F, 0x05, 0x11, 0xC0, 0x89, 0xF9, 0x0A, 0xF0, 0xB5, 0x5B, 0x75, 0xB6, 0x66, 0xCD,
+		0x8C, 0xA3, 0x3E, 0x22, 0x69, 0x62, 0x02, 0x59, 0xE4, 0xBD, 0x19, 0x84, 0xFA, 0xC8, 0xA8,
+		0xE8, 0x38, 0x42, 0xB1, 0x10, 0x79, 0x65, 0xAE, 0xA3, 0x03, 0x36, 0xAE, 0xA5, 0x88, 0xC4,
+		0xBE, 0x01, 0x77, 0xD6, 0xA9, 0x0F, 0xC7, 0xDB, 0xEF
+	},
+	/* T[11] */
+	{
+		0x7E, 0xC3, 0xE0, 0xE2, 0xCD, 0x55, 0xAF, 0x8E, 0x01, 0x13, 0xE5, 0x61, 0x3E, 0x4D, 0x02,
+		0x93, 0x3A, 0x4F, 0xE9, 0xF7, 0xEB, 0xA6, 0x53, 0x5C, 0xC9, 0xC1, 0x67, 0xB3, 0xD2, 0xD1,
+		0x29, 0x55, 0xB6, 0xAA, 0x52, 0xD8, 0xDE, 0xAE, 0xF3, 0x72, 0xF6, 0xA2, 0x9C, 0x00, 0x78,
+		0x6B, 0x47, 0x6A, 0x04, 0x3F, 0x21, 0x5E, 0x74, 0xE5, 0x3D, 0x3A, 0xE3, 0x2B, 0x96, 0x31,
+		0x76, 0x33, 0xB7, 0x45, 0x23, 0xFE, 0xEA, 0x32, 0xF7, 0xA4, 0x73, 0x8F, 0x6A, 0x76, 0xAF,
+		0xDC, 0x1C, 0xB5, 0x30, 0x30, 0xFA, 0x4B, 0xD7, 0x8B, 0xC6, 0xE0, 0x96, 0xFE, 0x11, 0x70,
+		0xE6, 0x91, 0xB9, 0x4A, 0xE7, 0x69, 0x57, 0xCE, 0x50, 0x25, 0x9C, 0xA7, 0xD8, 0xCA, 0x08,
+		0x3F, 0xE1, 0x1E, 0x0C, 0x13, 0x86, 0x8B, 0xF3, 0x84, 0x19, 0x05, 0x0A, 0xB9, 0xD3, 0x6C,
+		0x06, 0x92, 0x16, 0x15, 0x25, 0xD7, 0x7F, 0xF2, 0x87, 0x18, 0x39, 0x37, 0xB1, 0xB4, 0xC3,
+		0x75, 0xDC, 0x44, 0xF4, 0x84, 0x7F, 0xA5, 0x90, 0xA3, 0x76, 0x9A, 0x16, 0xBA, 0x10, 0xCE,
+		0xD5, 0xF0, 0xB2, 0xCF, 0x59, 0xA2, 0xFF, 0xAC, 0x94, 0xBA, 0x92, 0xFD, 0xC1, 0xF2, 0x8E,
+		0x50, 0xB5, 0x22, 0xC6, 0x99, 0x55, 0x0C, 0x50, 0x63, 0x6C, 0xAA, 0xAD, 0x7F, 0xEE, 0x87,
+		0x54, 0x60, 0x33, 0x03, 0xF4, 0x2B, 0xE0, 0x60, 0xAF, 0x36, 0x3F, 0x87, 0xE2, 0xE1, 0x7E,
+		0x85, 0x6F, 0x4A, 0x89, 0xFD, 0x74, 0xB4, 0x43, 0xA2, 0x65, 0x5E, 0x72, 0xB9, 0x2C, 0xE0,
+		0x2C, 0x58, 0x17, 0xC2, 0xD2, 0xF1, 0x19, 0x63, 0x07, 0x6C, 0x64, 0xB4, 0x9F, 0x9A, 0xDC,
+		0x7F, 0x97, 0x8C, 0xE9, 0xC3, 0xBE, 0xAA, 0x6B, 0x73, 0xB8, 0x24, 0x4E, 0xEB, 0x27, 0xE2,
+		0xBB, 0x00, 0xE8, 0xD8, 0xEA, 0x78, 0xED, 0x45, 0x12, 0x11, 0xA9, 0xCE, 0xE9, 0x9F, 0xDE,
+		0x86, 0x69, 0x5B, 0x2C, 0xAB, 0xC5, 0xC4, 0x77, 0x45, 0x17, 0x41, 0x38, 0x50, 0x1B, 0x49,
+		0xE2, 0x8C, 0xF6, 0x71, 0x91, 0xB3, 0x5B, 0xF7, 0x2E, 0x61, 0x99, 0xB5, 0x11, 0x7A, 0x0F,
+		0xE5, 0x8F, 0xC0, 0xB7, 0xA7, 0x8C, 0x7A, 0x80, 0x60, 0xF2, 0x8F, 0x78, 0xE2, 0xC7, 0x9C,
+		0x27, 0x17, 0x20, 0x23, 0x5F, 0xFE, 0x75, 0xF7, 0xDF, 0x5B, 0xD3, 0xC8, 0x8C, 0xDD, 0x22,
+		0x34, 0x8D, 0x4E, 0x5F, 0xC1, 0x54, 0x04, 0x6C, 0xEB, 0x1B, 0x0A, 0x1C, 0xFD, 0x85, 0x88,
+		0x96, 0x2A, 0xBB, 0x6C, 0x42, 0x7E, 0xED, 0xB2, 0x56, 0x2C, 0xDF, 0xC7, 0x1A, 0x50, 0x27,
+		0x99, 0x0D, 0x33, 0xC0, 0xA9, 0xCE, 0x83, 0x9D, 0xEE, 0x72, 0xFD, 0xC5, 0x4F, 0x3E, 0x87,
+		0x79, 0xAB, 0xDD, 0x81, 0xCE, 0x6A, 0xBA, 0x30, 0x01, 0x04, 0xCC, 0xE6, 0x96, 0xC0, 0x8C,
+		0x8A, 0x07, 0x57, 0x31, 0x4D, 0x4E, 0xE7, 0x4B, 0xAF
+	},
+	/* T[12] */
+	{
+		0x78, 0xDA, 0x87, 0xF1, 0x5F, 0xD6, 0x50, 0x66, 0x68, 0xB9, 0x2E, 0x3E, 0xEB, 0xBF, 0xA4,
+		0xE1, 0x2E, 0x57, 0x1C, 0x3A, 0x64, 0x1B, 0xFF, 0x41, 0x2A, 0x05, 0x00, 0xB9, 0xD5, 0x2C,
+		0x37, 0x7B, 0xD7, 0x29, 0x4B, 0xA7, 0x99, 0x98, 0xCC, 0xC3, 0x97, 0x4C, 0x33, 0x94, 0x72,
+		0x95, 0x8A, 0xC7, 0x60, 0xDC, 0x2F, 0xC6, 0x76, 0x1D, 0x75, 0xF1, 0xE6, 0xA6, 0xF4, 0xFF,
+		0xB2, 0x9C, 0x19, 0xFB, 0xC2, 0xF4, 0xF7, 0xC3, 0x87, 0xA7, 0x13, 0x50, 0x83, 0x54, 0x13,
+		0x92, 0x26, 0x69, 0xE5, 0xFB, 0x41, 0xA8, 0x9E, 0x0E, 0x2D, 0x61, 0x58, 0x9B, 0x83, 0xC2,
+		0x22, 0xCA, 0xB3, 0x44, 0xBF, 0xF0, 0x41, 0xC2, 0x3B, 0xA2, 0x1E, 0x25, 0x68, 0x75, 0x10,
+		0x2D, 0x2B, 0x22, 0x9D, 0xF0, 0xD7, 0x8A, 0xCE, 0x45, 0xAA, 0x3C, 0x86, 0x44, 0x42, 0xE0,
+		0xB2, 0xB9, 0x95, 0x19, 0x06, 0x6A, 0x80, 0x26, 0xC7, 0x0A, 0xEA, 0x47, 0x54, 0xDD, 0xC3,
+		0xBD, 0xEB, 0x72, 0x2F, 0xB7, 0x9D, 0xE8, 0x3D, 0xA9, 0x21, 0xF8, 0xF3, 0xED, 0xC4, 0xCD,
+		0x87, 0xE4, 0x02, 0x1D, 0x80, 0xCB, 0x41, 0x02, 0x03, 0xBA, 0x07, 0xE6, 0xDC, 0x81, 0xBE,
+		0xAF, 0x52, 0x16, 0x79, 0xE7, 0xD5, 0x3A, 0xE2, 0x4B, 0x66, 0x18, 0x49, 0xD8, 0x7E, 0xE9,
+		0x06, 0xF3, 0xA7, 0xE3, 0xA1, 0xBE, 0xEA, 0x21, 0x37, 0x6B, 0x28, 0x6C, 0xBE, 0x58, 0xCE,
+		0xD6, 0xAD, 0xFB, 0x7D, 0x4F, 0x55, 0x02, 0x3D, 0xD6, 0xCB, 0x53, 0x4B, 0xB9, 0x28, 0x35,
+		0x90, 0x9E, 0x6A, 0x14, 0xBF, 0xAA, 0x48, 0xF3, 0x3D, 0xA1, 0xCB, 0xD9, 0x78, 0x97, 0x2A,
+		0xB1, 0x2A, 0x58, 0x7E, 0x47, 0xA3, 0x87, 0xED, 0xAC, 0x04, 0x04, 0x0E, 0x2A, 0xE4, 0xFA,
+		0x7C, 0xD7, 0x66, 0x19, 0x5C, 0x31, 0xFF, 0xA1, 0x1D, 0x2E, 0xEF, 0xEF, 0x13, 0xED, 0x1B,
+		0xAD, 0x9E, 0x07, 0x48, 0x59, 0xC2, 0x0D, 0x1E, 0xF0, 0xBA, 0xB4, 0x69, 0x6C, 0x2B, 0x6E,
+		0x50, 0xAD, 0xDF, 0x97, 0x57, 0x90, 0x68, 0xB3, 0xF5, 0x5E, 0x8F, 0x60, 0x8B, 0x77, 0x95,
+		0x9A, 0x59, 0x01, 0x05, 0x70, 0x1F, 0x4A, 0x78, 0x4F, 0x57, 0xD1, 0xDB, 0xB2, 0x4E, 0xFD,
+		0x1D, 0x21, 0x4D, 0x9A, 0x47, 0x75, 0x16, 0x07, 0xE5, 0x0C, 0xFF, 0x8E, 0xEC, 0xCC, 0xEC,
+		0x08, 0xEC, 0xDE, 0x8C, 0x6E, 0xA6, 0xF8, 0xC8, 0x97, 0xC5, 0x9B, 0xF6, 0x09, 0x58, 0x47,
+		0x07, 0xDF, 0xDE, 0x28, 0xA4, 0x5C, 0xE6, 0x4D, 0x71, 0x2D, 0x9B, 0x15, 0x3C, 0x8D, 0x5E,
+		0x6D, 0x8D, 0xEA, 0xCD, 0x03, 0xE7, 0xC7, 0xA9, 0x97, 0x5F, 0x8B, 0x90, 0xA8, 0xF1, 0x9A,
+		0x10, 0x5F, 0xAA, 0x13, 0x8C, 0xC0, 0x77, 0xC2, 0x59, 0x5E, 0xEC, 0x1F, 0x78, 0x5C, 0xE4,
+		0xD6, 0xCD, 0xF7, 0x2D, 0x92, 0xF8, 0x8F, 0x33, 0x82
+	},
+	/* T[13] */
+	{
+		0x5C, 0x44, 0xA7, 0xB6, 0xDF, 0x2F, 0x92, 0x00, 0x79, 0x7E, 0x31, 0xF6, 0x57, 0xEC, 0xB3,
+		0xFC, 0x5E, 0x26, 0xC8, 0x0C, 0xF2, 0xD3, 0xC2, 0xA3, 0x80, 0x14, 0x67, 0x90, 0x15, 0x0D,
+		0x7C, 0x83, 0x2F, 0xB6, 0xFC, 0xF9, 0x89, 0xD4, 0xC9, 0x8D, 0x51, 0xE8, 0xF0, 0xF3, 0x20,
+		0x83, 0xAC, 0x29, 0x05, 0x22, 0xBB, 0x78, 0xB4, 0x1E, 0xC7, 0x83, 0x20, 0xEC, 0xB4, 0x22,
+		0x98, 0x4E, 0x59, 0x7C, 0x2F, 0x06, 0x6B, 0xF6, 0xCB, 0x9F, 0xDC, 0x06, 0xC7, 0x98, 0xF6,
+		0xED, 0xFB, 0x54, 0x80, 0x5A, 0x5F, 0xB2, 0x90, 0x73, 0x96, 0x76, 0xE0, 0x33, 0x7A, 0xCB,
+		0xF4, 0x87, 0x98, 0x4A, 0x4F, 0xD5, 0x6C, 0x5A, 0x52, 0x33, 0xE1, 0xA7, 0xCA, 0xFD, 0xF3,
+		0xA3, 0x8F, 0x8A, 0x1D, 0x1D, 0xF5, 0xE9, 0x75, 0x0B, 0x86, 0x8A, 0xC5, 0x8C, 0x97, 0xE7,
+		0xF9, 0x9E, 0xF0, 0x0B, 0xDD, 0x4D, 0x02, 0xB6, 0xB1, 0x82, 0x02, 0xF8, 0x6F, 0xA9, 0x2B,
+		0x80, 0xC7, 0x0E, 0x6F, 0x44, 0x1B, 0x3F, 0x95, 0x8E, 0xA3, 0x12, 0x09, 0x5D, 0x1E, 0xBC,
+		0x4C, 0x47, 0xD1, 0xCD, 0x9D, 0x4C, 0x03, 0xFF, 0x6D, 0x2A, 0xE9, 0xD7, 0xFC, 0x79, 0xD8,
+		0x3F, 0x6D, 0x95, 0x93, 0x6E, 0xBF, 0x89, 0xD5, 0xFF, 0xCE, 0x6F, 0x8E, 0x51, 0xA2, 0x7B,
+		0x8E, 0x92, 0x04, 0x79, 0xC3, 0x99, 0xD6, 0x19, 0xB8, 0xAA, 0x2D, 0xA7, 0xF0, 0x7F, 0x1B,
+		0xD9, 0x35, 0xCC, 0x66, 0x85, 0x72, 0xBC, 0x2D, 0xEC, 0x20, 0x91, 0x35, 0x7E, 0x5D, 0x81,
+		0x17, 0x37, 0x33, 0xCF, 0x18, 0xBF, 0xB0, 0x68, 0x9C, 0x3B, 0xD0, 0x8F, 0x2C, 0xC3, 0x62,
+		0x4B, 0x40, 0xC0, 0xA2, 0x3B, 0x5B, 0xDD, 0x78, 0xB7, 0xC7, 0xE3, 0x14, 0xE2, 0x6E, 0xC4,
+		0x45, 0x4F, 0xE1, 0xC9, 0xB7, 0xA4, 0x75, 0xCA, 0x37, 0x84, 0x81, 0x91, 0x5B, 0x00, 0x95,
+		0xFC, 0xC5, 0x7A, 0x26, 0x69, 0x0C, 0x08, 0x25, 0xE9, 0xCB, 0x8F, 0x05, 0x14, 0x27, 0x6F,
+		0xB5, 0x50, 0x48, 0x1F, 0xD3, 0x23, 0x51, 0x77, 0xB1, 0xDD, 0x65, 0xB4, 0x9A, 0x4A, 0x9E,
+		0x3F, 0xF3, 0x75, 0xC3, 0x45, 0x3F, 0x5A, 0xA3, 0x7A, 0x4F, 0x6B, 0x0D, 0x62, 0x61, 0x30,
+		0xFD, 0x5B, 0xC0, 0xC7, 0xC7, 0x81, 0xC9, 0xDB, 0x43, 0x9B, 0x20, 0xF2, 0xBD, 0xA0, 0xA8,
+		0x1E, 0xED, 0x44, 0xAD, 0x5F, 0x91, 0xEF, 0xE6, 0x10, 0x5E, 0x7A, 0xF9, 0x66, 0x15, 0x24,
+		0xD1, 0x2F, 0x27, 0xD4, 0xF5, 0xB7, 0x07, 0xC1, 0x07, 0x35, 0x12, 0xA7, 0x73, 0xE9, 0xEA,
+		0x10, 0xB4, 0x14, 0x8B, 0x60, 0xF9, 0x22, 0x3E, 0x30, 0x3E, 0x78, 0xE9, 0x81, 0x61, 0x9F,
+		0xCA, 0x27, 0x9A, 0x67, 0xFD, 0xC8, 0x35, 0xAF, 0x27, 0xD4, 0xFA, 0x5C, 0x07, 0x5A, 0xD2,
+		0x9C, 0x05, 0xD3, 0xE3, 0xDE, 0xDA, 0xCC, 0x01, 0x8C
+	},
+	/* T[14] */
+	{
+		0xAD, 0xF8, 0x74, 0x24, 0x39, 0xC1, 0x32, 0x65, 0x83, 0x0B, 0x36, 0xA7, 0xB0, 0xF9, 0xDF,
+		0x8E, 0x6E, 0x28, 0x10, 0xD8, 0x53, 0x1D, 0x28, 0xC9, 0x1C, 0xC6, 0x13, 0x99, 0xC1, 0xBF,
+		0x59, 0x59, 0xC2, 0x4E, 0xE0, 0x75, 0xDF, 0x5D, 0x99, 0xFF, 0xFB, 0xE7, 0x19, 0xBF, 0x40,
+		0x8F, 0x4A, 0x36, 0xD8, 0x2F, 0xD0, 0x42, 0x1B, 0x3B, 0x60, 0xAB, 0x10, 0xF1, 0x1A, 0x4A,
+		0x4D, 0xC2, 0x0A, 0x08, 0x09, 0xD7, 0x8E, 0x88, 0xD4, 0x3B, 0x4F, 0xED, 0x15, 0x4C, 0x0F,
+		0xC6, 0x21, 0xE1, 0xAB, 0x8D, 0x1D, 0x52, 0x9C, 0x6A, 0xFB, 0xD9, 0x6F, 0x53, 0xE8, 0x19,
+		0x54, 0x00, 0x10, 0x84, 0x37, 0x0A, 0x1A, 0xC6, 0xDC, 0x09, 0x12, 0x47, 0x31, 0x0E, 0xA3,
+		0xEE, 0x58, 0x21, 0x8C, 0xF3, 0xD5, 0x74, 0x81, 0x80, 0x1B, 0xC7, 0xF7, 0x1B, 0x84, 0xFC,
+		0x90, 0x6C, 0x12, 0xFD, 0xC5, 0x40, 0x9D, 0x98, 0x6B, 0x86, 0x94, 0x3A, 0x2F, 0x7B, 0x14,
+		0xF1, 0xE1, 0xDA, 0x4F, 0x06, 0x6E, 0x3F, 0x49, 0x9A, 0x34, 0x27, 0x01, 0x86, 0xB5, 0x6E,
+		0x51, 0x69, 0x48, 0x20, 0xD8, 0xE4, 0x30, 0x89, 0xD5, 0x6C, 0x41, 0xB6, 0xC0, 0x5B, 0x97,
+		0xA6, 0xB7, 0xA5, 0x3A, 0x6E, 0x73, 0x35, 0xFC, 0xB3, 0x5D, 0x68, 0x2B, 0xED, 0x19, 0x40,
+		0x4E, 0x53, 0x82, 0x87, 0x86, 0x41, 0xB2, 0xCD, 0x5B, 0x41, 0xB0, 0x6F, 0x61, 0xDB, 0x45,
+		0x79, 0x09, 0x64, 0xD5, 0xD1, 0xD8, 0x91, 0xC1, 0xD7, 0xC2, 0xCB, 0x35, 0xA8, 0x94, 0xB1,
+		0xFD, 0x76, 0x92, 0x56, 0xEB, 0x72, 0xF9, 0x73, 0x44, 0x0B, 0xF0, 0xB0, 0xBD, 0xA8, 0x90,
+		0x78, 0x41, 0x1B, 0xCF, 0x68, 0x5A, 0xAD, 0xAD, 0x0E, 0x0B, 0x9F, 0x65, 0x13, 0x80, 0xD5,
+		0x4B, 0x6D, 0x82, 0xBD, 0x25, 0xC3, 0xB7, 0x6B, 0x31, 0xA0, 0xEE, 0x83, 0xB5, 0x70, 0xE5,
+		0xEB, 0x12, 0x83, 0x48, 0xD7, 0x99, 0x62, 0x61, 0xF8, 0xE1, 0xC2, 0xED, 0xE4, 0x46, 0x35,
+		0xC8, 0x17, 0x18, 0x04, 0x06, 0xF1, 0xF1, 0x22, 0xDC, 0x89, 0x23, 0x71, 0xB6, 0x37, 0x41,
+		0xE6, 0x20, 0xD9, 0xFC, 0xA6, 0x3A, 0x4A, 0x2D, 0x1C, 0x72, 0xEF, 0x65, 0x4D, 0x03, 0xF0,
+		0xDA, 0x55, 0x67, 0x52, 0x80, 0x59, 0x40, 0x75, 0x8C, 0xF5, 0x3D, 0x24, 0x70, 0x74, 0x75,
+		0x15, 0x09, 0xC6, 0x1E, 0x7E, 0x38, 0x07, 0xA0, 0x02, 0x1C, 0x2D, 0x22, 0xFC, 0xC2, 0x88,
+		0x7C, 0xC0, 0x3C, 0x9E, 0xCA, 0x10, 0xE4, 0x33, 0x0C, 0xA7, 0xA9, 0x29, 0x4B, 0xE6, 0xF7,
+		0x6E, 0xF3, 0x18, 0x31, 0x00, 0x89, 0xB6, 0xC6, 0x25, 0x55, 0x09, 0x59, 0x10, 0x82, 0x78,
+		0xB8, 0xF8, 0x34, 0x17, 0x2A, 0x26, 0x47, 0x93, 0x48, 0xA2, 0x40, 0xFB, 0xAF, 0x4B, 0x4B,
+		0x08, 0xF0, 0x82, 0x69, 0xD7, 0x1D, 0x92, 0x26, 0x47
+	},
+	/* T[15] */
+	{
+		0x65, 0xDA, 0x44, 0xB5, 0x20, 0xC5, 0xFB, 0xFC, 0x34, 0x08, 0x81, 0x60, 0x10, 0xA7, 0x17,
+		0x29, 0xD8, 0x75, 0x2C, 0x97, 0x1C, 0xFD, 0x75, 0x7A, 0x14, 0xD7, 0x77, 0xE7, 0x29, 0x85,
+		0x59, 0x64, 0xC5, 0x67, 0x26, 0x5A, 0xAB, 0x99, 0x30, 0x98, 0xF7, 0xA5, 0x67, 0x4F, 0x98,
+		0x30, 0x64, 0x78, 0x6A, 0x2F, 0xC4, 0x2F, 0x20, 0x7A, 0x1A, 0x05, 0xC4, 0x34, 0x64, 0x29,
+		0xAD, 0xAC, 0xF5, 0x82, 0x41, 0x92, 0x28, 0x63, 0xDD, 0x33, 0x48, 0xCF, 0xBC, 0xEB, 0x2E,
+		0x7B, 0x82, 0x4C, 0xDD, 0x6C, 0xB5, 0xB8, 0x45, 0x59, 0xF8, 0x97, 0x64, 0x62, 0x64, 0x80,
+		0x8D, 0xDB, 0x76, 0x80, 0xEB, 0x68, 0xBB, 0x39, 0x08, 0x3B, 0x4B, 0xC7, 0x16, 0x58, 0x27,
+		0xCA, 0x4C, 0x73, 0x4B, 0xE1, 0xCB, 0x93, 0xAC, 0x07, 0x57, 0xF2, 0x0C, 0xDC, 0x87, 0x35,
+		0x8C, 0x1A, 0xE8, 0xCA, 0xF6, 0x17, 0xD6, 0xE9, 0x4F, 0x12, 0x0C, 0x80, 0x98, 0x65, 0xED,
+		0xEA, 0x2E, 0x00, 0xCC, 0x25, 0x2F, 0xCE, 0x01, 0xE4, 0x7A, 0x92, 0xF0, 0x35, 0xF5, 0x3C,
+		0x8E, 0x4C, 0x13, 0x7B, 0x62, 0x72, 0x91, 0x21, 0x32, 0xEA, 0x6C, 0x12, 0x46, 0xB3, 0xA4,
+		0x7D, 0xD2, 0xF1, 0xEF, 0x03, 0xA0, 0x23, 0x0F, 0x4B, 0x0A, 0xFA, 0x07, 0x44, 0x3A, 0x27,
+		0x29, 0x59, 0x28, 0x31, 0x07, 0x97, 0x63, 0x30, 0x3D, 0xA4, 0x07, 0x79, 0x3E, 0x6C, 0xF5,
+		0xD8, 0xE6, 0xCC, 0x9B, 0x0E, 0x69, 0x62, 0x3E, 0x4E, 0x09, 0xE1, 0x24, 0x9B, 0xC6, 0x29,
+		0xD9, 0x7F, 0x8D, 0xCD, 0xA0, 0xE1, 0x44, 0xBC, 0xF0, 0x57, 0xF3, 0x6B, 0x6F, 0x02, 0x25,
+		0x99, 0x69, 0x14, 0x4D, 0x49, 0x84, 0xB5, 0x1F, 0xCF, 0xC7, 0xD3, 0x2E, 0x73, 0x74, 0xFA,
+		0x38, 0xCB, 0xE2, 0xA2, 0x1C, 0xD2, 0x48, 0x8E, 0xF0, 0x8B, 0x63, 0x6B, 0x7E, 0x43, 0x0E,
+		0xFC, 0x63, 0x91, 0x07, 0x32, 0x61, 0x95, 0xBA, 0xAD, 0xA1, 0xDC, 0x16, 0x68, 0x54, 0x79,
+		0x1B, 0x53, 0xD7, 0x54, 0xCE, 0xB3, 0x9E, 0x9C, 0x29, 0x34, 0x96, 0x73, 0x60, 0x83, 0x54,
+		0xD8, 0xF5, 0xEA, 0xEB, 0x5E, 0x17, 0xCC, 0x50, 0x72, 0xA3, 0x27, 0x9E, 0xDB, 0x55, 0x13,
+		0x65, 0x3A, 0xDF, 0xC3, 0x15, 0x12, 0xCB, 0xD9, 0x70, 0x51, 0x66, 0x72, 0x5E, 0xB6, 0x5B,
+		0x54, 0xA4, 0x40, 0x7F, 0x48, 0x8E, 0xC4, 0x18, 0xB0, 0xD0, 0x88, 0x6F, 0xC2, 0xD6, 0x4C,
+		0xEE, 0x78, 0xE8, 0xA8, 0x92, 0x2E, 0x41, 0x5B, 0xF9, 0x3F, 0xDE, 0xAA, 0x63, 0x3D, 0x70,
+		0x0E, 0x25, 0x36, 0xC4, 0x76, 0xDB, 0xEB, 0xC4, 0x13, 0xBA, 0x4D, 0x5E, 0xA1, 0x8A, 0xC7,
+		0xD1, 0x46, 0xF0, 0x7D, 0x2F, 0xC8, 0x34, 0x35, 0x88, 0xA2, 0xD1, 0x88, 0x70, 0xC7, 0xFE,
+		0xCB, 0xB2, 0x8C, 0x11, 0x33, 0x93, 0xDA, 0xBF, 0x66
+	}
+};
+
+int mu_fb_init(mu_bn_t *g, mu_bn_t *n, mu_bn_ctx_t *ctx)
+{
+	return 0;
+}
+
+static mu_bn_t *mu_fb_get_entry(int k, mu_bn_t *one, mu_bn_t *tmp)
+{
+	if (k == 0)
+		return one;
+	if (mu_bn_set_from_bin(tmp, mu_fb_table_3072[k - 1], MU_FB_LEN) < 0)
+		return NULL;
+	return tmp;
+}
+
+#else /* !MU_FB_CONST_TABLE */
+/* Set only once fully calculated, so that it can be checked without a lock */
+static mu_bn_t **mu_fb_table;
+
+int mu_fb_init(mu_bn_t *g, mu_bn_t *n, mu_bn_ctx_t *ctx)
+{
+	mu_bn_t **table;
+	int j, k;
+
+	if (mu_fb_table)
+		return 0;
+	table = calloc(MU_FB_ENTRIES, sizeof(mu_bn_t *));
+	if (!table)
+		return -1;
+	for (k = 0; k < MU_FB_ENTRIES; k++) {
+		table[k] = mu_bn_new();
+		if (!table[k])
+			goto error;
+	}
+	if (mu_bn_set_from_bin(table[0], "\x01", 1) < 0 || mu_bn_copy(table[1], g) < 0)
+		goto error;
+
+	/* T[2^j] = T[2^(j - 1)]^(2^MU_FB_COLS) */
+	for (j = 1; j < MU_FB_ROWS; j++) {
+		mu_bn_t *cur = table[1 << j];
+		mu_bn_t *tmp = table[(1 << j) + 1];
+		if (mu_bn_copy(cur, table[1 << (j - 1)]) < 0)
+			goto error;
+		for (k = 0; k < MU_FB_COLS; k++) {
+			mu_bn_a_mul_b_mod_c(tmp, cur, cur, n, ctx);
+			if (mu_bn_copy(cur, tmp) < 0)
+				goto error;
+		}
+	}
+
+	/* Every other entry is the product of its highest power of 2 and the rest */
+	for (k = 3; k < MU_FB_ENTRIES; k++) {
+		int high = 1 << (MU_FB_ROWS - 1);
+		while (!(k & high))
+			high >>= 1;
+		if (k == high)
+			continue;
+		mu_bn_a_mul_b_mod_c(table[k], table[high], table[k - high], n, ctx);
+	}
+	mu_fb_table = table;
+	return 0;
+ error:
+	for (k = 0; k < MU_FB_ENTRIES; k++) {
+		if (table[k])
+			mu_bn_free(table[k]);
+	}
+	free(table);
+	return -1;
+}
+
+static mu_bn_t *mu_fb_get_entry(int k, mu_bn_t *one, mu_bn_t *tmp)
+{
+	return mu_fb_table[k];
+}
+#endif /* !MU_FB_CONST_TABLE */
+
+int mu_fb_exp_mod(mu_bn_t *result, mu_bn_t *e, mu_bn_t *n, mu_bn_ctx_t *ctx)
+{
+	mu_bn_t *r = NULL, *t = NULL, *one = NULL, *tmp = NULL;
+	int i, j, ret = -1;
+
+#ifndef MU_FB_CONST_TABLE
+	if (!mu_fb_table)
+		return -1;
+#endif
+	if (mu_bn_num_bits(e) > MU_FB_MAX_BITS)
+		return -1;
+
+	r = mu_bn_new();
+	t = mu_bn_new();
+	one = mu_bn_new_from_bin("\x01", 1);
+	tmp = mu_bn_new();
+	if (!r || !t || !one || !tmp)
+		goto done;
+
+	/* The multiplication is done even for a zero column (by T[0] = 1),
+	 * so that the time taken does not depend on the bits of e
+	 */
+	for (i = MU_FB_COLS - 1; i >= 0; i--) {
+		int k = 0;
+		for (j = 0; j < MU_FB_ROWS; j++)
+			k |= mu_bn_get_bit(e, i + j * MU_FB_COLS) << j;
+		mu_bn_t *entry = mu_fb_get_entry(k, one, tmp);
+		if (!entry)
+			goto done;
+		if (i == MU_FB_COLS - 1) {
+			if (mu_bn_copy(r, entry) < 0)
+				goto done;
+			continue;
+		}
+		mu_bn_a_mul_b_mod_c(t, r, r, n, ctx);
+		mu_bn_a_mul_b_mod_c(r, t, entry, n, ctx);
+	}
+	if (mu_bn_copy(result, r) < 0)
+		goto done;
+	ret = 0;
+ done:
+	if (r)
+		mu_bn_free(r);
+	if (t)
+		mu_bn_free(t);
+	if (one)
+		mu_bn_free(one);
+	if (tmp)
+		mu_bn_free(tmp);
+	return ret;
+}
@@ -0,0 +1,31 @@
+#ifndef _MU_FIXED_BASE_H_
+#define _MU_FIXED_BASE_H_
+
+#include "mu_bignum.h"
+
+/* Fixed-base exponentiation for the generator of the 3072-bit SRP group.
+ *
+ * Since both g and N are constants, the powers of g needed by a Lim-Lee comb
+ * can be calculated just once, which cuts down the modular multiplications
+ * for a 256-bit exponent from about 300 to about 130.
+ */
+
+/* Prepares the comb table for the given generator and modulus.
+ *
+ * On ESP8266, the table is calculated on the heap (about 6KB), since
+ * const data is not kept in flash there. Elsewhere, it is a const table
+ * and this is a no-op.
+ * Since this takes about as long as a single exponentiation, it is meant
+ * to be called once, from a background task. mu_fb_exp_mod() falls back
+ * until it is done.
+ */
+int mu_fb_init(mu_bn_t *g, mu_bn_t *n, mu_bn_ctx_t *ctx);
+
+/* result = g^e % n
+ *
+ * Returns -1 if the table is not ready or e is longer than 256 bits,
+ * in which case mu_bn_a_exp_b_mod_c() should be used instead.
+ */
+int mu_fb_exp_mod(mu_bn_t *result, mu_bn_t *e, mu_bn_t *n, mu_bn_ctx_t *ctx);
+
+#endif /* ! _MU_FIXED_BASE_H_ */
@@ -2,6 +2,7 @@
 #include "hkdf-sha.h"
 #include "mu_bignum.h"
 #include "mu_srp.h"
+#include "mu_fixed_base.h"
 
 #ifdef SRP_DEBUG
 #include <stdio.h>
@@ -130,6 +131,10 @@ void mu_srp_free(mu_srp_handle_t *hd)
 		free(hd->bytes_B);
 	if (hd->b)
 		mu_bn_free(hd->b);
+	if (hd->gb)
+		mu_bn_free(hd->gb);
+	if (hd->kv)
+		mu_bn_free(hd->kv);
 	if (hd->A)
 		mu_bn_free(hd->A);
 	if (hd->bytes_A)
@@ -221,44 +226,129 @@ static mu_bn_t *calculate_u(mu_srp_handle_t *hd, char *A, int len_A)
 	return calculate_padded_hash(hd, A, len_A, hd->bytes_B, hd->len_B);
 }
 
-int __mu_srp_srv_pubkey(mu_srp_handle_t *hd, char **bytes_B, int *len_B)
+/* g^e % N, using the fixed-base comb when enabled and applicable */
+static int calculate_g_exp(mu_srp_handle_t *hd, mu_bn_t *result, mu_bn_t *e)
+{
+#ifdef CONFIG_MU_SRP_FIXED_BASE_COMB
+	if (mu_fb_exp_mod(result, e, hd->n, hd->ctx) == 0)
+		return 0;
+#endif
+	return mu_bn_a_exp_b_mod_c(result, hd->g, e, hd->n, hd->ctx);
+}
+
+int mu_srp_prepare_fixed_base(mu_srp_handle_t *hd)
+{
+#ifdef CONFIG_MU_SRP_FIXED_BASE_COMB
+	return mu_fb_init(hd->g, hd->n, hd->ctx);
+#else
+	return 0;
+#endif
+}
+
+/* kv = k * v % N
+ *
+ * This depends only on the verifier, so it is computed once and kept in the handle
+ */
+static int calculate_kv(mu_srp_handle_t *hd)
 {
+	if (hd->kv)
+		return 0;
+	if (!hd->v)
+		return -1;
 	mu_bn_t *k = calculate_k(hd);
-	mu_bn_t *kv = NULL;
-	mu_bn_t *gb = NULL;
 	if (!k)
-		goto error;
+		return -1;
+	hd->kv = mu_bn_new();
+	if (!hd->kv) {
+		mu_bn_free(k);
+		return -1;
+	}
+	mu_bn_a_mul_b_mod_c(hd->kv, k, hd->v, hd->n, hd->ctx);
+	mu_bn_free(k);
+	return 0;
+}
 
-	hd->b = mu_bn_new();
-	if (!hd->b)
+int mu_srp_gen_ephemeral(mu_srp_handle_t *hd, mu_srp_ephemeral_t *eph)
+{
+	eph->b = mu_bn_new();
+	eph->gb = mu_bn_new();
+	if (!eph->b || !eph->gb) {
+		mu_srp_free_ephemeral(eph);
+		return -1;
+	}
+	mu_bn_get_rand(eph->b, 256, -1, 0);
+	calculate_g_exp(hd, eph->gb, eph->b);
+	return 0;
+}
+
+void mu_srp_free_ephemeral(mu_srp_ephemeral_t *eph)
+{
+	if (eph->b)
+		mu_bn_free(eph->b);
+	if (eph->gb)
+		mu_bn_free(eph->gb);
+	eph->b = NULL;
+	eph->gb = NULL;
+}
+
+int mu_srp_set_ephemeral(mu_srp_handle_t *hd, mu_srp_ephemeral_t *eph)
+{
+	if (hd->b || !eph->b || !eph->gb)
+		return -1;
+	hd->b = eph->b;
+	hd->gb = eph->gb;
+	eph->b = NULL;
+	eph->gb = NULL;
+	return 0;
+}
+
+int mu_srp_get_kv(mu_srp_handle_t *hd, char **bytes_kv, int *len_kv)
+{
+	if (calculate_kv(hd) < 0)
+		return -1;
+	*bytes_kv = mu_bn_to_bin(hd->kv, len_kv);
+	if (!*bytes_kv)
+		return -1;
+	return 0;
+}
+
+int mu_srp_set_kv(mu_srp_handle_t *hd, const char *bytes_kv, int len_kv)
+{
+	if (hd->kv)
+		mu_bn_free(hd->kv);
+	hd->kv = mu_bn_new_from_bin(bytes_kv, len_kv);
+	if (!hd->kv)
+		return -1;
+	return 0;
+}
+
+int __mu_srp_srv_pubkey(mu_srp_handle_t *hd, char **bytes_B, int *len_B)
+{
+	if (calculate_kv(hd) < 0)
 		goto error;
-	mu_bn_get_rand(hd->b, 256, -1, 0);
+
+	/* The ephemeral may have been generated ahead of time and set
+	 * using mu_srp_set_ephemeral()
+	 */
+	if (!hd->b) {
+		mu_srp_ephemeral_t eph;
+		if (mu_srp_gen_ephemeral(hd, &eph) < 0)
+			goto error;
+		hd->b = eph.b;
+		hd->gb = eph.gb;
+	}
 	hex_dbg_bn("b", hd->b);
 
 	/* B = kv + g^b */
-	kv = mu_bn_new();
-	gb = mu_bn_new();
 	hd->B = mu_bn_new();
-	if (!kv || !gb || ! hd->B)
+	if (! hd->B)
 		goto error;
-	mu_bn_a_mul_b_mod_c(kv, k, hd->v, hd->n, hd->ctx);
-	mu_bn_a_exp_b_mod_c(gb, hd->g, hd->b, hd->n, hd->ctx);
-	mu_bn_a_add_b_mod_c(hd->B, kv, gb, hd->n, hd->ctx);
+	mu_bn_a_add_b_mod_c(hd->B, hd->kv, hd->gb, hd->n, hd->ctx);
 	hd->bytes_B = mu_bn_to_bin(hd->B, len_B);
 	hd->len_B = *len_B;
 	*bytes_B = hd->bytes_B;
-
-	mu_bn_free(k);
-	mu_bn_free(kv);
-	mu_bn_free(gb);
 	return 0;
  error:
-	if (k)
-		mu_bn_free(k);
-	if (kv)
-		mu_bn_free(kv);
-	if (gb)
-		mu_bn_free(gb);
 	if (hd->B) {
 		mu_bn_free(hd->B);
 		hd->B = NULL;
@@ -267,6 +357,10 @@ int __mu_srp_srv_pubkey(mu_srp_handle_t *hd, char **bytes_B, int *len_B)
 		mu_bn_free(hd->b);
 		hd->b = NULL;
 	}
+	if (hd->gb) {
+		mu_bn_free(hd->gb);
+		hd->gb = NULL;
+	}
 	return -1;
 	
 }
@@ -298,9 +392,15 @@ int mu_srp_srv_pubkey(mu_srp_handle_t *hd, const char *username, const char *pas
 	hd->v = mu_bn_new();
 	if (! hd->v)
 		goto error;
-	mu_bn_a_exp_b_mod_c(hd->v, hd->g, x, hd->n, hd->ctx);
+	calculate_g_exp(hd, hd->v, x);
 	hex_dbg_bn("Verifier", hd->v);
 
+	/* A freshly generated verifier invalidates any k * v set earlier */
+	if (hd->kv) {
+		mu_bn_free(hd->kv);
+		hd->kv = NULL;
+	}
+
 	if (__mu_srp_srv_pubkey(hd, bytes_B, len_B) < 0 )
 		goto error;
 
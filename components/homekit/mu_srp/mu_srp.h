@@ -39,6 +39,10 @@ typedef struct mu_srp_handle {
 	int      len_B;
 	/* b */
 	mu_bn_t *b;
+	/* g^b */
+	mu_bn_t *gb;
+	/* k * v, cached since it depends only on the verifier */
+	mu_bn_t *kv;
 	/* A */
 	mu_bn_t *A;
 	char    *bytes_A;
@@ -47,6 +51,15 @@ typedef struct mu_srp_handle {
 	char *session_key;
 } mu_srp_handle_t;
 
+/* Server ephemeral b and g^b.
+ * These do not depend on the password or verifier, and so, can be generated
+ * ahead of time, leaving only B = kv + g^b to be calculated during the handshake.
+ */
+typedef struct {
+	mu_bn_t *b;
+	mu_bn_t *gb;
+} mu_srp_ephemeral_t;
+
 int mu_srp_init(mu_srp_handle_t *hd, mu_ng_type_t ng);
 
 void mu_srp_free(mu_srp_handle_t *hd);
@@ -73,6 +86,39 @@ int mu_srp_set_salt_verifier(mu_srp_handle_t *hd, const char *salt, int salt_len
  */
 int mu_srp_srv_pubkey_from_salt_verifier(mu_srp_handle_t *hd, char **bytes_B, int *len_B);
 
+/* Generates a fresh server ephemeral.
+ * Only the group parameters of the handle are used, so any initialised handle works.
+ * The ephemeral must be released using mu_srp_free_ephemeral() if it is not
+ * handed over to mu_srp_set_ephemeral()
+ */
+int mu_srp_gen_ephemeral(mu_srp_handle_t *hd, mu_srp_ephemeral_t *eph);
+
+void mu_srp_free_ephemeral(mu_srp_ephemeral_t *eph);
+
+/* Prepares the fixed-base exponentiation table, if CONFIG_MU_SRP_FIXED_BASE_COMB
+ * is enabled and the table needs to be calculated at runtime.
+ * This is slow and should be called from a background task. Until it is done,
+ * the generic exponentiation is used.
+ */
+int mu_srp_prepare_fixed_base(mu_srp_handle_t *hd);
+
+/* Hands over a pre-generated ephemeral to the handle, to be used by the next
+ * mu_srp_srv_pubkey() or mu_srp_srv_pubkey_from_salt_verifier().
+ * On success, the handle owns b and g^b and eph is cleared.
+ * An ephemeral MUST NOT be used for more than one handshake.
+ */
+int mu_srp_set_ephemeral(mu_srp_handle_t *hd, mu_srp_ephemeral_t *eph);
+
+/* Returns k * v for the verifier set using mu_srp_set_salt_verifier()
+ * so that it can be cached and restored into a later handle using mu_srp_set_kv()
+ *
+ * *bytes_kv MUST BE FREED BY THE CALLER
+ */
+int mu_srp_get_kv(mu_srp_handle_t *hd, char **bytes_kv, int *len_kv);
+
+/* Sets k * v, as returned earlier by mu_srp_get_kv() for the same verifier */
+int mu_srp_set_kv(mu_srp_handle_t *hd, const char *bytes_kv, int len_kv);
+
 /* Returns bytes_key
  * *bytes_key MUST NOT BE FREED BY THE CALLER
  */
@@ -94,12 +94,12 @@ static int lightbulb_write(hap_write_data_t write_data[], int count,
         write = &write_data[i];
         /* Setting a default error value */
         *(write->status) = HAP_STATUS_VAL_INVALID;
-        if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_ON)) {
+        if (hap_char_is_type(write->hc, HAP_CHAR_TYPE_ID_ON)) {
             ESP_LOGI(TAG, "Received Write for Light %s", write->val.b ? "On" : "Off");
             /* Take action on hardware and report to AWS IoT */
             hap_aws_iot_report_on_char(write->val.b);
             *(write->status) = HAP_STATUS_SUCCESS;
-        } else if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_BRIGHTNESS)) {
+        } else if (hap_char_is_type(write->hc, HAP_CHAR_TYPE_ID_BRIGHTNESS)) {
             ESP_LOGI(TAG, "Received Write for Light Brightness %d", write->val.i);
             /* Take action on hardware and report to AWS IoT */
             hap_aws_iot_report_brightness_char(write->val.i);
@@ -31,6 +31,8 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_log.h>
+#include <esp_system.h>
+#include <esp_heap_caps.h>
 
 #include <hap_apple_servs.h>
 #include <hap_apple_chars.h>
@@ -130,7 +132,7 @@ static int fan_write(hap_write_data_t write_data[], int count,
     hap_write_data_t *write;
     for (i = 0; i < count; i++) {
         write = &write_data[i];
-        if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_ON)) {
+        if (hap_char_is_type(write->hc, HAP_CHAR_TYPE_ID_ON)) {
             fan_on(write->val.b);
             hap_char_update_val(write->hc, &(write->val));
             *(write->status) = HAP_STATUS_SUCCESS;
@@ -141,6 +143,20 @@ static int fan_write(hap_write_data_t write_data[], int count,
     return ret;
 }
 
+/* Prints heap usage, to compare the effect of the attribute database arena */
+static void bridge_print_heap(const char *when)
+{
+#ifdef CONFIG_IDF_TARGET_ESP8266
+    ESP_LOGI(TAG, "Heap %s: free %d", when, esp_get_free_heap_size());
+#else
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    ESP_LOGI(TAG, "Heap %s: free %d, largest free block %d, allocated blocks %d, free blocks %d",
+            when, (int)info.total_free_bytes, (int)info.largest_free_block,
+            (int)info.allocated_blocks, (int)info.free_blocks);
+#endif
+}
+
 /*The main thread for handling the Bridge Accessory */
 static void bridge_thread_entry(void *p)
 {
@@ -150,6 +166,12 @@ static void bridge_thread_entry(void *p)
     /* Initialize the HAP core */
     hap_init(HAP_TRANSPORT_WIFI);
 
+    bridge_print_heap("before creating accessories");
+    /* The accessories in this example are never removed, so pack them into
+     * an arena to save heap and avoid fragmentation.
+     */
+    hap_db_arena_begin();
+
     /* Initialise the mandatory parameters for Accessory which will be added as
      * the mandatory services internally
      */
@@ -215,6 +237,8 @@ static void bridge_thread_entry(void *p)
         /* Add the Accessory to the HomeKit Database */
         hap_add_bridged_accessory(accessory, hap_get_unique_aid(accessory_name));
     }
+    hap_db_arena_commit();
+    bridge_print_heap("after creating accessories");
 
     /* Register a common button for reset Wi-Fi network and reset to factory.
      */
@@ -97,7 +97,7 @@ static int sensor_identify(hap_acc_t *ha)
  */
 static int sensor_read(hap_char_t *hc, hap_status_t *status_code, void *serv_priv, void *read_priv)
 {
-    if (!strcmp(hap_char_get_type_uuid(hc), HAP_CHAR_UUID_CURRENT_TEMPERATURE)) {
+    if (hap_char_is_type(hc, HAP_CHAR_TYPE_ID_CURRENT_TEMPERATURE)) {
         ESP_LOGI(TAG, "Received Read for Current Temperature");
         const hap_val_t *cur_val = hap_char_get_val(hc);
         ESP_LOGI(TAG, "Current Value: %f", cur_val->f);
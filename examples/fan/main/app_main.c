@@ -131,6 +131,13 @@ static void fan_hap_event_handler(void* arg, esp_event_base_t event_base, int32_
             break;
         case HAP_EVENT_PAIRING_MODE_TIMED_OUT :
             ESP_LOGI(TAG, "Pairing Mode timed out. Please reboot the device.");
+            break;
+        }
+        case HAP_EVENT_STARTUP_COMPLETE : {
+            hap_startup_profile_t *profile = (hap_startup_profile_t *)data;
+            ESP_LOGI(TAG, "HomeKit discoverable %d ms after boot",
+                        (int)(profile->stage_end_us[HAP_STARTUP_STAGE_ANNOUNCE] / 1000));
+            break;
         }
         default:
             /* Silently ignore unknown events */
@@ -150,7 +157,7 @@ static int fan_read(hap_char_t *hc, hap_status_t *status_code, void *serv_priv,
     if (hap_req_get_ctrl_id(read_priv)) {
         ESP_LOGI(TAG, "Received read from %s", hap_req_get_ctrl_id(read_priv));
     }
-    if (!strcmp(hap_char_get_type_uuid(hc), HAP_CHAR_UUID_ROTATION_DIRECTION)) {
+    if (hap_char_is_type(hc, HAP_CHAR_TYPE_ID_ROTATION_DIRECTION)) {
        /* Read the current value, toggle it and set the new value.
         * A separate variable should be used for the new value, as the hap_char_get_val()
         * API returns a const pointer
@@ -183,12 +190,12 @@ static int fan_write(hap_write_data_t write_data[], int count,
     hap_write_data_t *write;
     for (i = 0; i < count; i++) {
         write = &write_data[i];
-        if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_ON)) {
+        if (hap_char_is_type(write->hc, HAP_CHAR_TYPE_ID_ON)) {
             ESP_LOGI(TAG, "Received Write. Fan %s", write->val.b ? "On" : "Off");
             /* TODO: Control Actual Hardware */
             hap_char_update_val(write->hc, &(write->val));
             *(write->status) = HAP_STATUS_SUCCESS;
-        } else if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_ROTATION_DIRECTION)) {
+        } else if (hap_char_is_type(write->hc, HAP_CHAR_TYPE_ID_ROTATION_DIRECTION)) {
             if (write->val.i > 1) {
                 *(write->status) = HAP_STATUS_VAL_INVALID;
                 ret = HAP_FAIL;
@@ -216,7 +216,7 @@ static int outlet_write(hap_write_data_t write_data[], int count,
     hap_write_data_t *write;
     for (i = 0; i < count; i++) {
         write = &write_data[i];
-        if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_ON)) {
+        if (hap_char_is_type(write->hc, HAP_CHAR_TYPE_ID_ON)) {
             ESP_LOGI(TAG, "Received Write. Outlet %s", write->val.b ? "On" : "Off");
             /* TODO: Control Actual Hardware */
             //gpio16_output_set(0);
@@ -109,28 +109,34 @@ static int lightbulb_write(hap_write_data_t write_data[], int count,
         write = &write_data[i];
         /* Setting a default error value */
         *(write->status) = HAP_STATUS_VAL_INVALID;
-        if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_ON)) {
-            ESP_LOGI(TAG, "Received Write for Light %s", write->val.b ? "On" : "Off");
-            if (lightbulb_set_on(write->val.b) == 0) {
-                *(write->status) = HAP_STATUS_SUCCESS;
-            }
-        } else if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_BRIGHTNESS)) {
-            ESP_LOGI(TAG, "Received Write for Light Brightness %d", write->val.i);
-            if (lightbulb_set_brightness(write->val.i) == 0) {
-                *(write->status) = HAP_STATUS_SUCCESS;
-            }
-        } else if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_HUE)) {
-            ESP_LOGI(TAG, "Received Write for Light Hue %f", write->val.f);
-            if (lightbulb_set_hue(write->val.f) == 0) {
-                *(write->status) = HAP_STATUS_SUCCESS;
-            }
-        } else if (!strcmp(hap_char_get_type_uuid(write->hc), HAP_CHAR_UUID_SATURATION)) {
-            ESP_LOGI(TAG, "Received Write for Light Saturation %f", write->val.f);
-            if (lightbulb_set_saturation(write->val.f) == 0) {
-                *(write->status) = HAP_STATUS_SUCCESS;
-            }
-        } else {
-            *(write->status) = HAP_STATUS_RES_ABSENT;
+        switch (hap_char_get_type_id(write->hc)) {
+            case HAP_CHAR_TYPE_ID_ON:
+                ESP_LOGI(TAG, "Received Write for Light %s", write->val.b ? "On" : "Off");
+                if (lightbulb_set_on(write->val.b) == 0) {
+                    *(write->status) = HAP_STATUS_SUCCESS;
+                }
+                break;
+            case HAP_CHAR_TYPE_ID_BRIGHTNESS:
+                ESP_LOGI(TAG, "Received Write for Light Brightness %d", write->val.i);
+                if (lightbulb_set_brightness(write->val.i) == 0) {
+                    *(write->status) = HAP_STATUS_SUCCESS;
+                }
+                break;
+            case HAP_CHAR_TYPE_ID_HUE:
+                ESP_LOGI(TAG, "Received Write for Light Hue %f", write->val.f);
+                if (lightbulb_set_hue(write->val.f) == 0) {
+                    *(write->status) = HAP_STATUS_SUCCESS;
+                }
+                break;
+            case HAP_CHAR_TYPE_ID_SATURATION:
+                ESP_LOGI(TAG, "Received Write for Light Saturation %f", write->val.f);
+                if (lightbulb_set_saturation(write->val.f) == 0) {
+                    *(write->status) = HAP_STATUS_SUCCESS;
+                }
+                break;
+            default:
+                *(write->status) = HAP_STATUS_RES_ABSENT;
+                break;
         }
         /* If the characteristic write was successful, update it in hap core
          */